@@ -0,0 +1,593 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NeuralNetworkBenchmark.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : micro-benchmarks of the layer, network, activation and file kernels
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+// Build from this directory with
+//   g++ -std=c++17 -O2 -pthread NeuralNetworkBenchmark.cpp ../NeuralNetworkLib/NeuralNetworkLib/*.cpp
+//       -ldl -o NeuralNetworkBenchmark
+//
+// Every benchmark is calibrated to run for at least --min-time-ms per repetition, then runs --warmup repetitions
+// that are thrown away and --repetitions that are kept. The median and the median absolute deviation (MAD) of the
+// kept repetitions are reported per iteration, and --json writes every repetition as well. Built with
+// -DNNL_TRACK_ALLOCATIONS the heap allocations of one warmed-up iteration are reported too.
+//
+// CodeGenerator::Infer times the code generated for the FeedForward network, compiled with --compiler into a
+// shared library (POSIX), for networks of at most --codegen-max-parameters parameters, as compiling the
+// parameters as literals gets slow for large networks.
+//
+// --baseline compares the run with an earlier --json file. The change of every benchmark is the ratio of the
+// current to the baseline median, with a confidence interval from bootstrap resampling of the repetitions of both
+// runs, and a benchmark regresses when the whole interval lies above 1 + --threshold. Any regression makes the
+// program exit with 2, so it can gate a build.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../NeuralNetworkLib/NeuralNetworkLib/AllocationTracker.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/Autotuner.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/CodeGenerator.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/NeuralNetwork.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/SimdKernels.h"
+
+namespace {
+    struct Options {
+        std::vector<int> widths{16, 64, 256, 1024};
+        std::vector<int> depths{1, 2, 4};
+        int warmup{3};
+        int repetitions{15};
+        double minTimeMs{5.0};
+        std::string filter{};
+        std::string jsonFile{};
+        std::string baselineFile{};
+        double threshold{0.05}; // relative slowdown tolerated before a benchmark counts as a regression
+        int resamples{2000}; // bootstrap resamples per benchmark
+        std::string compiler{"c++"};
+        int codeGeneratorMaxParameters{100000}; // larger networks skip CodeGenerator::Infer, 0 skips it always
+    };
+
+    struct Result {
+        std::string name{};
+        int width{}; // neurons per layer, 0 if the benchmark has no width
+        int depth{}; // hidden layers, 0 if the benchmark has no depth
+        int itemsPerIteration{1};
+        long iterations{}; // iterations per repetition
+        std::vector<double> samples{}; // nanoseconds per iteration of each kept repetition
+        double median{};
+        double mad{};
+        double min{};
+        double mean{};
+        AllocationCounts allocations{}; // of one iteration after warming up, with NNL_TRACK_ALLOCATIONS
+    };
+
+    volatile double sink{}; // benchmarks store a result here, so the work can't be optimized away
+
+    void PrintUsage() {
+        std::cerr << "Usage: NeuralNetworkBenchmark [--widths <w0,w1,...>] [--depths <d0,d1,...>] [--warmup <n>]"
+            " [--repetitions <n>] [--min-time-ms <x>] [--filter <text>] [--json <file, - for stdout>]"
+            " [--baseline <json file>] [--threshold <percent>] [--resamples <n>] [--compiler <command>]"
+            " [--codegen-max-parameters <n>]\n";
+    }
+
+    std::vector<int> ParseList(const std::string& text) {
+        std::vector<int> values{};
+        std::istringstream list(text);
+        for (std::string value{}; std::getline(list, value, ',');) {
+            if (std::atoi(value.c_str()) > 0) { values.push_back(std::atoi(value.c_str())); }
+        }
+        return values;
+    }
+
+    double Median(std::vector<double> values) {
+        const auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+        std::nth_element(values.begin(), middle, values.end());
+        if (values.size() % 2 != 0) { return *middle; }
+        return 0.5 * (*middle + *std::max_element(values.begin(), middle));
+    }
+
+    /**
+     * \brief time a number of iterations of a benchmark
+     * \return elapsed time in nanoseconds
+     */
+    double TimeIterations(const std::function<void()>& run, const long iterations) {
+        const auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < iterations; ++i) { run(); }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    class Runner {
+    private:
+        const Options& _options;
+        std::vector<Result> _results{};
+
+    public:
+        explicit Runner(const Options& options) : _options(options) {}
+
+        [[nodiscard]] const std::vector<Result>& GetResults() const { return _results; }
+
+        /**
+         * \brief calibrate, warm up and measure one benchmark, unless the filter excludes it
+         * \param name name of the benchmark
+         * \param width neurons per layer, or 0
+         * \param depth hidden layers, or 0
+         * \param itemsPerIteration items processed by one iteration, e.g. values activated
+         * \param run one iteration
+         */
+        void Run(const std::string& name, const int width, const int depth, const int itemsPerIteration,
+                 const std::function<void()>& run) {
+            if (!_options.filter.empty() && name.find(_options.filter) == std::string::npos) { return; }
+
+            Result result{};
+            result.name = name;
+            result.width = width;
+            result.depth = depth;
+            result.itemsPerIteration = itemsPerIteration;
+
+            // grow the iteration count until a repetition lasts long enough for the clock, which also warms up
+            const double minTime = _options.minTimeMs * 1e6;
+            long iterations = 1;
+            for (double time = TimeIterations(run, iterations); time < minTime && iterations < (1L << 30);
+                 time = TimeIterations(run, iterations)) {
+                const double scale = time > 0.0 ? 1.2 * minTime / time : 10.0;
+                iterations = std::max(iterations + 1, static_cast<long>(static_cast<double>(iterations) *
+                                          std::min(scale, 10.0)));
+            }
+            result.iterations = iterations;
+
+            for (int r = 0; r < _options.warmup; ++r) { TimeIterations(run, iterations); }
+            if constexpr (AllocationTracker::isEnabled) {
+                const AllocationScope scope{};
+                run();
+                result.allocations = scope.GetCounts();
+            }
+            for (int r = 0; r < _options.repetitions; ++r) {
+                result.samples.push_back(TimeIterations(run, iterations) / static_cast<double>(iterations));
+            }
+
+            result.median = Median(result.samples);
+            std::vector<double> deviations{};
+            for (const double sample : result.samples) { deviations.push_back(std::abs(sample - result.median)); }
+            result.mad = Median(deviations);
+            result.min = *std::min_element(result.samples.begin(), result.samples.end());
+            for (const double sample : result.samples) { result.mean += sample / result.samples.size(); }
+
+            std::ostream& table = _options.jsonFile == "-" ? std::cerr : std::cout;
+            table << std::left << std::setw(52) << name << std::right << std::setw(6) << width << std::setw(4)
+                << depth << std::fixed << std::setprecision(1) << std::setw(16) << result.median << " ns +- "
+                << std::setw(12) << result.mad << " ns";
+            if constexpr (AllocationTracker::isEnabled) {
+                table << std::setw(8) << result.allocations.eigenAllocations << std::setw(8)
+                    << result.allocations.newAllocations;
+            }
+            table << '\n';
+            _results.push_back(std::move(result));
+        }
+    };
+
+    std::string EscapeJson(const std::string& text) {
+        std::string escaped{};
+        for (const char c : text) {
+            if (c == '"' || c == '\\') { escaped += '\\'; }
+            if (static_cast<unsigned char>(c) >= 0x20) { escaped += c; }
+        }
+        return escaped;
+    }
+
+    void WriteJson(std::ostream& stream, const Options& options, const std::vector<Result>& results) {
+        const std::time_t now = std::time(nullptr);
+        char date[32]{};
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        stream << std::setprecision(17);
+        stream << "{\n  \"context\": {\n";
+        stream << "    \"date\": \"" << date << "\",\n";
+        stream << "    \"cpu\": \"" << EscapeJson(Autotuner::GetCpuModel()) << "\",\n";
+        stream << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        stream << "    \"simd\": \"" << SimdKernels::GetLevelName(SimdKernels::GetLevel()) << "\",\n";
+        stream << "    \"warmup\": " << options.warmup << ",\n";
+        stream << "    \"repetitions\": " << options.repetitions << ",\n";
+        stream << "    \"min_time_ms\": " << options.minTimeMs << "\n  },\n";
+        stream << "  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            stream << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << EscapeJson(result.name) << "\", \"width\": "
+                << result.width << ", \"depth\": " << result.depth << ", \"items_per_iteration\": "
+                << result.itemsPerIteration << ", \"iterations\": " << result.iterations << ", \"median_ns\": "
+                << result.median << ", \"mad_ns\": " << result.mad << ", \"min_ns\": " << result.min
+                << ", \"mean_ns\": " << result.mean;
+            if constexpr (AllocationTracker::isEnabled) {
+                stream << ", \"eigen_allocations\": " << result.allocations.eigenAllocations
+                    << ", \"new_allocations\": " << result.allocations.newAllocations << ", \"new_bytes\": "
+                    << result.allocations.newBytes;
+            }
+            stream << ", \"samples_ns\": [";
+            for (std::size_t s = 0; s < result.samples.size(); ++s) {
+                stream << (s == 0 ? "" : ", ") << result.samples[s];
+            }
+            stream << "]}";
+        }
+        stream << "\n  ]\n}\n";
+    }
+
+    /**
+     * \brief Reads the JSON written by WriteJson, skipping anything it doesn't need
+     */
+    class JsonReader {
+    private:
+        const std::string& _text;
+        std::size_t _position{};
+
+        void SkipSpace() {
+            while (_position < _text.size() && std::isspace(static_cast<unsigned char>(_text[_position]))) {
+                ++_position;
+            }
+        }
+
+    public:
+        explicit JsonReader(const std::string& text) : _text(text) {}
+
+        /**
+         * \brief consume a character if it comes next
+         * \return true if it was consumed
+         */
+        bool Consume(const char c) {
+            SkipSpace();
+            if (_position < _text.size() && _text[_position] == c) {
+                ++_position;
+                return true;
+            }
+            return false;
+        }
+
+        void Expect(const char c) {
+            if (!Consume(c)) {
+                throw std::runtime_error(std::string("expected '") + c + "' at offset " + std::to_string(_position));
+            }
+        }
+
+        std::string ReadString() {
+            Expect('"');
+            std::string value{};
+            while (_position < _text.size() && _text[_position] != '"') {
+                if (_text[_position] == '\\' && _position + 1 < _text.size()) { ++_position; }
+                value += _text[_position++];
+            }
+            Expect('"');
+            return value;
+        }
+
+        double ReadNumber() {
+            SkipSpace();
+            const char* start = _text.c_str() + _position;
+            char* end{};
+            const double value = std::strtod(start, &end);
+            if (end == start) { throw std::runtime_error("expected a number at offset " + std::to_string(_position)); }
+            _position += static_cast<std::size_t>(end - start);
+            return value;
+        }
+
+        void SkipValue() {
+            SkipSpace();
+            if (_position >= _text.size()) { throw std::runtime_error("unexpected end of file"); }
+            const char c = _text[_position];
+            if (c == '"') { ReadString(); }
+            else if (c == '{' || c == '[') {
+                const char close = c == '{' ? '}' : ']';
+                ++_position;
+                if (Consume(close)) { return; }
+                do {
+                    if (c == '{') {
+                        ReadString();
+                        Expect(':');
+                    }
+                    SkipValue();
+                }
+                while (Consume(','));
+                Expect(close);
+            }
+            else if (std::isalpha(static_cast<unsigned char>(c))) {
+                while (_position < _text.size() && std::isalpha(static_cast<unsigned char>(_text[_position]))) {
+                    ++_position;
+                }
+            }
+            else { ReadNumber(); }
+        }
+    };
+
+    /**
+     * \brief read the benchmarks of a file written with --json
+     * \return name, width, depth, median and samples of each benchmark
+     */
+    std::vector<Result> ReadBaseline(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) { throw std::runtime_error("could not open the file"); }
+        const std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+        std::vector<Result> results{};
+        JsonReader reader(text);
+        reader.Expect('{');
+        do {
+            if (reader.ReadString() != "benchmarks") {
+                reader.Expect(':');
+                reader.SkipValue();
+                continue;
+            }
+            reader.Expect(':');
+            reader.Expect('[');
+            if (reader.Consume(']')) { continue; }
+            do {
+                Result result{};
+                reader.Expect('{');
+                do {
+                    const std::string key = reader.ReadString();
+                    reader.Expect(':');
+                    if (key == "name") { result.name = reader.ReadString(); }
+                    else if (key == "width") { result.width = static_cast<int>(reader.ReadNumber()); }
+                    else if (key == "depth") { result.depth = static_cast<int>(reader.ReadNumber()); }
+                    else if (key == "median_ns") { result.median = reader.ReadNumber(); }
+                    else if (key == "samples_ns") {
+                        reader.Expect('[');
+                        if (!reader.Consume(']')) {
+                            do { result.samples.push_back(reader.ReadNumber()); }
+                            while (reader.Consume(','));
+                            reader.Expect(']');
+                        }
+                    }
+                    else { reader.SkipValue(); }
+                }
+                while (reader.Consume(','));
+                reader.Expect('}');
+                if (result.samples.empty()) { result.samples.push_back(result.median); }
+                results.push_back(std::move(result));
+            }
+            while (reader.Consume(','));
+            reader.Expect(']');
+        }
+        while (reader.Consume(','));
+        reader.Expect('}');
+        return results;
+    }
+
+    /**
+     * \brief bootstrap the ratio of the median of current to the median of baseline
+     * \return the 2.5% and 97.5% quantiles of the resampled ratios
+     */
+    std::pair<double, double> BootstrapMedianRatio(const std::vector<double>& baseline,
+                                                   const std::vector<double>& current, const int resamples,
+                                                   std::mt19937_64& generator) {
+        std::vector<double> ratios(resamples);
+        std::vector<double> resampled{};
+        const auto resampledMedian = [&](const std::vector<double>& samples) {
+            std::uniform_int_distribution<std::size_t> pick(0, samples.size() - 1);
+            resampled.resize(samples.size());
+            for (double& value : resampled) { value = samples[pick(generator)]; }
+            return Median(resampled);
+        };
+        for (double& ratio : ratios) {
+            const double baselineMedian = resampledMedian(baseline);
+            ratio = resampledMedian(current) / baselineMedian;
+        }
+        std::sort(ratios.begin(), ratios.end());
+        const auto quantile = [&ratios](const double q) {
+            const auto index = static_cast<std::size_t>(q * static_cast<double>(ratios.size()));
+            return ratios[std::min(ratios.size() - 1, index)];
+        };
+        return {quantile(0.025), quantile(0.975)};
+    }
+
+    /**
+     * \brief print how every benchmark changed relative to the baseline
+     * \return false if any benchmark regressed beyond the threshold
+     */
+    bool CompareWithBaseline(std::ostream& table, const Options& options, const std::vector<Result>& baseline,
+                             const std::vector<Result>& results) {
+        std::mt19937_64 generator{42}; // the same runs always give the same intervals
+        int numRegressions{};
+
+        table << "\ncompared with " << options.baselineFile << ", threshold " << 100.0 * options.threshold << "%\n";
+        table << std::left << std::setw(52) << "benchmark" << std::right << std::setw(6) << "width" << std::setw(4)
+            << "dep" << std::setw(16) << "baseline ns" << std::setw(16) << "current ns" << std::setw(10) << "change"
+            << std::setw(22) << "95% interval" << "  status\n";
+        for (const Result& result : results) {
+            const auto match = std::find_if(baseline.begin(), baseline.end(), [&result](const Result& old) {
+                return old.name == result.name && old.width == result.width && old.depth == result.depth;
+            });
+            table << std::left << std::setw(52) << result.name << std::right << std::setw(6) << result.width
+                << std::setw(4) << result.depth << std::fixed << std::setprecision(1);
+            if (match == baseline.end() || match->median <= 0.0) {
+                table << std::setw(16) << "-" << std::setw(16) << result.median << "  new\n";
+                continue;
+            }
+
+            const auto [low, high] = BootstrapMedianRatio(match->samples, result.samples, options.resamples,
+                                                          generator);
+            const char* status = "ok";
+            if (low > 1.0 + options.threshold) {
+                status = "REGRESSION";
+                ++numRegressions;
+            }
+            else if (high < 1.0 - options.threshold) { status = "faster"; }
+
+            std::ostringstream interval{};
+            interval << std::fixed << std::setprecision(1) << '[' << std::showpos << 100.0 * (low - 1.0) << "%, "
+                << 100.0 * (high - 1.0) << "%]";
+            std::ostringstream change{};
+            change << std::fixed << std::setprecision(1) << std::showpos
+                << 100.0 * (result.median / match->median - 1.0) << '%';
+            table << std::setw(16) << match->median << std::setw(16) << result.median << std::setw(10)
+                << change.str() << std::setw(22) << interval.str() << "  " << status << '\n';
+        }
+        table << numRegressions << " regression" << (numRegressions == 1 ? "" : "s") << '\n';
+        return numRegressions == 0;
+    }
+
+    void RunActivationBenchmarks(Runner& runner) {
+        constexpr int numValues = 4096;
+        std::mt19937_64 generator{42};
+        std::uniform_real_distribution<double> distribution{-4.0, 4.0};
+        std::vector<double> values(numValues);
+        for (double& value : values) { value = distribution(generator); }
+
+        const std::vector<std::pair<std::string, double (*)(double)>> functions{
+            {"ActivationLib::HeavisideStepFunction", ActivationLib::HeavisideStepFunction},
+            {"ActivationLib::SigmoidFunction", ActivationLib::SigmoidFunction},
+            {"ActivationLib::HyperbolicTangentFunction", ActivationLib::HyperbolicTangentFunction},
+            {"ActivationLib::ReLUFunction", ActivationLib::ReLUFunction},
+            {"ActivationLib::HeavisideStepFunctionDerivative", [](double) {
+                return ActivationLib::HeavisideStepFunctionDerivative();
+            }},
+            {"ActivationLib::SigmoidFunctionDerivative", ActivationLib::SigmoidFunctionDerivative},
+            {"ActivationLib::HyperbolicTangentFunctionDerivative",
+             ActivationLib::HyperbolicTangentFunctionDerivative},
+            {"ActivationLib::ReLUFunctionDerivative", ActivationLib::ReLUFunctionDerivative},
+        };
+        for (const auto& [name, function] : functions) {
+            runner.Run(name, 0, 0, numValues, [&values, function = function] {
+                double sum{};
+                for (const double value : values) { sum += function(value); }
+                sink = sum;
+            });
+        }
+    }
+
+    void RunNetworkBenchmarks(Runner& runner, const Options& options) {
+        std::mt19937_64 generator{42};
+        std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+        const std::string modelFile = (std::filesystem::temp_directory_path() / "NeuralNetworkBenchmark.txt").string();
+
+        for (const int width : options.widths) {
+            const Eigen::VectorXd inputs = Eigen::VectorXd::NullaryExpr(width, [&] { return distribution(generator); });
+            const Eigen::VectorXd targets = (0.5 + 0.4 * inputs.array()).matrix();
+
+            NeuronLayer layer(width, width);
+            runner.Run("NeuronLayer::CalcOutputs", width, 0, 1, [&] {
+                sink = layer.CalcOutputs(inputs, EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION)[0];
+            });
+
+            for (const int depth : options.depths) {
+                NeuralNetwork network(width, width, depth, width, 0.01);
+                network.SetHiddenActivationFunction(EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION);
+                network.SetOutputActivationFunction(EActivationFunction::SIGMOID_FUNCTION);
+
+                runner.Run("NeuralNetwork::FeedForward", width, depth, 1, [&] {
+                    sink = network.FeedForward(inputs)[0];
+                });
+                const std::string generatedName = "CodeGenerator::Infer";
+                if (network.GetNumParameters() <= options.codeGeneratorMaxParameters &&
+                    (options.filter.empty() || generatedName.find(options.filter) != std::string::npos)) {
+                    CompiledNetwork compiled{};
+                    if (compiled.Compile(network, options.compiler)) {
+                        std::vector<double> outputs(compiled.GetNumOutputs());
+                        runner.Run(generatedName, width, depth, 1, [&] {
+                            compiled.Infer(inputs.data(), outputs.data());
+                            sink = outputs[0];
+                        });
+                    }
+                }
+                runner.Run("NeuralNetwork::BackPropagate", width, depth, 1, [&] {
+                    sink = network.BackPropagate(inputs, targets);
+                });
+                network.CalcGradients(inputs, targets);
+                runner.Run("NeuralNetwork::UpdateWeightsAndBiases", width, depth, 1, [&] {
+                    network.UpdateWeightsAndBiases();
+                });
+
+                runner.Run("NeuralNetwork::SaveToFile", width, depth, 1, [&] {
+                    sink = network.SaveToFile(modelFile);
+                });
+                if (network.SaveToFile(modelFile)) {
+                    NeuralNetwork loaded{};
+                    runner.Run("NeuralNetwork::LoadFromFile", width, depth, 1, [&] {
+                        sink = loaded.LoadFromFile(modelFile);
+                    });
+                }
+            }
+        }
+        std::remove(modelFile.c_str());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--widths" && i + 1 < argc) { options.widths = ParseList(argv[++i]); }
+        else if (option == "--depths" && i + 1 < argc) { options.depths = ParseList(argv[++i]); }
+        else if (option == "--warmup" && i + 1 < argc) { options.warmup = std::max(0, std::atoi(argv[++i])); }
+        else if (option == "--repetitions" && i + 1 < argc) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (option == "--min-time-ms" && i + 1 < argc) { options.minTimeMs = std::atof(argv[++i]); }
+        else if (option == "--filter" && i + 1 < argc) { options.filter = argv[++i]; }
+        else if (option == "--json" && i + 1 < argc) { options.jsonFile = argv[++i]; }
+        else if (option == "--baseline" && i + 1 < argc) { options.baselineFile = argv[++i]; }
+        else if (option == "--threshold" && i + 1 < argc) { options.threshold = std::atof(argv[++i]) / 100.0; }
+        else if (option == "--resamples" && i + 1 < argc) { options.resamples = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--compiler" && i + 1 < argc) { options.compiler = argv[++i]; }
+        else if (option == "--codegen-max-parameters" && i + 1 < argc) {
+            options.codeGeneratorMaxParameters = std::max(0, std::atoi(argv[++i]));
+        }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::vector<Result> baseline{};
+    if (!options.baselineFile.empty()) {
+        try { baseline = ReadBaseline(options.baselineFile); }
+        catch (const std::exception& exception) {
+            std::cerr << "Could not read baseline " << options.baselineFile << ": " << exception.what() << '\n';
+            return 1;
+        }
+    }
+
+    std::ostream& table = options.jsonFile == "-" ? std::cerr : std::cout;
+    table << SimdKernels::GetReport() << ", cpu: " << Autotuner::GetCpuModel() << '\n';
+    table << std::left << std::setw(52) << "benchmark" << std::right << std::setw(6) << "width" << std::setw(4)
+        << "dep" << std::setw(19) << "median" << std::setw(19) << "MAD";
+    if constexpr (AllocationTracker::isEnabled) { table << std::setw(8) << "eigen" << std::setw(8) << "new"; }
+    table << '\n';
+
+    Runner runner(options);
+    RunActivationBenchmarks(runner);
+    RunNetworkBenchmarks(runner, options);
+
+    if (options.jsonFile == "-") { WriteJson(std::cout, options, runner.GetResults()); }
+    else if (!options.jsonFile.empty()) {
+        std::ofstream file(options.jsonFile);
+        WriteJson(file, options, runner.GetResults());
+        if (!file) {
+            std::cerr << "Could not write " << options.jsonFile << '\n';
+            return 1;
+        }
+    }
+    if (!options.baselineFile.empty() && !CompareWithBaseline(table, options, baseline, runner.GetResults())) {
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,318 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NeuralNetworkThroughput.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : end-to-end training throughput over a grid of datasets, shapes and execution modes
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+// Linux only, build from this directory with
+//   g++ -std=c++17 -O2 -pthread NeuralNetworkThroughput.cpp ../NeuralNetworkLib/NeuralNetworkLib/*.cpp
+//       -o NeuralNetworkThroughput
+// or, so the incremental mode trains through the IncrementalTrainer::Run coroutine instead of Step, with
+//   g++ -std=c++20 -O2 -pthread NeuralNetworkThroughput.cpp ../NeuralNetworkLib/NeuralNetworkLib/*.cpp
+//       -o NeuralNetworkThroughput
+//
+// Every combination of the list options is one configuration, trained from the same seed for the same number of
+// sample passes (--work, rounded up to whole epochs) and written as one CSV row. Execution modes:
+//   sgd        NeuralNetwork::TrainEpoch, one sample at a time on the calling thread
+//   team       like sgd, with every layer split over a thread team of --threads members
+//   autotuned  like sgd, with the plan the Autotuner picks for the network
+//   pipeline   PipelineNetwork::TrainEpoch with --threads stages and mini-batches of --batches samples
+//   incremental IncrementalTrainer in frames of 1 ms, the way an application spreads training over its frames
+// Modes that don't use the batch size or the thread count run once, with 1 in those columns.
+//
+// GFLOP/s counts 6 operations per weight and sample (forward product, delta propagation and gradient), the usual
+// estimate for training dense layers. Peak RSS is reset before each configuration through /proc/self/clear_refs.
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../NeuralNetworkLib/NeuralNetworkLib/Autotuner.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/IncrementalTrainer.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/NeuralNetwork.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/PipelineNetwork.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/ThreadTeam.h"
+
+namespace {
+    struct Options {
+        std::vector<std::string> tasks{"regression", "classification"};
+        std::vector<std::string> modes{"sgd", "team", "pipeline"};
+        std::vector<int> sampleCounts{4096};
+        std::vector<int> widths{32, 128};
+        std::vector<int> depths{2};
+        std::vector<int> batchSizes{32};
+        std::vector<int> threadCounts{1, 2, 4};
+        int numInputs{16};
+        int numOutputs{4};
+        long work{200000}; // sample passes per configuration
+        double learningRate{0.05};
+        double targetLoss{0.005};
+        double maxSeconds{60.0};
+        std::string csvFile{};
+    };
+
+    struct Dataset {
+        Eigen::MatrixXd inputs{};
+        Eigen::MatrixXd targets{};
+    };
+
+    void PrintUsage() {
+        std::cerr << "Usage: NeuralNetworkThroughput [--tasks regression,classification] [--modes sgd,team,autotuned,"
+            "pipeline,incremental] [--samples <n0,n1,...>] [--widths <w0,...>] [--depths <d0,...>] [--batches <b0,...>]"
+            " [--threads <t0,...>] [--inputs <n>] [--outputs <n>] [--work <sample passes>] [--learning-rate <x>]"
+            " [--target-loss <x>] [--max-seconds <x>] [--csv <file>]\n";
+    }
+
+    std::vector<std::string> ParseNames(const std::string& text) {
+        std::vector<std::string> names{};
+        std::istringstream list(text);
+        for (std::string name{}; std::getline(list, name, ',');) {
+            if (!name.empty()) { names.push_back(name); }
+        }
+        return names;
+    }
+
+    std::vector<int> ParseList(const std::string& text) {
+        std::vector<int> values{};
+        for (const std::string& name : ParseNames(text)) {
+            if (std::atoi(name.c_str()) > 0) { values.push_back(std::atoi(name.c_str())); }
+        }
+        return values;
+    }
+
+    /**
+     * \brief synthetic data with targets in (0, 1) for sigmoid outputs
+     * \param task "regression" for smooth nonlinear functions of the inputs, "classification" for one-hot labels
+     *  of the nearest of numOutputs gaussian cluster centres
+     */
+    Dataset MakeDataset(const std::string& task, const int numSamples, const int numInputs, const int numOutputs) {
+        std::mt19937_64 generator{42};
+        std::uniform_real_distribution<double> uniform{-1.0, 1.0};
+        std::normal_distribution<double> normal{0.0, 0.3};
+        const auto random = [&] { return uniform(generator); };
+
+        Dataset dataset{};
+        dataset.targets.resize(numOutputs, numSamples);
+        if (task == "classification") {
+            const Eigen::MatrixXd centres = Eigen::MatrixXd::NullaryExpr(numInputs, numOutputs, random);
+            dataset.inputs.resize(numInputs, numSamples);
+            for (int j = 0; j < numSamples; ++j) {
+                const int label = static_cast<int>(generator() % static_cast<unsigned>(numOutputs));
+                dataset.inputs.col(j) = centres.col(label) + Eigen::VectorXd::NullaryExpr(
+                    numInputs, [&] { return normal(generator); });
+                dataset.targets.col(j).setConstant(0.1);
+                dataset.targets(label, j) = 0.9;
+            }
+        }
+        else {
+            const Eigen::MatrixXd projections = Eigen::MatrixXd::NullaryExpr(numOutputs, numInputs, random);
+            dataset.inputs = Eigen::MatrixXd::NullaryExpr(numInputs, numSamples, random);
+            dataset.targets = (0.5 + 0.4 * (projections * dataset.inputs / std::sqrt(numInputs)).array().sin() *
+                dataset.inputs.row(0).array().cos().replicate(numOutputs, 1)).matrix();
+        }
+        return dataset;
+    }
+
+    constexpr std::chrono::milliseconds frameBudget{1}; // training time per frame of the incremental mode
+
+    /**
+     * \brief reset the peak resident set size of the process, if the kernel allows it
+     */
+    void ResetPeakRss() { std::ofstream("/proc/self/clear_refs") << "5"; }
+
+    /**
+     * \brief get the peak resident set size since the last reset
+     * \return kibibytes
+     */
+    long GetPeakRssKib() {
+        std::ifstream status("/proc/self/status");
+        for (std::string line{}; std::getline(status, line);) {
+            if (line.rfind("VmHWM:", 0) == 0) { return std::atol(line.c_str() + 6); }
+        }
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    /**
+     * \brief train one configuration and write its CSV row
+     */
+    void RunConfiguration(std::ostream& csv, const Options& options, const std::string& task,
+                          const std::string& mode, const Dataset& dataset, const int width, const int depth,
+                          const int batchSize, const int numThreads) {
+        using Clock = std::chrono::steady_clock;
+        const auto numSamples = static_cast<int>(dataset.inputs.cols());
+        const long numEpochs = std::max(1L, (options.work + numSamples - 1) / numSamples);
+
+        ResetPeakRss();
+        NeuralNetwork network(options.numInputs, options.numOutputs, depth, width, options.learningRate);
+        network.SetHiddenActivationFunction(EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION);
+        network.SetOutputActivationFunction(EActivationFunction::SIGMOID_FUNCTION);
+
+        // the parameters start from the same seed in every mode
+        std::mt19937_64 generator{7};
+        std::uniform_real_distribution<double> distribution{-1.0 / std::sqrt(width), 1.0 / std::sqrt(width)};
+        for (double& parameter : network.GetParameters()) { parameter = distribution(generator); }
+
+        std::unique_ptr<ThreadTeam> team{};
+        std::unique_ptr<Autotuner> autotuner{};
+        std::unique_ptr<PipelineNetwork> pipeline{};
+        std::unique_ptr<IncrementalTrainer> incremental{};
+#if defined(__cpp_impl_coroutine)
+        std::optional<TrainingTask> frames{};
+#endif
+        if (mode == "team") {
+            team = std::make_unique<ThreadTeam>(static_cast<unsigned>(numThreads));
+            network.SetThreadTeam(team.get(), 0);
+        }
+        else if (mode == "autotuned") {
+            autotuner = std::make_unique<Autotuner>("");
+            autotuner->Apply(network);
+        }
+        else if (mode == "pipeline") {
+            pipeline = std::make_unique<PipelineNetwork>(network, numThreads,
+                                                         std::max(1, batchSize / std::max(1, numThreads)));
+        }
+        else if (mode == "incremental") {
+            // a negative error never converges, so every mode trains the same number of epochs
+            incremental = std::make_unique<IncrementalTrainer>(network, dataset.inputs, dataset.targets, -1.0,
+                                                               static_cast<int>(numEpochs));
+#if defined(__cpp_impl_coroutine)
+            frames.emplace(incremental->Run(frameBudget));
+#endif
+        }
+
+        double seconds{};
+        double loss{};
+        std::optional<double> timeToTarget{};
+        long epoch = 0;
+        while (epoch < numEpochs && seconds < options.maxSeconds) {
+            const auto start = Clock::now();
+            double errorSum{};
+            if (incremental) {
+                // frames until the epoch is done, the last one may start the next epoch
+                while (incremental->GetEpoch() == epoch) {
+#if defined(__cpp_impl_coroutine)
+                    frames->Resume();
+#else
+                    incremental->Step(frameBudget);
+#endif
+                }
+                errorSum = incremental->GetLastEpochError();
+            }
+            else if (pipeline) { errorSum = pipeline->TrainEpoch(dataset.inputs, dataset.targets, batchSize); }
+            else { errorSum = network.TrainEpoch(dataset.inputs, dataset.targets); }
+            seconds += std::chrono::duration<double>(Clock::now() - start).count();
+            ++epoch;
+
+            loss = errorSum / numSamples;
+            if (!timeToTarget && loss <= options.targetLoss) { timeToTarget = seconds; }
+        }
+
+        double numWeights{};
+        for (const NeuronLayer& layer : network.GetLayers()) {
+            numWeights += static_cast<double>(layer.numNeurons) * layer.numNeuronInputs;
+        }
+        const double samplesPerSecond = static_cast<double>(epoch) * numSamples / seconds;
+
+        csv << task << ',' << mode << ',' << numSamples << ',' << options.numInputs << ',' << options.numOutputs
+            << ',' << width << ',' << depth << ',' << batchSize << ',' << numThreads << ',' << epoch << ','
+            << seconds << ',' << samplesPerSecond << ',' << samplesPerSecond * 6.0 * numWeights * 1e-9 << ','
+            << loss << ',';
+        if (timeToTarget) { csv << *timeToTarget; }
+        csv << ',' << GetPeakRssKib() << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--tasks" && i + 1 < argc) { options.tasks = ParseNames(argv[++i]); }
+        else if (option == "--modes" && i + 1 < argc) { options.modes = ParseNames(argv[++i]); }
+        else if (option == "--samples" && i + 1 < argc) { options.sampleCounts = ParseList(argv[++i]); }
+        else if (option == "--widths" && i + 1 < argc) { options.widths = ParseList(argv[++i]); }
+        else if (option == "--depths" && i + 1 < argc) { options.depths = ParseList(argv[++i]); }
+        else if (option == "--batches" && i + 1 < argc) { options.batchSizes = ParseList(argv[++i]); }
+        else if (option == "--threads" && i + 1 < argc) { options.threadCounts = ParseList(argv[++i]); }
+        else if (option == "--inputs" && i + 1 < argc) { options.numInputs = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--outputs" && i + 1 < argc) { options.numOutputs = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--work" && i + 1 < argc) { options.work = std::max(1L, std::atol(argv[++i])); }
+        else if (option == "--learning-rate" && i + 1 < argc) { options.learningRate = std::atof(argv[++i]); }
+        else if (option == "--target-loss" && i + 1 < argc) { options.targetLoss = std::atof(argv[++i]); }
+        else if (option == "--max-seconds" && i + 1 < argc) { options.maxSeconds = std::atof(argv[++i]); }
+        else if (option == "--csv" && i + 1 < argc) { options.csvFile = argv[++i]; }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    for (const std::string& mode : options.modes) {
+        if (mode != "sgd" && mode != "team" && mode != "autotuned" && mode != "pipeline" && mode != "incremental") {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::ofstream file{};
+    if (!options.csvFile.empty()) {
+        file.open(options.csvFile);
+        if (!file.is_open()) {
+            std::cerr << "Could not open " << options.csvFile << '\n';
+            return 1;
+        }
+    }
+    std::ostream& csv = options.csvFile.empty() ? std::cout : file;
+    csv << "task,mode,samples,inputs,outputs,width,depth,batch,threads,epochs,seconds,samples_per_sec,gflops,"
+        "final_loss,time_to_target_s,peak_rss_kib" << std::endl;
+
+    try {
+        for (const std::string& task : options.tasks) {
+            for (const int numSamples : options.sampleCounts) {
+                const Dataset dataset = MakeDataset(task, numSamples, options.numInputs, options.numOutputs);
+                for (const int width : options.widths) {
+                    for (const int depth : options.depths) {
+                        // modes ignoring the batch size or the thread count would repeat identical runs
+                        std::set<std::tuple<std::string, int, int>> done{};
+                        for (const std::string& mode : options.modes) {
+                            for (const int batch : options.batchSizes) {
+                                for (const int threads : options.threadCounts) {
+                                    const int batchSize = mode == "pipeline" ? batch : 1;
+                                    const int numThreads = mode == "team" ? threads
+                                                               : mode == "pipeline" ? std::min(threads, depth + 1)
+                                                               : 1;
+                                    if (!done.emplace(mode, batchSize, numThreads).second) { continue; }
+                                    RunConfiguration(csv, options, task, mode, dataset, width, depth, batchSize,
+                                                     numThreads);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    catch (const std::exception& exception) {
+        std::cerr << exception.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: DataParallelTrainer.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "DataParallelTrainer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+DataParallelTrainer::DataParallelTrainer(NeuralNetwork& network, RingAllReduce& ring) :
+    _network(network), _ring(ring) {
+    Eigen::Index offset{};
+    for (const auto& layer : _network.GetLayers()) {
+        const Eigen::Index size = NeuronLayer::NumParameters(layer.numNeurons, layer.numNeuronInputs);
+        _layerSegments.push_back({offset, size});
+        offset += size;
+    }
+    _gradientSum = Eigen::VectorXd::Zero(offset);
+
+    // replicas are initialised randomly, rank 0's parameters win
+    _ring.Broadcast(_network.GetParameters().data(), static_cast<std::size_t>(offset));
+
+    _communicator = std::thread(&DataParallelTrainer::Communicate, this);
+}
+
+DataParallelTrainer::~DataParallelTrainer() {
+    {
+        std::lock_guard lock(_mutex);
+        _stopRequested = true;
+    }
+    _layerQueued.notify_one();
+    _communicator.join();
+}
+
+void DataParallelTrainer::Communicate() {
+    while (true) {
+        int layer{};
+        {
+            std::unique_lock lock(_mutex);
+            _layerQueued.wait(lock, [this] { return _stopRequested || !_pendingLayers.empty(); });
+            if (_pendingLayers.empty()) { return; }
+            layer = _pendingLayers.front();
+            _pendingLayers.pop_front();
+        }
+
+        // after an error the ring is out of step, so the remaining layers are only counted off
+        bool failed{};
+        {
+            std::lock_guard lock(_mutex);
+            failed = static_cast<bool>(_communicationError);
+        }
+        if (!failed) {
+            try {
+                const auto& segment = _layerSegments[layer];
+                _ring.AllReduce(_gradientSum.data() + segment.offset, static_cast<std::size_t>(segment.size));
+            }
+            catch (...) {
+                std::lock_guard lock(_mutex);
+                _communicationError = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard lock(_mutex);
+            --_numOutstanding;
+        }
+        _layersReduced.notify_one();
+    }
+}
+
+void DataParallelTrainer::QueueLayer(const int layer) {
+    {
+        std::lock_guard lock(_mutex);
+        _pendingLayers.push_back(layer);
+        ++_numOutstanding;
+    }
+    _layerQueued.notify_one();
+}
+
+void DataParallelTrainer::WaitForLayers() {
+    std::unique_lock lock(_mutex);
+    _layersReduced.wait(lock, [this] { return _numOutstanding == 0; });
+    if (_communicationError) { std::rethrow_exception(_communicationError); }
+}
+
+double DataParallelTrainer::TrainEpoch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                                       const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets,
+                                       const int batchSize) {
+    if (batchSize <= 0 || inputs.cols() != targets.cols()) {
+        throw std::invalid_argument("Batch size must be positive and every input needs a target");
+    }
+
+    const Eigen::Index numSamples = inputs.cols();
+    const int rank = _ring.GetRank();
+    const int numRanks = _ring.GetNumRanks();
+    const auto numLayers = static_cast<int>(_layerSegments.size());
+    double meanSquareError{};
+
+    for (Eigen::Index batchBegin = 0; batchBegin < numSamples; batchBegin += batchSize) {
+        const Eigen::Index batchEnd = std::min<Eigen::Index>(batchBegin + batchSize, numSamples);
+        _gradientSum.setZero();
+
+        // this rank's samples of the batch, the last one streams its layers to the communication thread
+        Eigen::Index last = batchBegin + rank;
+        while (last + numRanks < batchEnd) { last += numRanks; }
+        for (Eigen::Index j = batchBegin + rank; j < last; j += numRanks) {
+            meanSquareError += _network.CalcGradients(inputs.col(j), targets.col(j));
+            _gradientSum += _network.GetGradients();
+        }
+        if (last < batchEnd) {
+            meanSquareError += _network.CalcGradients(inputs.col(last), targets.col(last), [this](const int layer) {
+                const auto& segment = _layerSegments[layer];
+                _gradientSum.segment(segment.offset, segment.size) +=
+                    _network.GetGradients().segment(segment.offset, segment.size);
+                QueueLayer(layer);
+            });
+        }
+        else {
+            // no sample of this batch, the ring still needs this rank's (zero) share of every layer
+            for (int layer = numLayers - 1; layer >= 0; --layer) { QueueLayer(layer); }
+        }
+        WaitForLayers();
+
+        // every rank applies the same averaged gradients
+        _network.GetParameters() += _network.GetLearningRate() / static_cast<double>(batchEnd - batchBegin) *
+            _gradientSum;
+    }
+
+    double totalError[] = {meanSquareError};
+    _ring.AllReduce(totalError, 1);
+    return totalError[0];
+}
@@ -0,0 +1,97 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: DataParallelTrainer.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : data-parallel training of one network across processes
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef DATAPARALLELTRAINER_H
+#define DATAPARALLELTRAINER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../NeuralNetworkLib/NeuralNetworkLib/NeuralNetwork.h"
+#include "RingAllReduce.h"
+
+/**
+ * \brief Trains replicas of one network in several processes as if they were one, with mini-batch gradient descent.
+ *
+ * Every process holds the whole dataset and takes every numRanks-th sample of each mini-batch, starting at its
+ * rank. The gradients of its samples are summed locally, averaged over all ranks with a ring all-reduce and
+ * applied by every rank, so the replicas stay identical. For the last local sample of a batch, each layer's
+ * gradients are handed to a communication thread as soon as back propagation has produced them, so the
+ * all-reduce of layer i overlaps the back propagation of layer i - 1.
+ */
+class DataParallelTrainer {
+private:
+    struct LayerSegment {
+        Eigen::Index offset;
+        Eigen::Index size;
+    };
+
+    NeuralNetwork& _network;
+    RingAllReduce& _ring;
+    std::vector<LayerSegment> _layerSegments{};
+    Eigen::Vector<double, Eigen::Dynamic> _gradientSum{};
+
+    // layers waiting for the communication thread, and how many are still outstanding
+    std::deque<int> _pendingLayers{};
+    int _numOutstanding{};
+    bool _stopRequested{};
+    std::exception_ptr _communicationError{};
+    std::mutex _mutex{};
+    std::condition_variable _layerQueued{};
+    std::condition_variable _layersReduced{};
+    std::thread _communicator{};
+
+    /**
+     * \brief communication thread reducing the queued layers in order
+     */
+    void Communicate();
+
+    /**
+     * \brief queue a layer of the gradient sum for reduction
+     * \param layer index of the layer
+     */
+    void QueueLayer(int layer);
+
+    /**
+     * \brief wait until every queued layer has been reduced, rethrowing a communication error
+     */
+    void WaitForLayers();
+
+public:
+    /**
+     * \brief set up training and copy the parameters of rank 0 to every rank, so all replicas start equal
+     * \param network replica of this process
+     * \param ring connected ring of all processes
+     */
+    DataParallelTrainer(NeuralNetwork& network, RingAllReduce& ring);
+
+    /**
+     * \brief stop the communication thread
+     */
+    ~DataParallelTrainer();
+
+    DataParallelTrainer(const DataParallelTrainer&) = delete;
+    DataParallelTrainer& operator=(const DataParallelTrainer&) = delete;
+
+    /**
+     * \brief train for one epoch, every rank must call this with the same dataset and batch size
+     * \param inputs matrix with one input vector per column
+     * \param targets matrix with one target vector per column
+     * \param batchSize samples per mini-batch over all ranks
+     * \return sum of the mean square errors of all samples, over all ranks
+     */
+    double TrainEpoch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets, int batchSize);
+};
+#endif // DATAPARALLELTRAINER_H
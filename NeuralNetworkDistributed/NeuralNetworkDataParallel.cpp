@@ -0,0 +1,177 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NeuralNetworkDataParallel.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : data-parallel training of a network across local processes
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+// Linux only, build from this directory with
+//   g++ -std=c++17 -O2 -pthread NeuralNetworkDataParallel.cpp
+//     DataParallelTrainer.cpp RingAllReduce.cpp ../NeuralNetworkLib/NeuralNetworkLib/*.cpp -o NeuralNetworkDataParallel
+//
+// Either launch every rank from one command with --ranks, or start each rank yourself with --rank and the same
+// --ranks and --transport (or --endpoints) everywhere.
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DataParallelTrainer.h"
+#include "RingAllReduce.h"
+
+namespace {
+    struct Options {
+        int numRanks{2};
+        int rank{-1}; // -1 launches every rank
+        std::string transport{"unix"};
+        std::vector<std::string> endpoints{};
+        int epochs{50};
+        int batchSize{32};
+        int numSamples{4096};
+        int numHiddenLayers{2};
+        int numNeuronsPerHiddenLayer{64};
+        double learningRate{0.5};
+        std::string saveFile{};
+    };
+
+    void PrintUsage() {
+        std::cerr << "Usage: NeuralNetworkDataParallel [--ranks <n>] [--rank <r>] [--transport unix|tcp]"
+            " [--endpoints <e0,e1,...>] [--epochs <n>] [--batch <n>] [--samples <n>] [--layers <n>]"
+            " [--neurons <n>] [--learning-rate <x>] [--save <file>]\n";
+    }
+
+    std::vector<std::string> DefaultEndpoints(const Options& options) {
+        std::vector<std::string> endpoints{};
+        for (int r = 0; r < options.numRanks; ++r) {
+            if (options.transport == "tcp") {
+                endpoints.push_back("tcp:127.0.0.1:" + std::to_string(47000 + r));
+            }
+            else { endpoints.push_back("unix:/tmp/NeuralNetworkDataParallel." + std::to_string(r) + ".sock"); }
+        }
+        return endpoints;
+    }
+
+    /**
+     * \brief run one rank, every rank builds the same synthetic regression problem from a fixed seed
+     * \return exit code
+     */
+    int RunRank(const Options& options) {
+        using Clock = std::chrono::steady_clock;
+        constexpr int numInputs = 8;
+        constexpr int numOutputs = 2;
+
+        std::mt19937_64 generator{42};
+        std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+        Eigen::MatrixXd inputs = Eigen::MatrixXd::NullaryExpr(numInputs, options.numSamples,
+                                                              [&] { return distribution(generator); });
+        Eigen::MatrixXd targets(numOutputs, options.numSamples);
+        for (int j = 0; j < options.numSamples; ++j) {
+            targets(0, j) = 0.5 + 0.4 * std::sin(inputs(0, j) + inputs(1, j) * inputs(2, j));
+            targets(1, j) = 0.5 + 0.4 * std::tanh(inputs.col(j).sum());
+        }
+
+        try {
+            RingAllReduce ring(options.rank, options.endpoints);
+            NeuralNetwork network(numInputs, numOutputs, options.numHiddenLayers, options.numNeuronsPerHiddenLayer,
+                                  options.learningRate);
+            network.SetHiddenActivationFunction(EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION);
+            network.SetOutputActivationFunction(EActivationFunction::SIGMOID_FUNCTION);
+            DataParallelTrainer trainer(network, ring);
+
+            const auto start = Clock::now();
+            for (int epoch = 1; epoch <= options.epochs; ++epoch) {
+                const double error = trainer.TrainEpoch(inputs, targets, options.batchSize) / options.numSamples;
+                if (options.rank == 0 && (epoch == 1 || epoch % 10 == 0 || epoch == options.epochs)) {
+                    std::cout << "epoch " << epoch << ": mean square error " << error << '\n';
+                }
+            }
+            const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+            // replicas that stayed in step print the same checksum
+            std::ostringstream report{};
+            report.precision(17);
+            report << "rank " << options.rank << ": parameter checksum " << network.GetParameters().sum() << '\n';
+            if (options.rank == 0) {
+                report << "ranks: " << options.numRanks << ", " << static_cast<double>(options.epochs) *
+                    options.numSamples / elapsed << " samples/s over " << elapsed << " s\n";
+                if (!options.saveFile.empty()) { network.SaveToBinaryFile(options.saveFile); }
+            }
+            std::cout << report.str() << std::flush;
+        }
+        catch (const std::exception& exception) {
+            std::cerr << "rank " << options.rank << ": " << exception.what() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--ranks" && i + 1 < argc) { options.numRanks = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--rank" && i + 1 < argc) { options.rank = std::atoi(argv[++i]); }
+        else if (option == "--transport" && i + 1 < argc) { options.transport = argv[++i]; }
+        else if (option == "--endpoints" && i + 1 < argc) {
+            std::istringstream list(argv[++i]);
+            for (std::string endpoint{}; std::getline(list, endpoint, ',');) { options.endpoints.push_back(endpoint); }
+        }
+        else if (option == "--epochs" && i + 1 < argc) { options.epochs = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--batch" && i + 1 < argc) { options.batchSize = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--samples" && i + 1 < argc) { options.numSamples = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--layers" && i + 1 < argc) { options.numHiddenLayers = std::max(0, std::atoi(argv[++i])); }
+        else if (option == "--neurons" && i + 1 < argc) {
+            options.numNeuronsPerHiddenLayer = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (option == "--learning-rate" && i + 1 < argc) { options.learningRate = std::atof(argv[++i]); }
+        else if (option == "--save" && i + 1 < argc) { options.saveFile = argv[++i]; }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (options.endpoints.empty()) { options.endpoints = DefaultEndpoints(options); }
+    options.numRanks = static_cast<int>(options.endpoints.size());
+    if (options.rank >= options.numRanks) {
+        PrintUsage();
+        return 1;
+    }
+
+    if (options.rank >= 0) { return RunRank(options); }
+
+    // launcher, one child process per rank
+    std::vector<pid_t> children{};
+    for (int r = 0; r < options.numRanks; ++r) {
+        const pid_t child = fork();
+        if (child < 0) {
+            std::cerr << "fork failed\n";
+            return 1;
+        }
+        if (child == 0) {
+            options.rank = r;
+            std::exit(RunRank(options));
+        }
+        children.push_back(child);
+    }
+    int exitCode{};
+    for (const pid_t child : children) {
+        int status{};
+        waitpid(child, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) { exitCode = 1; }
+    }
+    return exitCode;
+}
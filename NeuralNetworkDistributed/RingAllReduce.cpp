@@ -0,0 +1,259 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: RingAllReduce.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "RingAllReduce.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    struct Endpoint {
+        bool isUnix{};
+        std::string path{};
+        std::string host{};
+        std::string port{};
+    };
+
+    Endpoint ParseEndpoint(const std::string& text) {
+        Endpoint endpoint{};
+        if (text.rfind("unix:", 0) == 0) {
+            endpoint.isUnix = true;
+            endpoint.path = text.substr(5);
+            if (endpoint.path.empty() || endpoint.path.size() >= sizeof(sockaddr_un::sun_path)) {
+                throw std::invalid_argument("Invalid Unix socket path in " + text);
+            }
+            return endpoint;
+        }
+        const auto colon = text.rfind(':');
+        if (text.rfind("tcp:", 0) != 0 || colon <= 4) { throw std::invalid_argument("Invalid endpoint " + text); }
+        endpoint.host = text.substr(4, colon - 4);
+        endpoint.port = text.substr(colon + 1);
+        return endpoint;
+    }
+
+    sockaddr_un UnixAddress(const std::string& path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
+
+    /**
+     * \brief call a function with every TCP address of an endpoint until it returns a socket
+     */
+    template <typename Function>
+    int ForEachTcpAddress(const Endpoint& endpoint, const int flags, Function function) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = flags;
+        addrinfo* addresses{};
+        if (getaddrinfo(endpoint.host.c_str(), endpoint.port.c_str(), &hints, &addresses) != 0) { return -1; }
+
+        int result = -1;
+        for (const addrinfo* address = addresses; address != nullptr && result < 0; address = address->ai_next) {
+            result = function(*address);
+        }
+        freeaddrinfo(addresses);
+        return result;
+    }
+
+    int Listen(const Endpoint& endpoint) {
+        if (endpoint.isUnix) {
+            unlink(endpoint.path.c_str());
+            const int listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            const sockaddr_un address = UnixAddress(endpoint.path);
+            if (listenSocket >= 0 &&
+                (bind(listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+                    listen(listenSocket, 4) != 0)) {
+                close(listenSocket);
+                return -1;
+            }
+            return listenSocket;
+        }
+
+        return ForEachTcpAddress(endpoint, AI_PASSIVE, [](const addrinfo& address) {
+            const int listenSocket = socket(address.ai_family, address.ai_socktype | SOCK_CLOEXEC,
+                                            address.ai_protocol);
+            if (listenSocket < 0) { return -1; }
+            const int reuse = 1;
+            setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            if (bind(listenSocket, address.ai_addr, address.ai_addrlen) != 0 || listen(listenSocket, 4) != 0) {
+                close(listenSocket);
+                return -1;
+            }
+            return listenSocket;
+        });
+    }
+
+    int Connect(const Endpoint& endpoint) {
+        if (endpoint.isUnix) {
+            const int connection = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            const sockaddr_un address = UnixAddress(endpoint.path);
+            if (connection >= 0 && connect(connection, reinterpret_cast<const sockaddr*>(&address),
+                                           sizeof(address)) != 0) {
+                close(connection);
+                return -1;
+            }
+            return connection;
+        }
+
+        return ForEachTcpAddress(endpoint, 0, [](const addrinfo& address) {
+            const int connection = socket(address.ai_family, address.ai_socktype | SOCK_CLOEXEC, address.ai_protocol);
+            if (connection >= 0 && connect(connection, address.ai_addr, address.ai_addrlen) != 0) {
+                close(connection);
+                return -1;
+            }
+            return connection;
+        });
+    }
+
+    void PrepareConnection(const int connection, const bool isTcp) {
+        // small chunks go out right away instead of waiting to be coalesced
+        if (isTcp) {
+            const int noDelay = 1;
+            setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        fcntl(connection, F_SETFL, fcntl(connection, F_GETFL) | O_NONBLOCK);
+    }
+
+    std::pair<std::size_t, std::size_t> ChunkBounds(const std::size_t count, const int numChunks, const int chunk) {
+        const std::size_t begin = count * chunk / numChunks;
+        return {begin, count * (chunk + 1) / numChunks - begin};
+    }
+}
+
+RingAllReduce::RingAllReduce(const int rank, const std::vector<std::string>& endpoints,
+                             const std::chrono::seconds timeout) :
+    _rank(rank), _numRanks(static_cast<int>(endpoints.size())) {
+    if (_rank < 0 || _rank >= _numRanks) { throw std::invalid_argument("Rank out of range"); }
+    if (_numRanks == 1) { return; }
+
+    const Endpoint own = ParseEndpoint(endpoints[_rank]);
+    const Endpoint next = ParseEndpoint(endpoints[(_rank + 1) % _numRanks]);
+    _listenSocket = Listen(own);
+    if (_listenSocket < 0) { throw std::runtime_error("Could not listen on " + endpoints[_rank]); }
+    if (own.isUnix) { _unixSocketPath = own.path; }
+
+    // the next rank may not be listening yet
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while ((_nextSocket = Connect(next)) < 0) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            throw std::runtime_error("Could not connect to " + endpoints[(_rank + 1) % _numRanks]);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    const std::int32_t ownRank = _rank;
+    if (send(_nextSocket, &ownRank, sizeof(ownRank), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(ownRank))) {
+        throw std::runtime_error("Could not greet the next rank");
+    }
+
+    pollfd listenEvents{_listenSocket, POLLIN, 0};
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    std::int32_t previousRank{-1};
+    if (poll(&listenEvents, 1, static_cast<int>(std::max<long long>(remaining.count(), 1000))) != 1 ||
+        (_previousSocket = accept4(_listenSocket, nullptr, nullptr, SOCK_CLOEXEC)) < 0 ||
+        recv(_previousSocket, &previousRank, sizeof(previousRank), MSG_WAITALL) !=
+        static_cast<ssize_t>(sizeof(previousRank)) || previousRank != (_rank + _numRanks - 1) % _numRanks) {
+        throw std::runtime_error("The previous rank did not connect");
+    }
+
+    PrepareConnection(_nextSocket, !next.isUnix);
+    PrepareConnection(_previousSocket, !own.isUnix);
+}
+
+RingAllReduce::~RingAllReduce() {
+    for (const int socket : {_nextSocket, _previousSocket, _listenSocket}) {
+        if (socket >= 0) { close(socket); }
+    }
+    if (!_unixSocketPath.empty()) { unlink(_unixSocketPath.c_str()); }
+}
+
+void RingAllReduce::SendReceive(const double* send, const std::size_t sendCount, double* receive,
+                                const std::size_t receiveCount) {
+    const auto* sendBytes = reinterpret_cast<const char*>(send);
+    auto* receiveBytes = reinterpret_cast<char*>(receive);
+    const std::size_t sendSize = sendCount * sizeof(double);
+    const std::size_t receiveSize = receiveCount * sizeof(double);
+    std::size_t sent{}, received{};
+
+    while (sent < sendSize || received < receiveSize) {
+        pollfd events[2]{};
+        int numEvents{};
+        if (sent < sendSize) { events[numEvents++] = {_nextSocket, POLLOUT, 0}; }
+        if (received < receiveSize) { events[numEvents++] = {_previousSocket, POLLIN, 0}; }
+        if (poll(events, numEvents, -1) < 0) {
+            if (errno == EINTR) { continue; }
+            throw std::runtime_error("poll failed during all-reduce");
+        }
+
+        for (int i = 0; i < numEvents; ++i) {
+            if (events[i].revents == 0) { continue; }
+            ssize_t result{};
+            if (events[i].fd == _nextSocket && sent < sendSize) {
+                result = ::send(_nextSocket, sendBytes + sent, sendSize - sent, MSG_NOSIGNAL);
+                if (result > 0) { sent += static_cast<std::size_t>(result); }
+            }
+            else {
+                result = recv(_previousSocket, receiveBytes + received, receiveSize - received, 0);
+                if (result > 0) { received += static_cast<std::size_t>(result); }
+                else if (result == 0) { throw std::runtime_error("Previous rank hung up during all-reduce"); }
+            }
+            if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                throw std::runtime_error(std::string("All-reduce transfer failed: ") + std::strerror(errno));
+            }
+        }
+    }
+}
+
+void RingAllReduce::AllReduce(double* data, const std::size_t count) {
+    if (_numRanks == 1 || count == 0) { return; }
+    _receiveBuffer.resize(count / _numRanks + 1);
+
+    // reduce-scatter, afterwards this rank holds the full sum of chunk rank + 1
+    for (int step = 0; step < _numRanks - 1; ++step) {
+        const auto [sendBegin, sendCount] = ChunkBounds(count, _numRanks, (_rank - step + _numRanks) % _numRanks);
+        const auto [receiveBegin, receiveCount] = ChunkBounds(count, _numRanks,
+                                                              (_rank - step - 1 + 2 * _numRanks) % _numRanks);
+        SendReceive(data + sendBegin, sendCount, _receiveBuffer.data(), receiveCount);
+        for (std::size_t i = 0; i < receiveCount; ++i) { data[receiveBegin + i] += _receiveBuffer[i]; }
+    }
+
+    // all-gather, every rank passes on the summed chunk it received last
+    for (int step = 0; step < _numRanks - 1; ++step) {
+        const auto [sendBegin, sendCount] = ChunkBounds(count, _numRanks, (_rank - step + 1 + _numRanks) % _numRanks);
+        const auto [receiveBegin, receiveCount] = ChunkBounds(count, _numRanks, (_rank - step + _numRanks) % _numRanks);
+        SendReceive(data + sendBegin, sendCount, data + receiveBegin, receiveCount);
+    }
+}
+
+void RingAllReduce::Broadcast(double* data, const std::size_t count, const int root) {
+    if (_numRanks == 1) { return; }
+
+    // passed along the ring, every rank but the root receives before it forwards
+    const int position = (_rank - root + _numRanks) % _numRanks;
+    if (position != 0) { SendReceive(nullptr, 0, data, count); }
+    if (position != _numRanks - 1) { SendReceive(data, count, nullptr, 0); }
+}
@@ -0,0 +1,82 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: RingAllReduce.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : ring all-reduce between processes over Unix or TCP sockets
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef RINGALLREDUCE_H
+#define RINGALLREDUCE_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Sums arrays of doubles across a ring of processes.
+ *
+ * Every rank listens on its own endpoint, connects to the next rank and accepts the previous one. An array is
+ * split into one chunk per rank and reduced in 2 * (numRanks - 1) steps: a reduce-scatter after which every rank
+ * holds the full sum of one chunk, and an all-gather that passes the summed chunks around. Each rank sends and
+ * receives about twice the array size in total, however many ranks there are. Sends and receives run interleaved
+ * on non-blocking sockets, so large chunks cannot deadlock the ring.
+ *
+ * Endpoints are "unix:<path>" or "tcp:<host>:<port>".
+ */
+class RingAllReduce {
+private:
+    int _rank{};
+    int _numRanks{};
+    int _listenSocket{-1};
+    int _nextSocket{-1}; // to rank + 1
+    int _previousSocket{-1}; // from rank - 1
+    std::string _unixSocketPath{}; // removed again on destruction
+    std::vector<double> _receiveBuffer{};
+
+    /**
+     * \brief send one buffer to the next rank while receiving another from the previous one,
+     *  throws std::runtime_error if a peer hangs up
+     */
+    void SendReceive(const double* send, std::size_t sendCount, double* receive, std::size_t receiveCount);
+
+public:
+    /**
+     * \brief connect the ring, throws std::runtime_error if a peer can't be reached before the timeout
+     * \param rank index of this process
+     * \param endpoints endpoint of every rank
+     * \param timeout how long to keep retrying the connection to the next rank
+     */
+    RingAllReduce(int rank, const std::vector<std::string>& endpoints,
+                  std::chrono::seconds timeout = std::chrono::seconds(30));
+
+    /**
+     * \brief close the sockets and remove the Unix socket file
+     */
+    ~RingAllReduce();
+
+    RingAllReduce(const RingAllReduce&) = delete;
+    RingAllReduce& operator=(const RingAllReduce&) = delete;
+
+    [[nodiscard]] int GetRank() const { return _rank; }
+    [[nodiscard]] int GetNumRanks() const { return _numRanks; }
+
+    /**
+     * \brief replace an array by its element-wise sum over all ranks, every rank must call this with the same count
+     * \param data array to reduce in place
+     * \param count number of elements
+     */
+    void AllReduce(double* data, std::size_t count);
+
+    /**
+     * \brief copy an array from one rank to all others
+     * \param data array, read on the root and overwritten on the others
+     * \param count number of elements
+     * \param root rank whose array is copied
+     */
+    void Broadcast(double* data, std::size_t count, int root = 0);
+};
+#endif // RINGALLREDUCE_H
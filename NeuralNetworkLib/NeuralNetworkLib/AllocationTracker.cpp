@@ -0,0 +1,141 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: AllocationTracker.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "AllocationTracker.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef NNL_TRACK_ALLOCATIONS
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "../Eigen/Core"
+
+namespace {
+    struct ThreadAllocations {
+        AllocationCounts counts{};
+        int forbidDepth{}; // nesting of no-allocation regions
+    };
+
+    // constant-initialized, so it is usable by operator new while the thread starts and exits
+    thread_local ThreadAllocations threadAllocations{};
+
+    // Eigen checks whether malloc is allowed on every allocation, so never allowing it routes all of them through
+    // OnEigenAssert. The flag is global and only written here, before main.
+    [[maybe_unused]] const bool eigenMallocForbidden = (Eigen::internal::set_is_malloc_allowed(false), true);
+
+    void* Allocate(std::size_t size) {
+        AllocationTracker::OnAllocation(size, false);
+        if (size == 0) { size = 1; }
+        for (;;) {
+            if (void* pointer = std::malloc(size)) { return pointer; }
+            const std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) { throw std::bad_alloc(); }
+            handler();
+        }
+    }
+
+    void* AllocateAligned(std::size_t size, const std::align_val_t alignment) {
+        AllocationTracker::OnAllocation(size, false);
+        const auto bytes = static_cast<std::size_t>(alignment);
+        // aligned_alloc wants a multiple of the alignment
+        size = size == 0 ? bytes : (size + bytes - 1) / bytes * bytes;
+        for (;;) {
+#ifdef _WIN32
+            if (void* pointer = _aligned_malloc(size, bytes)) { return pointer; }
+#else
+            if (void* pointer = std::aligned_alloc(bytes, size)) { return pointer; }
+#endif
+            const std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) { throw std::bad_alloc(); }
+            handler();
+        }
+    }
+
+    void FreeAligned(void* pointer) {
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+void* operator new(const std::size_t size) { return Allocate(size); }
+void* operator new[](const std::size_t size) { return Allocate(size); }
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+// over-aligned types, e.g. alignas(64) members, come through these
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    return AllocateAligned(size, alignment);
+}
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return AllocateAligned(size, alignment);
+}
+void operator delete(void* pointer, std::align_val_t) noexcept { FreeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { FreeAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { FreeAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { FreeAligned(pointer); }
+
+AllocationCounts AllocationTracker::GetThreadCounts() { return threadAllocations.counts; }
+
+void AllocationTracker::OnAllocation(const std::size_t bytes, const bool eigen) {
+    ThreadAllocations& allocations = threadAllocations;
+    if (eigen) { ++allocations.counts.eigenAllocations; }
+    else {
+        ++allocations.counts.newAllocations;
+        allocations.counts.newBytes += bytes;
+    }
+
+    if (allocations.forbidDepth > 0) {
+        // printing must not come back here
+        allocations.forbidDepth = 0;
+        if (eigen) { std::fputs("Eigen allocated inside a no-allocation region\n", stderr); }
+        else {
+            std::fprintf(stderr, "operator new allocated %llu bytes inside a no-allocation region\n",
+                         static_cast<unsigned long long>(bytes));
+        }
+        std::abort();
+    }
+}
+
+void AllocationTracker::ForbidAllocations(const bool forbid) { threadAllocations.forbidDepth += forbid ? 1 : -1; }
+
+void AllocationTracker::OnEigenAssert(const char* expression, const char* file, const int line) {
+    if (std::strstr(expression, "heap allocation is forbidden") != nullptr) {
+        OnAllocation(0, true);
+        return;
+    }
+#ifndef NDEBUG
+    // any other assertion keeps the behaviour of Eigen's own in debug builds
+    std::fprintf(stderr, "%s:%d: Eigen assertion failed: %s\n", file, line, expression);
+    std::abort();
+#else
+    static_cast<void>(file);
+    static_cast<void>(line);
+#endif
+}
+#else
+AllocationCounts AllocationTracker::GetThreadCounts() { return {}; }
+
+void AllocationTracker::OnAllocation(std::size_t, bool) {}
+
+void AllocationTracker::ForbidAllocations(bool) {}
+
+void AllocationTracker::OnEigenAssert(const char*, const char*, int) {}
+#endif
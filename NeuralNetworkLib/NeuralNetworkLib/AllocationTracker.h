@@ -0,0 +1,121 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: AllocationTracker.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : per-thread heap allocation counters and no-allocation regions, compiled in with
+// //              NNL_TRACK_ALLOCATIONS
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Eigen allocates with malloc rather than operator new, so its allocations are seen through the malloc check of
+// EIGEN_RUNTIME_NO_MALLOC, which reports through eigen_assert. Both must be defined before Eigen is included, which
+// is why this header comes before every include of Eigen in the library.
+#ifdef NNL_TRACK_ALLOCATIONS
+#define EIGEN_RUNTIME_NO_MALLOC
+#define eigen_assert(x) ((x) ? static_cast<void>(0) : AllocationTracker::OnEigenAssert(#x, __FILE__, __LINE__))
+#endif
+
+/**
+ * \brief Heap allocations counted on one thread
+ */
+struct AllocationCounts {
+    std::uint64_t eigenAllocations{}; // matrices, vectors and temporaries allocated by Eigen
+    std::uint64_t newAllocations{}; // calls of the global operator new, e.g. by standard containers
+    std::uint64_t newBytes{}; // bytes requested from the global operator new
+
+    [[nodiscard]] std::uint64_t Total() const { return eigenAllocations + newAllocations; }
+
+    AllocationCounts operator-(const AllocationCounts& other) const {
+        return {eigenAllocations - other.eigenAllocations, newAllocations - other.newAllocations,
+                newBytes - other.newBytes};
+    }
+};
+
+/**
+ * \brief Counts the heap allocations of every thread when the library is built with NNL_TRACK_ALLOCATIONS
+ *  defined, which must then be defined for every file including a library header.
+ *
+ * The global operator new, aligned or not, is replaced to count the allocations of the library and the standard
+ * library, and the allocations of Eigen are counted through its EIGEN_RUNTIME_NO_MALLOC check. Allocating inside a
+ * NoAllocationScope then prints what was allocated and aborts. Without NNL_TRACK_ALLOCATIONS nothing is counted
+ * and the scopes compile to nothing.
+ */
+class AllocationTracker {
+public:
+#ifdef NNL_TRACK_ALLOCATIONS
+    static constexpr bool isEnabled = true;
+#else
+    static constexpr bool isEnabled = false;
+#endif
+
+    /**
+     * \brief get the allocations of the calling thread since it started
+     * \return counts, all zero without NNL_TRACK_ALLOCATIONS
+     */
+    [[nodiscard]] static AllocationCounts GetThreadCounts();
+
+    /**
+     * \brief count an allocation of the calling thread, aborting inside a no-allocation region
+     * \param bytes size of the allocation, 0 if it is unknown
+     * \param eigen true if Eigen made the allocation
+     */
+    static void OnAllocation(std::size_t bytes, bool eigen);
+
+    /**
+     * \brief enter or leave a no-allocation region on the calling thread, regions may be nested
+     * \param forbid true to enter a region, false to leave it
+     */
+    static void ForbidAllocations(bool forbid);
+
+    /**
+     * \brief handle a failed Eigen assertion, which is an allocation if it comes from the malloc check
+     * \param expression text of the assertion
+     * \param file file of the assertion
+     * \param line line of the assertion
+     */
+    static void OnEigenAssert(const char* expression, const char* file, int line);
+};
+
+/**
+ * \brief Counts the allocations of the calling thread during its lifetime
+ */
+class AllocationScope {
+private:
+    AllocationCounts _start{};
+
+public:
+    AllocationScope() : _start(AllocationTracker::GetThreadCounts()) {}
+
+    /**
+     * \brief get the allocations of the calling thread since the scope started
+     * \return counts, all zero without NNL_TRACK_ALLOCATIONS
+     */
+    [[nodiscard]] AllocationCounts GetCounts() const { return AllocationTracker::GetThreadCounts() - _start; }
+};
+
+/**
+ * \brief Marks its lifetime as a region of the calling thread that must not allocate, which aborts the process
+ *  on the first allocation when built with NNL_TRACK_ALLOCATIONS
+ */
+class NoAllocationScope {
+public:
+    NoAllocationScope() {
+        if constexpr (AllocationTracker::isEnabled) { AllocationTracker::ForbidAllocations(true); }
+    }
+
+    ~NoAllocationScope() {
+        if constexpr (AllocationTracker::isEnabled) { AllocationTracker::ForbidAllocations(false); }
+    }
+
+    NoAllocationScope(const NoAllocationScope&) = delete;
+    NoAllocationScope& operator=(const NoAllocationScope&) = delete;
+};
+#endif // ALLOCATIONTRACKER_H
@@ -0,0 +1,72 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: AtomicFile.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "AtomicFile.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool AtomicFile::Commit(const std::string& filename) {
+    const std::string temporaryFilename = TemporaryFilename(filename);
+    if (!Sync(temporaryFilename)) {
+        std::cerr << "Could not flush file " << temporaryFilename << '\n';
+        std::remove(temporaryFilename.c_str());
+        return false;
+    }
+    if (!Replace(temporaryFilename, filename)) {
+        std::cerr << "Could not replace file " << filename << '\n';
+        std::remove(temporaryFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool AtomicFile::Sync(const std::string& filename) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+    const bool flushed = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return flushed;
+#else
+    const int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0) { return false; }
+    const bool flushed = fsync(file) == 0;
+    close(file);
+    return flushed;
+#endif
+}
+
+bool AtomicFile::Replace(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    // write-through makes the rename itself durable, Windows can't flush a directory
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (std::rename(from.c_str(), to.c_str()) != 0) { return false; }
+    const std::filesystem::path parent = std::filesystem::path(to).parent_path();
+    const int directory = open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY);
+    if (directory < 0) { return false; }
+    const bool flushed = fsync(directory) == 0;
+    close(directory);
+    return flushed;
+#endif
+}
@@ -0,0 +1,57 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: AtomicFile.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : crash-safe replacement of a file by a temporary file written next to it
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <string>
+
+/**
+ * \brief Replaces files atomically.
+ *
+ * A writer writes the new contents to TemporaryFilename(filename) and calls Commit, which flushes the temporary
+ * file to the disk and renames it over the target. Readers, and processes that have the old file mapped, keep the
+ * old contents until the rename, and the target is complete at all times, even after a power loss.
+ */
+class AtomicFile {
+public:
+    /**
+     * \brief get the file to write before committing it
+     * \param filename file to replace
+     * \return filename with the suffix ".tmp"
+     */
+    [[nodiscard]] static std::string TemporaryFilename(const std::string& filename) { return filename + ".tmp"; }
+
+    /**
+     * \brief flush the temporary file of filename to the disk and rename it over filename, the temporary file is
+     *  removed if that fails
+     * \param filename file to replace
+     * \return true if the file was replaced
+     */
+    static bool Commit(const std::string& filename);
+
+    /**
+     * \brief flush a written file to the disk, so a rename over another file can't expose an empty file after a
+     *  crash
+     * \param filename file to flush
+     * \return true if the file was flushed
+     */
+    static bool Sync(const std::string& filename);
+
+    /**
+     * \brief replace a file by another and flush the change of the directory to the disk, so the new file survives
+     *  a crash once this returns
+     * \param from file to rename
+     * \param to file to replace
+     * \return true if the file was replaced and the directory flushed
+     */
+    static bool Replace(const std::string& from, const std::string& to);
+};
+#endif // ATOMICFILE_H
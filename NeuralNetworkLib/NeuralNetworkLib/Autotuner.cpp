@@ -0,0 +1,297 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: Autotuner.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "Autotuner.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef NNL_SIMD_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+    constexpr double minSpeedup = 1.05; // a candidate must beat the simpler one by this factor to replace it
+    constexpr int numTuningSamples = 256; // samples in the batch used to time FeedForwardBatch
+    constexpr int minSplitWeights = 4096; // layers with fewer weights are never worth splitting over threads
+
+    /**
+     * \brief time a piece of work after warming it up
+     * \param run work to time
+     * \param budget approximate time to spend measuring
+     * \return median time of one run over several rounds, in seconds
+     */
+    double MeasureSeconds(const std::function<void()>& run, const std::chrono::milliseconds budget) {
+        using Clock = std::chrono::steady_clock;
+        run(); // warm up the caches and wake the thread team
+
+        auto start = Clock::now();
+        run();
+        const double singleRun = std::chrono::duration<double>(Clock::now() - start).count();
+
+        constexpr int numRounds = 5;
+        const double roundTime = std::chrono::duration<double>(budget).count() / numRounds;
+        const long runsPerRound = std::clamp(static_cast<long>(roundTime / std::max(singleRun, 1e-9)), 1L, 1000000L);
+
+        std::array<double, numRounds> times{};
+        for (double& time : times) {
+            start = Clock::now();
+            for (long i = 0; i < runsPerRound; ++i) { run(); }
+            time = std::chrono::duration<double>(Clock::now() - start).count() / static_cast<double>(runsPerRound);
+        }
+        std::nth_element(times.begin(), times.begin() + numRounds / 2, times.end());
+        return times[numRounds / 2];
+    }
+
+#ifdef NNL_SIMD_X86
+    /**
+     * \brief run cpuid
+     * \param leaf function to query
+     * \param registers receives eax, ebx, ecx and edx
+     */
+    void Cpuid(const unsigned leaf, unsigned* registers) {
+#ifdef _MSC_VER
+        int values[4]{};
+        __cpuid(values, static_cast<int>(leaf));
+        std::memcpy(registers, values, sizeof(values));
+#else
+        __cpuid(leaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    }
+#endif
+
+    /**
+     * \brief format a cache line without its key
+     */
+    std::string FormatPlan(const ExecutionPlan& plan) {
+        return std::string(SimdKernels::GetLevelName(plan.simdLevel)) + '\t' + std::to_string(plan.numThreads) +
+            '\t' + std::to_string(plan.minParallelWeights) + '\t' + std::to_string(plan.maxBatchSize);
+    }
+
+    /**
+     * \brief parse a cache line without its key
+     * \return true if the line holds a plan this machine can run
+     */
+    bool ParsePlan(const std::string& text, ExecutionPlan& plan) {
+        std::istringstream stream(text);
+        std::string levelName{};
+        ExecutionPlan parsed{};
+        if (!(stream >> levelName >> parsed.numThreads >> parsed.minParallelWeights >> parsed.maxBatchSize)) {
+            return false;
+        }
+
+        for (int level = 0; level <= static_cast<int>(SimdKernels::GetSupportedLevel()); ++level) {
+            if (levelName == SimdKernels::GetLevelName(static_cast<ESimdLevel>(level))) {
+                parsed.simdLevel = static_cast<ESimdLevel>(level);
+                if (parsed.numThreads < 1 || parsed.minParallelWeights < 0 || parsed.maxBatchSize < 0) { return false; }
+                plan = parsed;
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+Autotuner::Autotuner(std::string cacheFilename, const std::chrono::milliseconds timePerCandidate) :
+    _cacheFilename(std::move(cacheFilename)), _timePerCandidate(timePerCandidate) {}
+
+std::string Autotuner::GetPlanKey(const NeuralNetwork& network) {
+    std::string key = std::to_string(network.GetNumInputs());
+    for (const NeuronLayer& layer : network.GetLayers()) { key += '-' + std::to_string(layer.numNeurons); }
+    key += ' ' + std::to_string(static_cast<int>(network.GetHiddenActivationFunction()));
+    key += ' ' + std::to_string(static_cast<int>(network.GetOutputActivationFunction()));
+    key += " | " + GetCpuModel();
+    key += " | " + std::to_string(std::thread::hardware_concurrency());
+    return key;
+}
+
+std::string Autotuner::GetCpuModel() {
+    std::string model{};
+#ifdef NNL_SIMD_X86
+    // the brand string is spread over the registers of three extended leaves
+    std::array<unsigned, 12> brand{};
+    Cpuid(0x80000000, brand.data());
+    if (brand[0] >= 0x80000004) {
+        for (unsigned leaf = 0; leaf < 3; ++leaf) { Cpuid(0x80000002 + leaf, &brand[leaf * 4]); }
+        const auto* text = reinterpret_cast<const char*>(brand.data());
+        model.assign(text, std::find(text, text + sizeof(brand), '\0'));
+    }
+#endif
+
+    // the string is padded with spaces, and '|' and tabs would break the cache format
+    std::replace_if(model.begin(), model.end(), [](const char c) { return c == '|' || c == '\t'; }, ' ');
+    const auto first = model.find_first_not_of(' ');
+    if (first == std::string::npos) { return "unknown"; }
+    return model.substr(first, model.find_last_not_of(' ') - first + 1);
+}
+
+ExecutionPlan Autotuner::Tune(const NeuralNetwork& network) const {
+    // tune on a copy, so the network keeps its parameters and settings; copies have no checkpointer or thread team
+    NeuralNetwork trial(network);
+    trial.SetMaxBatchSize(0);
+    const NeuralNetwork& constTrial = trial;
+
+    std::mt19937_64 gen{42};
+    std::uniform_real_distribution<double> distribution{-1, 1};
+    const auto random = [&] { return distribution(gen); };
+    const Eigen::Vector<double, Eigen::Dynamic> inputs = Eigen::Vector<double, Eigen::Dynamic>::NullaryExpr(
+        network.GetNumInputs(), random);
+    const Eigen::Vector<double, Eigen::Dynamic> targets = Eigen::Vector<double, Eigen::Dynamic>::NullaryExpr(
+        network.GetNumOutputs(), [&] { return 0.5 + 0.4 * distribution(gen); });
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> batch =
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>::NullaryExpr(network.GetNumInputs(), numTuningSamples,
+                                                                           random);
+
+    ExecutionPlan plan{};
+    const ESimdLevel previousLevel = SimdKernels::GetLevel();
+
+    // kernels: one training step plus the share of one sample in a batch
+    double bestTime = std::numeric_limits<double>::infinity();
+    for (int level = 0; level <= static_cast<int>(SimdKernels::GetSupportedLevel()); ++level) {
+        if (!SimdKernels::SetLevel(static_cast<ESimdLevel>(level))) { continue; }
+        trial.GetParameters() = network.GetParameters();
+        const double time = MeasureSeconds([&] { trial.BackPropagate(inputs, targets); }, _timePerCandidate) +
+            MeasureSeconds([&] { (void)constTrial.FeedForwardBatch(batch); }, _timePerCandidate) / numTuningSamples;
+        if (time < bestTime) {
+            bestTime = time;
+            plan.simdLevel = static_cast<ESimdLevel>(level);
+        }
+    }
+    SimdKernels::SetLevel(plan.simdLevel);
+
+    // threads: each team size with the widest layers split, then the next widest as well, and so on
+    std::vector<int> layerWeights{};
+    for (const NeuronLayer& layer : network.GetLayers()) {
+        const int numWeights = layer.numNeurons * layer.numNeuronInputs;
+        if (numWeights >= minSplitWeights) { layerWeights.push_back(numWeights); }
+    }
+    std::sort(layerWeights.begin(), layerWeights.end(), std::greater<>());
+    layerWeights.erase(std::unique(layerWeights.begin(), layerWeights.end()), layerWeights.end());
+
+    std::vector<int> teamSizes{};
+    const auto numHardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+    for (int size = 2; size < numHardwareThreads; size *= 2) { teamSizes.push_back(size); }
+    if (numHardwareThreads >= 2) { teamSizes.push_back(numHardwareThreads); }
+    if (layerWeights.empty()) { teamSizes.clear(); }
+
+    double bestLatency = MeasureSeconds([&] { (void)constTrial.FeedForward(inputs); }, _timePerCandidate);
+    for (const int size : teamSizes) {
+        ThreadTeam team(static_cast<unsigned>(size));
+        for (const int minParallelWeights : layerWeights) {
+            trial.SetThreadTeam(&team, minParallelWeights);
+            const double latency = MeasureSeconds([&] { (void)constTrial.FeedForward(inputs); }, _timePerCandidate);
+            if (latency * minSpeedup < bestLatency) {
+                bestLatency = latency;
+                plan.numThreads = size;
+                plan.minParallelWeights = minParallelWeights;
+            }
+        }
+        trial.SetThreadTeam(nullptr);
+    }
+
+    // batches: blocks small enough for the outputs of a layer to stay in cache
+    double bestBatchTime = MeasureSeconds([&] { (void)constTrial.FeedForwardBatch(batch); }, _timePerCandidate);
+    for (const int maxBatchSize : {8, 16, 32, 64, 128}) {
+        trial.SetMaxBatchSize(maxBatchSize);
+        const double time = MeasureSeconds([&] { (void)constTrial.FeedForwardBatch(batch); }, _timePerCandidate);
+        if (time * minSpeedup < bestBatchTime) {
+            bestBatchTime = time;
+            plan.maxBatchSize = maxBatchSize;
+        }
+    }
+
+    SimdKernels::SetLevel(previousLevel);
+    return plan;
+}
+
+ExecutionPlan Autotuner::GetPlan(const NeuralNetwork& network) {
+    // one tuning at a time, concurrent runs would slow each other down and skew the results
+    std::lock_guard lock(_mutex);
+    const std::string key = GetPlanKey(network);
+    ExecutionPlan plan{};
+    if (LoadPlan(key, plan)) { return plan; }
+
+    plan = Tune(network);
+    if (!_cacheFilename.empty() && !StorePlan(key, plan)) {
+        std::cerr << "Could not write autotuning cache " << _cacheFilename << '\n';
+    }
+    return plan;
+}
+
+ExecutionPlan Autotuner::Apply(NeuralNetwork& network) {
+    const ExecutionPlan plan = GetPlan(network);
+    Apply(network, plan);
+    return plan;
+}
+
+void Autotuner::Apply(NeuralNetwork& network, const ExecutionPlan& plan) {
+    SimdKernels::SetLevel(plan.simdLevel);
+    network.SetMaxBatchSize(plan.maxBatchSize);
+    if (plan.numThreads <= 1) {
+        network.SetThreadTeam(nullptr);
+        return;
+    }
+
+    // networks with plans of the same size share a team
+    std::lock_guard lock(_mutex);
+    std::unique_ptr<ThreadTeam>& team = _teams[plan.numThreads];
+    if (!team) { team = std::make_unique<ThreadTeam>(static_cast<unsigned>(plan.numThreads)); }
+    network.SetThreadTeam(team.get(), plan.minParallelWeights);
+}
+
+bool Autotuner::LoadPlan(const std::string& key, ExecutionPlan& plan) const {
+    if (_cacheFilename.empty()) { return false; }
+    std::ifstream file(_cacheFilename);
+    std::string line{};
+    while (std::getline(file, line)) {
+        const auto separator = line.find('\t');
+        if (separator != std::string::npos && line.compare(0, separator, key) == 0 && separator == key.size()) {
+            return ParsePlan(line.substr(separator + 1), plan);
+        }
+    }
+    return false;
+}
+
+bool Autotuner::StorePlan(const std::string& key, const ExecutionPlan& plan) const {
+    // keep the plans of other keys, then replace the cache file in one step
+    std::string text{};
+    {
+        std::ifstream file(_cacheFilename);
+        std::string line{};
+        while (std::getline(file, line)) {
+            if (line.compare(0, key.size() + 1, key + '\t') != 0 && !line.empty()) { text += line + '\n'; }
+        }
+    }
+    text += key + '\t' + FormatPlan(plan) + '\n';
+
+    const std::string temporaryFilename = _cacheFilename + ".tmp";
+    {
+        std::ofstream file(temporaryFilename, std::ios::binary);
+        if (!file.is_open() || !file.write(text.data(), static_cast<std::streamsize>(text.size()))) { return false; }
+    }
+    std::error_code error{};
+    std::filesystem::rename(temporaryFilename, _cacheFilename, error);
+    return !error;
+}
@@ -0,0 +1,132 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: Autotuner.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : picks the fastest execution strategy for a network topology on the current machine
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef AUTOTUNER_H
+#define AUTOTUNER_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "NeuralNetwork.h"
+#include "SimdKernels.h"
+#include "ThreadTeam.h"
+
+/**
+ * \brief How a network is run: which kernels, how many threads feed single samples forward and how batches are
+ *  split. None of the choices change the results beyond rounding.
+ */
+struct ExecutionPlan {
+    ESimdLevel simdLevel{}; // set for the whole process by Apply, not per network
+    int numThreads{1}; // members of the thread team feeding single samples forward, 1 for the calling thread only
+    int minParallelWeights{}; // layers with at least this many weights are split over the team
+    int maxBatchSize{}; // samples per block in FeedForwardBatch, 0 for whole batches
+};
+
+/**
+ * \brief Benchmarks the candidate execution strategies for a network topology and caches the winner on disk.
+ *
+ * Tuning runs on a copy of the network and measures, in this order, every kernel level the CPU supports on a
+ * training step and a batch, thread teams of 2, 4, ... up to one member per hardware thread on a single sample
+ * with each choice of layers to split, and the FeedForwardBatch block size. A candidate only replaces a simpler one
+ * if it is clearly faster, so noise doesn't turn on threads that don't pay off.
+ *
+ * Plans are cached in a text file, one line per key, where the key holds the layer widths, the activation
+ * functions, the CPU model and the number of hardware threads. The thread teams are owned by the autotuner, which
+ * must outlive the networks it was applied to.
+ *
+ * The kernel level is process-wide: SimdKernels holds one level that every network, layer and pipeline uses, so
+ * Apply sets the level for all of them, not just the network it is given, and the last plan applied wins. Tune
+ * switches the level while it measures and restores it afterwards, so no other thread should run kernels in the
+ * meantime. Apply plans once at startup, and when several networks are tuned, apply a common level with
+ * SimdKernels::SetLevel if their plans differ.
+ */
+class Autotuner {
+private:
+    std::string _cacheFilename{};
+    std::chrono::milliseconds _timePerCandidate{};
+
+    std::map<int, std::unique_ptr<ThreadTeam>> _teams{}; // teams of the applied plans by number of members
+    std::mutex _mutex{}; // guards the teams and the cache file
+
+    /**
+     * \brief look up a plan in the cache file
+     * \param key key of the plan
+     * \param plan receives the plan if it is found
+     * \return true if the cache holds a usable plan for the key
+     */
+    bool LoadPlan(const std::string& key, ExecutionPlan& plan) const;
+
+    /**
+     * \brief add a plan to the cache file, replacing any plan with the same key
+     * \param key key of the plan
+     * \param plan plan to store
+     * \return true if the cache file was written
+     */
+    bool StorePlan(const std::string& key, const ExecutionPlan& plan) const;
+
+public:
+    /**
+     * \brief create an autotuner
+     * \param cacheFilename file the plans are cached in, an empty name disables the cache
+     * \param timePerCandidate time spent measuring each candidate
+     */
+    explicit Autotuner(std::string cacheFilename = "autotune.cache",
+                       std::chrono::milliseconds timePerCandidate = std::chrono::milliseconds(20));
+
+    Autotuner(const Autotuner&) = delete;
+    Autotuner& operator=(const Autotuner&) = delete;
+
+    /**
+     * \brief get the cache key of a network on this machine
+     * \param network network to describe
+     * \return key, e.g. "8-32-32-2 2 1 | Intel(R) Xeon(R) Gold 6338 CPU @ 2.00GHz | 64"
+     */
+    static std::string GetPlanKey(const NeuralNetwork& network);
+
+    /**
+     * \brief get the model name of the CPU
+     * \return brand string reported by cpuid, or "unknown"
+     */
+    static std::string GetCpuModel();
+
+    /**
+     * \brief benchmark the candidates for a network without looking at the cache, the network is not changed; the
+     *  process-wide kernel level is switched while measuring and restored afterwards
+     * \param network network to tune for
+     * \return fastest plan
+     */
+    [[nodiscard]] ExecutionPlan Tune(const NeuralNetwork& network) const;
+
+    /**
+     * \brief get the cached plan for a network, tuning and caching one if there is none
+     * \param network network to get the plan for
+     * \return plan for the network
+     */
+    ExecutionPlan GetPlan(const NeuralNetwork& network);
+
+    /**
+     * \brief get the plan for a network and make its inference and training use it; the kernel level of the plan
+     *  is set for the whole process
+     * \param network network to set up
+     * \return plan in use
+     */
+    ExecutionPlan Apply(NeuralNetwork& network);
+
+    /**
+     * \brief make a network run with a given plan; the kernel level of the plan is set for the whole process
+     * \param network network to set up
+     * \param plan plan to use
+     */
+    void Apply(NeuralNetwork& network, const ExecutionPlan& plan);
+};
+#endif // AUTOTUNER_H
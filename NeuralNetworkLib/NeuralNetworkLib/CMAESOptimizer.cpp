@@ -0,0 +1,169 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: CMAESOptimizer.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "CMAESOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+// default strategy parameters follow Hansen, "The CMA Evolution Strategy: A Tutorial" (2016),
+// the diagonal model uses the learning rates of Ros & Hansen, "A Simple Modification in CMA-ES" (2008)
+
+CMAESOptimizer::CMAESOptimizer(const NeuralNetwork& network, const double initialStepSize, const int populationSize,
+                               const ECovarianceModel covarianceModel, const std::uint64_t seed) :
+    _networks(1, network), _covarianceModel(covarianceModel), _numParameters(network.GetNumParameters()),
+    _stepSize(initialStepSize), _generator(seed) {
+    if (populationSize < 0 || populationSize == 1) {
+        throw std::invalid_argument("Population size must be at least 2");
+    }
+    const double n = _numParameters;
+
+    _populationSize = populationSize > 0 ? populationSize : 4 + static_cast<int>(3.0 * std::log(n));
+    _numParents = _populationSize / 2;
+
+    // log-linear recombination weights of the fittest half
+    _recombinationWeights.resize(_numParents);
+    for (int i = 0; i < _numParents; ++i) {
+        _recombinationWeights[i] = std::log(_numParents + 0.5) - std::log(i + 1.0);
+    }
+    _recombinationWeights /= _recombinationWeights.sum();
+    _effectiveParents = 1.0 / _recombinationWeights.squaredNorm();
+
+    const double mu = _effectiveParents;
+    _stepSizeLearningRate = (mu + 2.0) / (n + mu + 5.0);
+    _stepSizeDamping = 1.0 + 2.0 * std::max(0.0, std::sqrt((mu - 1.0) / (n + 1.0)) - 1.0) + _stepSizeLearningRate;
+    _cumulationRate = (4.0 + mu / n) / (n + 4.0 + 2.0 * mu / n);
+    _rankOneLearningRate = 2.0 / ((n + 1.3) * (n + 1.3) + mu);
+    _rankMuLearningRate = std::min(1.0 - _rankOneLearningRate,
+                                   2.0 * (mu - 2.0 + 1.0 / mu) / ((n + 2.0) * (n + 2.0) + mu));
+    if (_covarianceModel == ECovarianceModel::DIAGONAL) {
+        // a diagonal covariance has only n degrees of freedom and can be learned faster
+        const double speedUp = (n + 2.0) / 3.0;
+        _rankOneLearningRate = std::min(1.0, _rankOneLearningRate * speedUp);
+        _rankMuLearningRate = std::min(1.0 - _rankOneLearningRate, _rankMuLearningRate * speedUp);
+    }
+    _expectedNormLength = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+    _mean = network.GetParameters();
+    _stepSizePath = Eigen::VectorXd::Zero(_numParameters);
+    _covariancePath = Eigen::VectorXd::Zero(_numParameters);
+    _scales = Eigen::VectorXd::Ones(_numParameters);
+    if (_covarianceModel == ECovarianceModel::FULL) {
+        _covariance = Eigen::MatrixXd::Identity(_numParameters, _numParameters);
+        _eigenvectors = Eigen::MatrixXd::Identity(_numParameters, _numParameters);
+    }
+    _bestParameters = _mean;
+}
+
+void CMAESOptimizer::DecomposeCovariance() {
+    // C = B diag(d^2) B^T, with tiny negative eigenvalues from rounding clamped away
+    const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(_covariance);
+    _eigenvectors = solver.eigenvectors();
+    _scales = solver.eigenvalues().cwiseMax(1e-20).cwiseSqrt();
+    _lastDecomposition = _generation;
+}
+
+double CMAESOptimizer::Step(const std::function<double(const NeuralNetwork& network)>& fitness, ThreadPool& pool) {
+    const bool full = _covarianceModel == ECovarianceModel::FULL;
+
+    // sample z ~ N(0, I) and map it to y ~ N(0, C)
+    std::normal_distribution<double> normal{};
+    const Eigen::MatrixXd z = Eigen::MatrixXd::NullaryExpr(_numParameters, _populationSize,
+                                                           [&] { return normal(_generator); });
+    Eigen::MatrixXd y{};
+    if (full) { y.noalias() = _eigenvectors * (_scales.asDiagonal() * z); }
+    else { y = _scales.asDiagonal() * z; }
+
+    // evaluate the candidates, every thread reusing its own network
+    if (_networks.size() < static_cast<std::size_t>(pool.GetNumThreads()) + 1) {
+        _networks.resize(pool.GetNumThreads() + 1, _networks.front());
+    }
+    Eigen::VectorXd fitnesses(_populationSize);
+    pool.ParallelFor(_populationSize, [&](const int k, const int worker) {
+        _networks[worker].GetParameters() = _mean + _stepSize * y.col(k);
+        fitnesses[k] = fitness(_networks[worker]);
+    });
+
+    std::vector<int> ranking(_populationSize);
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::sort(ranking.begin(), ranking.end(), [&](const int a, const int b) { return fitnesses[a] > fitnesses[b]; });
+
+    if (fitnesses[ranking[0]] > _bestFitness) {
+        _bestFitness = fitnesses[ranking[0]];
+        _bestParameters = _mean + _stepSize * y.col(ranking[0]);
+    }
+
+    // weighted recombination of the fittest steps
+    Eigen::MatrixXd parents(_numParameters, _numParents);
+    for (int i = 0; i < _numParents; ++i) { parents.col(i) = y.col(ranking[i]); }
+    const Eigen::VectorXd meanStep = parents * _recombinationWeights;
+    _mean += _stepSize * meanStep;
+    ++_generation;
+
+    // cumulative step-size adaptation, the path is whitened with C^(-1/2)
+    const double pathScale = std::sqrt(_stepSizeLearningRate * (2.0 - _stepSizeLearningRate) * _effectiveParents);
+    if (full) {
+        _stepSizePath = (1.0 - _stepSizeLearningRate) * _stepSizePath + pathScale * (_eigenvectors * (
+            _scales.cwiseInverse().asDiagonal() * (_eigenvectors.transpose() * meanStep)));
+    }
+    else {
+        _stepSizePath = (1.0 - _stepSizeLearningRate) * _stepSizePath + pathScale * meanStep.cwiseQuotient(_scales);
+    }
+    const double pathLength = _stepSizePath.norm();
+    const double expectedPathLength = std::sqrt(1.0 - std::pow(1.0 - _stepSizeLearningRate, 2.0 * _generation));
+    const bool pathTooLong = pathLength / expectedPathLength >=
+        (1.4 + 2.0 / (_numParameters + 1.0)) * _expectedNormLength;
+
+    // covariance path, frozen while the step size is growing fast
+    _covariancePath *= 1.0 - _cumulationRate;
+    if (!pathTooLong) {
+        _covariancePath += std::sqrt(_cumulationRate * (2.0 - _cumulationRate) * _effectiveParents) * meanStep;
+    }
+    const double stallCorrection = pathTooLong ? _cumulationRate * (2.0 - _cumulationRate) : 0.0;
+    const double decay = 1.0 - _rankOneLearningRate - _rankMuLearningRate + _rankOneLearningRate * stallCorrection;
+
+    // rank-one and rank-mu covariance updates
+    if (full) {
+        _covariance *= decay;
+        _covariance.noalias() += _rankOneLearningRate * _covariancePath * _covariancePath.transpose();
+        _covariance.noalias() += _rankMuLearningRate * parents * _recombinationWeights.asDiagonal() *
+            parents.transpose();
+
+        // the decomposition is O(n^3), so it is only refreshed often enough to track C
+        const double decompositionInterval = 1.0 / ((_rankOneLearningRate + _rankMuLearningRate) *
+            _numParameters * 10.0);
+        if (_generation - _lastDecomposition >= decompositionInterval) { DecomposeCovariance(); }
+    }
+    else {
+        Eigen::VectorXd variances = _scales.cwiseAbs2() * decay;
+        variances += _rankOneLearningRate * _covariancePath.cwiseAbs2();
+        variances += _rankMuLearningRate * parents.cwiseAbs2() * _recombinationWeights;
+        _scales = variances.cwiseMax(1e-20).cwiseSqrt();
+    }
+
+    _stepSize *= std::exp(_stepSizeLearningRate / _stepSizeDamping * (pathLength / _expectedNormLength - 1.0));
+
+    return fitnesses[ranking[0]];
+}
+
+double CMAESOptimizer::Optimize(const std::function<double(const NeuralNetwork& network)>& fitness, ThreadPool& pool,
+                                const int maxGenerations, const double targetFitness) {
+    for (int i = 0; i < maxGenerations && _bestFitness < targetFitness; ++i) {
+        Step(fitness, pool);
+    }
+    return _bestFitness;
+}
+
+void CMAESOptimizer::CopyBestToNetwork(NeuralNetwork& network) const {
+    network.GetParameters() = _bestParameters;
+}
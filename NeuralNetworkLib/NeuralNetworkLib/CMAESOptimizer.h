@@ -0,0 +1,125 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: CMAESOptimizer.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : covariance matrix adaptation evolution strategy over network parameters
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef CMAESOPTIMIZER_H
+#define CMAESOPTIMIZER_H
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "NeuralNetwork.h"
+#include "ThreadPool.h"
+
+/**
+ * \brief Enum class to represent the covariance models of the CMA-ES optimizer
+ */
+enum class ECovarianceModel : uint8_t {
+    FULL, // full covariance matrix, O(n^2) memory and an eigendecomposition every few generations
+    DIAGONAL // separable CMA-ES, O(n) memory and time, for large parameter counts
+};
+
+/**
+ * \brief CMA-ES over the flattened weights and biases of a network.
+ *
+ * Each generation samples candidate parameter vectors around a mean, evaluates them in parallel and moves the
+ * mean, step size and covariance towards the fittest candidates. Every thread reuses one network that the
+ * candidates are copied into, kept from one generation to the next, so no network is constructed per sample or per
+ * generation. Fitness is maximised.
+ */
+class CMAESOptimizer {
+private:
+    std::vector<NeuralNetwork> _networks{}; // one per thread evaluating candidates, kept across generations
+    ECovarianceModel _covarianceModel{};
+    int _numParameters{};
+    int _populationSize{};
+    int _numParents{};
+
+    // strategy parameters
+    Eigen::Vector<double, Eigen::Dynamic> _recombinationWeights{};
+    double _effectiveParents{};
+    double _stepSizeLearningRate{};
+    double _stepSizeDamping{};
+    double _cumulationRate{};
+    double _rankOneLearningRate{};
+    double _rankMuLearningRate{};
+    double _expectedNormLength{};
+
+    // state
+    Eigen::Vector<double, Eigen::Dynamic> _mean{};
+    double _stepSize{};
+    Eigen::Vector<double, Eigen::Dynamic> _stepSizePath{};
+    Eigen::Vector<double, Eigen::Dynamic> _covariancePath{};
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> _covariance{}; // full model only
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> _eigenvectors{}; // full model only
+    Eigen::Vector<double, Eigen::Dynamic> _scales{}; // square roots of the eigenvalues, or of the diagonal
+    int _generation{};
+    int _lastDecomposition{};
+
+    Eigen::Vector<double, Eigen::Dynamic> _bestParameters{};
+    double _bestFitness{-std::numeric_limits<double>::infinity()};
+
+    std::mt19937_64 _generator{};
+
+    /**
+     * \brief refresh the eigendecomposition of the covariance matrix
+     */
+    void DecomposeCovariance();
+
+public:
+    /**
+     * \brief set up the search around the current parameters of a network
+     * \param network network whose topology is optimised, its parameters are the initial mean
+     * \param initialStepSize initial standard deviation of the search distribution
+     * \param populationSize candidates per generation, at least 2, or 0 for the default 4 + 3 ln(n)
+     * \param covarianceModel full or diagonal covariance
+     * \param seed seed of the random number generator
+     */
+    CMAESOptimizer(const NeuralNetwork& network, double initialStepSize = 0.1, int populationSize = 0,
+                   ECovarianceModel covarianceModel = ECovarianceModel::FULL,
+                   std::uint64_t seed = std::random_device{}());
+
+    /**
+     * \brief run one generation
+     * \param fitness called concurrently with a network holding a candidate, returns its fitness,
+     *  higher is better
+     * \param pool threads to evaluate the candidates on
+     * \return best fitness of the generation
+     */
+    double Step(const std::function<double(const NeuralNetwork& network)>& fitness, ThreadPool& pool);
+
+    /**
+     * \brief run generations until the best fitness reaches a target or a generation limit is hit
+     * \param fitness called concurrently with a network holding a candidate, returns its fitness,
+     *  higher is better
+     * \param pool threads to evaluate the candidates on
+     * \param maxGenerations maximum number of generations
+     * \param targetFitness stop once a candidate is at least this fit
+     * \return best fitness found
+     */
+    double Optimize(const std::function<double(const NeuralNetwork& network)>& fitness, ThreadPool& pool,
+                    int maxGenerations, double targetFitness = std::numeric_limits<double>::infinity());
+
+    /**
+     * \brief copy the best candidate found so far into a network with the same topology
+     * \param network network to overwrite
+     */
+    void CopyBestToNetwork(NeuralNetwork& network) const;
+
+    [[nodiscard]] const Eigen::Vector<double, Eigen::Dynamic>& GetMean() const { return _mean; }
+    [[nodiscard]] const Eigen::Vector<double, Eigen::Dynamic>& GetBestParameters() const { return _bestParameters; }
+    [[nodiscard]] double GetBestFitness() const { return _bestFitness; }
+    [[nodiscard]] double GetStepSize() const { return _stepSize; }
+    [[nodiscard]] int GetGeneration() const { return _generation; }
+    [[nodiscard]] int GetPopulationSize() const { return _populationSize; }
+};
+#endif // CMAESOPTIMIZER_H
@@ -0,0 +1,283 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: CodeGenerator.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "CodeGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    /**
+     * \brief append a double as a C++ literal that round-trips exactly
+     * \param source buffer to append to
+     * \param value number to format
+     * \return false if the value is not finite and has no literal
+     */
+    bool AppendLiteral(std::string& source, const double value) {
+        if (!std::isfinite(value)) { return false; }
+
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        const std::string literal(buffer, result.ptr);
+        source += literal;
+
+        // make sure integral values are still double literals
+        if (literal.find_first_of(".e") == std::string::npos) { source += ".0"; }
+        return true;
+    }
+
+    // keywords and alternative tokens up to C++20, none of which can name a namespace
+    constexpr const char* keywords[] = {
+        "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+        "char", "char8_t", "char16_t", "char32_t", "class", "co_await", "co_return", "co_yield", "compl", "concept",
+        "const", "const_cast", "consteval", "constexpr", "constinit", "continue", "decltype", "default", "delete",
+        "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+        "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+        "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+        "requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct",
+        "switch", "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename",
+        "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+    };
+
+    /**
+     * \brief check that a name can be used as a C++ identifier
+     * \param name name to check
+     * \return true if the name is a valid identifier that is neither a keyword nor reserved for the implementation
+     */
+    bool IsIdentifier(const std::string& name) {
+        if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) { return false; }
+        for (const char c : name) {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') { return false; }
+        }
+        if (name.find("__") != std::string::npos ||
+            (name[0] == '_' && name.size() > 1 && std::isupper(static_cast<unsigned char>(name[1])))) {
+            return false;
+        }
+        return std::find(std::begin(keywords), std::end(keywords), name) == std::end(keywords);
+    }
+}
+
+std::string CodeGenerator::ActivationExpression(const std::string& variable,
+                                                const EActivationFunction activationFunction) {
+    switch (activationFunction) {
+    case EActivationFunction::HEAVISIDE_STEP_FUNCTION:
+        return "(" + variable + " > 0.0 ? 1.0 : 0.0)";
+    case EActivationFunction::SIGMOID_FUNCTION:
+        return "1.0 / (1.0 + std::exp(-" + variable + "))";
+    case EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION:
+        return "std::tanh(" + variable + ")";
+    case EActivationFunction::RELU_FUNCTION:
+        return "(" + variable + " > 0.0 ? " + variable + " : 0.0)";
+    case EActivationFunction::NONE:
+        return variable;
+    }
+    return {};
+}
+
+std::string CodeGenerator::GenerateHeader(const NeuralNetwork& network, const std::string& name) {
+    if (!IsIdentifier(name)) {
+        std::cerr << "Invalid name for generated code: " << name << '\n';
+        return {};
+    }
+
+    const auto& layers = network.GetLayers();
+    if (layers.empty()) {
+        std::cerr << "Cannot generate code for an empty network\n";
+        return {};
+    }
+    if (ActivationExpression("sum", network.GetHiddenActivationFunction()).empty() ||
+        ActivationExpression("sum", network.GetOutputActivationFunction()).empty()) {
+        std::cerr << "Cannot generate code for an invalid activation function\n";
+        return {};
+    }
+
+    std::string guard = name;
+    for (char& c : guard) { c = static_cast<char>(std::toupper(static_cast<unsigned char>(c))); }
+    guard += "_GENERATED_H";
+
+    std::string source{};
+    source += "// Generated by NeuralNetworkLib CodeGenerator, do not edit.\n";
+    source += "#ifndef " + guard + "\n#define " + guard + "\n\n#include <cmath>\n\n";
+    source += "namespace " + name + " {\n";
+    source += "    constexpr int numInputs = " + std::to_string(layers.front().numNeuronInputs) + ";\n";
+    source += "    constexpr int numOutputs = " + std::to_string(layers.back().numNeurons) + ";\n\n";
+
+    // weights are emitted row by row so the inner loop of each layer walks contiguous memory
+    for (std::size_t l = 0; l < layers.size(); ++l) {
+        const auto& layer = layers[l];
+        const std::string index = std::to_string(l);
+
+        source += "    alignas(64) constexpr double layer" + index + "Weights[" + std::to_string(layer.numNeurons) +
+            "][" + std::to_string(layer.numNeuronInputs) + "] = {\n";
+        for (int i = 0; i < layer.numNeurons; ++i) {
+            source += "        {";
+            for (int j = 0; j < layer.numNeuronInputs; ++j) {
+                if (j > 0) { source += ", "; }
+                if (!AppendLiteral(source, layer.weights(i, j))) {
+                    std::cerr << "Cannot generate code for non-finite parameters\n";
+                    return {};
+                }
+            }
+            source += "},\n";
+        }
+        source += "    };\n";
+
+        source += "    alignas(64) constexpr double layer" + index + "Biases[" + std::to_string(layer.numNeurons) +
+            "] = {";
+        for (int i = 0; i < layer.numNeurons; ++i) {
+            if (i > 0) { source += ", "; }
+            if (!AppendLiteral(source, layer.biases[i])) {
+                std::cerr << "Cannot generate code for non-finite parameters\n";
+                return {};
+            }
+        }
+        source += "};\n\n";
+    }
+
+    // one block per layer, with every size a compile-time constant
+    source += "    /**\n     * \\brief evaluate the network\n";
+    source += "     * \\param inputs numInputs input values\n     * \\param outputs receives numOutputs values\n";
+    source += "     */\n";
+    source += "    inline void Infer(const double* inputs, double* outputs) {\n";
+    for (std::size_t l = 0; l < layers.size(); ++l) {
+        const auto& layer = layers[l];
+        const std::string index = std::to_string(l);
+        const bool isOutputLayer = l + 1 == layers.size();
+        const std::string in = l == 0 ? "inputs" : "layer" + std::to_string(l - 1) + "Outputs";
+        const std::string out = isOutputLayer ? "outputs" : "layer" + index + "Outputs";
+        const auto activationFunction = isOutputLayer
+                                            ? network.GetOutputActivationFunction()
+                                            : network.GetHiddenActivationFunction();
+
+        if (!isOutputLayer) {
+            source += "        alignas(64) double " + out + "[" + std::to_string(layer.numNeurons) + "];\n";
+        }
+        source += "        for (int i = 0; i < " + std::to_string(layer.numNeurons) + "; ++i) {\n";
+        source += "            double sum = layer" + index + "Biases[i];\n";
+        source += "            for (int j = 0; j < " + std::to_string(layer.numNeuronInputs) + "; ++j) {\n";
+        source += "                sum += layer" + index + "Weights[i][j] * " + in + "[j];\n";
+        source += "            }\n";
+        source += "            " + out + "[i] = " + ActivationExpression("sum", activationFunction) + ";\n";
+        source += "        }\n";
+    }
+    source += "    }\n";
+    source += "} // namespace " + name + "\n\n#endif // " + guard + "\n";
+
+    return source;
+}
+
+bool CodeGenerator::GenerateHeaderFile(const NeuralNetwork& network, const std::string& filename,
+                                       const std::string& name) {
+    const std::string source = GenerateHeader(network, name);
+    if (source.empty()) { return false; }
+    std::ofstream file(filename, std::ios::binary);
+
+    if (file.is_open()) {
+        file.write(source.data(), static_cast<std::streamsize>(source.size()));
+        return file.good();
+    }
+
+    std::cerr << "Could not open file " << filename << '\n';
+    return false;
+}
+
+bool CodeGenerator::GenerateHeaderFileFromModel(const std::string& modelFilename, const std::string& filename,
+                                                const std::string& name) {
+    NeuralNetwork network{};
+    if (!network.LoadFromFile(modelFilename)) { return false; }
+    return GenerateHeaderFile(network, filename, name);
+}
+
+CompiledNetwork::~CompiledNetwork() {
+#ifndef _WIN32
+    if (_library != nullptr) { dlclose(_library); }
+#endif
+}
+
+bool CompiledNetwork::Compile(const NeuralNetwork& network, const std::string& compiler, const std::string& flags) {
+#ifdef _WIN32
+    static_cast<void>(network);
+    static_cast<void>(compiler);
+    static_cast<void>(flags);
+    std::cerr << "Compiling generated code is not supported on Windows\n";
+    return false;
+#else
+    const std::string header = CodeGenerator::GenerateHeader(network, "generated_network");
+    if (header.empty()) { return false; }
+
+    // every compilation gets its own files, so several networks can be compiled at once
+    static std::atomic<int> numCompilations{};
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string stem = "NeuralNetworkLibGenerated" + std::to_string(getpid()) + "_" +
+        std::to_string(numCompilations++);
+    const std::filesystem::path headerPath = directory / (stem + ".h");
+    const std::filesystem::path sourcePath = directory / (stem + ".cpp");
+    const std::filesystem::path libraryPath = directory / (stem + ".so");
+    const auto removeFiles = [&] {
+        std::error_code error{};
+        std::filesystem::remove(headerPath, error);
+        std::filesystem::remove(sourcePath, error);
+        std::filesystem::remove(libraryPath, error);
+    };
+
+    {
+        std::ofstream headerFile(headerPath, std::ios::binary);
+        headerFile << header;
+        std::ofstream sourceFile(sourcePath, std::ios::binary);
+        sourceFile << "#include \"" << headerPath.string() << "\"\n"
+            << "extern \"C\" void NeuralNetworkLibInfer(const double* inputs, double* outputs) {\n"
+            << "    generated_network::Infer(inputs, outputs);\n}\n";
+        if (!headerFile || !sourceFile) {
+            std::cerr << "Could not write generated code to " << directory.string() << '\n';
+            removeFiles();
+            return false;
+        }
+    }
+
+    const std::string command = compiler + " -std=c++17 " + flags + " -shared -fPIC -o \"" + libraryPath.string() +
+        "\" \"" + sourcePath.string() + "\"";
+    if (std::system(command.c_str()) != 0) {
+        std::cerr << "Could not compile generated code with: " << command << '\n';
+        removeFiles();
+        return false;
+    }
+
+    void* library = dlopen(libraryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    void* infer = library != nullptr ? dlsym(library, "NeuralNetworkLibInfer") : nullptr;
+    // the loaded library stays usable after its file is removed
+    removeFiles();
+    if (infer == nullptr) {
+        std::cerr << "Could not load generated code: " << dlerror() << '\n';
+        if (library != nullptr) { dlclose(library); }
+        return false;
+    }
+
+    if (_library != nullptr) { dlclose(_library); }
+    _library = library;
+    _infer = reinterpret_cast<void (*)(const double*, double*)>(infer);
+    _numInputs = network.GetNumInputs();
+    _numOutputs = network.GetNumOutputs();
+    return true;
+#endif
+}
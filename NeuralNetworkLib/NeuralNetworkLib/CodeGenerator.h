@@ -0,0 +1,107 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: CodeGenerator.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : ahead-of-time generation of standalone C++ inference code
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef CODEGENERATOR_H
+#define CODEGENERATOR_H
+
+#include <string>
+
+#include "NeuralNetwork.h"
+
+/**
+ * \brief Emits a standalone C++ header that evaluates a trained network.
+ *
+ * The generated header holds the weights and biases as aligned constexpr arrays and an inline
+ * Infer(const double* inputs, double* outputs) function with every layer size fixed at compile time,
+ * so the compiler can unroll and vectorize it. It only depends on <cmath>, not on Eigen or this library.
+ */
+class CodeGenerator {
+public:
+    /**
+     * \brief generate the header source for a network
+     * \param network trained network
+     * \param name C++ identifier used as the namespace of the generated code, not a keyword
+     * \return contents of the header, empty if the name is invalid or the network has non-finite parameters
+     */
+    static std::string GenerateHeader(const NeuralNetwork& network, const std::string& name);
+
+    /**
+     * \brief generate a header for a network and write it to a file
+     * \param network trained network
+     * \param filename header file to write
+     * \param name C++ identifier used as the namespace of the generated code
+     * \return true if the header was generated and the file was written
+     */
+    static bool GenerateHeaderFile(const NeuralNetwork& network, const std::string& filename, const std::string& name);
+
+    /**
+     * \brief generate a header from a model saved with NeuralNetwork::SaveToFile
+     * \param modelFilename saved model to read
+     * \param filename header file to write
+     * \param name C++ identifier used as the namespace of the generated code
+     * \return true if the model was loaded, the header was generated and the file was written
+     */
+    static bool GenerateHeaderFileFromModel(const std::string& modelFilename, const std::string& filename,
+                                            const std::string& name);
+
+    /**
+     * \brief C++ expression applying an activation function to a variable
+     * \param variable name of the variable holding the net input
+     * \param activationFunction activation function to apply
+     * \return expression evaluating the activation function, empty for an invalid activation function
+     */
+    static std::string ActivationExpression(const std::string& variable, EActivationFunction activationFunction);
+};
+
+/**
+ * \brief Generated inference code of a network, compiled into a shared library and loaded into the process.
+ *
+ * Lets the generated code be checked against FeedForward and timed without a separate build step. It needs a C++
+ * compiler on the PATH and is only supported on POSIX systems.
+ */
+class CompiledNetwork {
+private:
+    void* _library{}; // handle from dlopen
+    void (*_infer)(const double* inputs, double* outputs){};
+    int _numInputs{};
+    int _numOutputs{};
+
+public:
+    CompiledNetwork() = default;
+
+    /**
+     * \brief unload the library
+     */
+    ~CompiledNetwork();
+
+    CompiledNetwork(const CompiledNetwork&) = delete;
+    CompiledNetwork& operator=(const CompiledNetwork&) = delete;
+
+    /**
+     * \brief generate the code for a network, compile it and load it, replacing any code loaded before
+     * \param network trained network
+     * \param compiler command of the C++ compiler, e.g. "g++"
+     * \param flags extra compiler flags, e.g. "-O2 -march=native"
+     * \return true if the code was compiled and loaded
+     */
+    bool Compile(const NeuralNetwork& network, const std::string& compiler = "c++", const std::string& flags = "-O2");
+
+    [[nodiscard]] bool IsLoaded() const { return _infer != nullptr; }
+    [[nodiscard]] int GetNumInputs() const { return _numInputs; }
+    [[nodiscard]] int GetNumOutputs() const { return _numOutputs; }
+
+    /**
+     * \brief evaluate the loaded code
+     * \param inputs GetNumInputs() input values
+     * \param outputs receives GetNumOutputs() values
+     */
+    void Infer(const double* inputs, double* outputs) const { _infer(inputs, outputs); }
+};
+#endif // CODEGENERATOR_H
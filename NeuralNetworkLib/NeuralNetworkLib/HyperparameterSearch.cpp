@@ -0,0 +1,199 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: HyperparameterSearch.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "HyperparameterSearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+HyperparameterSearch::HyperparameterSearch(const int numInputs, const int numOutputs, HyperparameterSpace space,
+                                           const int minEpochs, const int maxEpochs, const int reductionFactor) :
+    _numInputs(numInputs), _numOutputs(numOutputs), _space(std::move(space)), _reductionFactor(reductionFactor) {
+    if (minEpochs <= 0 || maxEpochs <= 0) { throw std::invalid_argument("Epoch budgets must be positive"); }
+    if (reductionFactor < 2) { throw std::invalid_argument("Reduction factor must be at least 2"); }
+
+    // geometric rung budgets, the last rung is always the full budget
+    for (int epochs = minEpochs; epochs < maxEpochs; epochs *= reductionFactor) { _rungEpochs.push_back(epochs); }
+    _rungEpochs.push_back(maxEpochs);
+
+    for (const double learningRate : _space.learningRates) {
+        for (const int numHiddenLayers : _space.numHiddenLayers) {
+            for (const int numNeurons : _space.numNeuronsPerHiddenLayer) {
+                for (int restart = 0; restart < _space.numRestarts; ++restart) {
+                    HyperparameterTrial trial{};
+                    trial.learningRate = learningRate;
+                    trial.numHiddenLayers = numHiddenLayers;
+                    trial.numNeuronsPerHiddenLayer = numNeurons;
+                    trial.restart = restart;
+                    _trials.push_back(trial);
+                }
+            }
+        }
+    }
+    if (_trials.empty()) { throw std::invalid_argument("Hyperparameter space is empty"); }
+}
+
+bool HyperparameterSearch::NextJob(int& trial, int& rung) {
+    const auto numRungs = static_cast<int>(_rungEpochs.size());
+
+    // promote from the highest rung first, so good trials finish early
+    for (int k = numRungs - 2; k >= 0; --k) {
+        std::vector<RungEntry> ranked = _rungs[k];
+        const auto numPromotable = static_cast<std::ptrdiff_t>(ranked.size()) / _reductionFactor;
+        if (numPromotable == 0) { continue; }
+
+        std::partial_sort(ranked.begin(), ranked.begin() + numPromotable, ranked.end(),
+                          [](const RungEntry& a, const RungEntry& b) { return a.loss < b.loss; });
+        for (std::ptrdiff_t i = 0; i < numPromotable; ++i) {
+            const int candidate = ranked[i].trial;
+            if (!_running[candidate] && _trials[candidate].rung == k) {
+                trial = candidate;
+                rung = k + 1;
+                _running[trial] = true;
+                ++_numRunning;
+                return true;
+            }
+        }
+    }
+
+    if (_nextTrial < static_cast<int>(_trials.size())) {
+        trial = _nextTrial++;
+        rung = 0;
+        _running[trial] = true;
+        ++_numRunning;
+        return true;
+    }
+    return false;
+}
+
+NeuralNetwork HyperparameterSearch::Run(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                                        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets,
+                                        ThreadPool& pool) {
+    return Run(inputs, targets, inputs, targets, pool);
+}
+
+NeuralNetwork HyperparameterSearch::Run(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                                        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets,
+                                        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& validationInputs,
+                                        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>&
+                                        validationTargets, ThreadPool& pool) {
+    if (inputs.rows() != _numInputs || targets.rows() != _numOutputs || inputs.cols() != targets.cols() ||
+        validationInputs.rows() != _numInputs || validationTargets.rows() != _numOutputs ||
+        validationInputs.cols() != validationTargets.cols() || validationInputs.cols() == 0) {
+        throw std::invalid_argument("Dataset does not match the network inputs and outputs");
+    }
+
+    const auto numTrials = static_cast<int>(_trials.size());
+    for (auto& trial : _trials) {
+        trial.epochs = 0;
+        trial.rung = -1;
+        trial.loss = std::numeric_limits<double>::infinity();
+    }
+    _networks.assign(numTrials, NeuralNetwork{});
+    _rungs.assign(_rungEpochs.size(), {});
+    _running.assign(numTrials, false);
+    _nextTrial = 0;
+    _numRunning = 0;
+
+    // one scheduling loop per thread, a loop only ends when no trial is running that could free up a promotion
+    pool.ParallelFor(pool.GetNumThreads() + 1, [&](int, int) {
+        while (true) {
+            int trial{};
+            int rung{};
+            {
+                std::unique_lock lock(_mutex);
+                while (!NextJob(trial, rung)) {
+                    if (_numRunning == 0) { return; }
+                    _jobFinished.wait(lock);
+                }
+            }
+
+            double loss{};
+            try {
+                const HyperparameterTrial& settings = _trials[trial];
+                NeuralNetwork& network = _networks[trial];
+                if (rung == 0) {
+                    network = NeuralNetwork(_numInputs, _numOutputs, settings.numHiddenLayers,
+                                            settings.numNeuronsPerHiddenLayer, settings.learningRate);
+                    network.SetHiddenActivationFunction(_space.hiddenActivationFunction);
+                    network.SetOutputActivationFunction(_space.outputActivationFunction);
+                }
+                while (network.GetTrainedEpochs() < _rungEpochs[rung]) { network.TrainEpoch(inputs, targets); }
+
+                loss = (network.FeedForwardBatch(validationInputs) - validationTargets).squaredNorm() /
+                    static_cast<double>(validationTargets.size());
+                if (!std::isfinite(loss)) { loss = std::numeric_limits<double>::infinity(); }
+            }
+            catch (...) {
+                {
+                    std::lock_guard lock(_mutex);
+                    _running[trial] = false;
+                    --_numRunning;
+                }
+                _jobFinished.notify_all();
+                throw;
+            }
+
+            {
+                std::lock_guard lock(_mutex);
+                HyperparameterTrial& result = _trials[trial];
+                result.epochs = _rungEpochs[rung];
+                result.rung = rung;
+                result.loss = loss;
+                _rungs[rung].push_back({trial, loss});
+                _running[trial] = false;
+                --_numRunning;
+            }
+            _jobFinished.notify_all();
+        }
+    });
+
+    // trials that got further beat trials that were stopped, whatever their loss at the lower rung
+    _bestTrial = 0;
+    for (int i = 1; i < numTrials; ++i) {
+        const HyperparameterTrial& trial = _trials[i];
+        const HyperparameterTrial& best = _trials[_bestTrial];
+        if (trial.rung > best.rung || (trial.rung == best.rung && trial.loss < best.loss)) { _bestTrial = i; }
+    }
+
+    NeuralNetwork best = std::move(_networks[_bestTrial]);
+    _networks.clear();
+    return best;
+}
+
+std::string HyperparameterSearch::GetResultsTable() const {
+    std::vector<int> order(_trials.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](const int a, const int b) {
+        return _trials[a].rung != _trials[b].rung ? _trials[a].rung > _trials[b].rung
+                                                  : _trials[a].loss < _trials[b].loss;
+    });
+
+    std::ostringstream table{};
+    table << std::left << std::setw(7) << "trial" << std::setw(15) << "learning rate" << std::setw(8) << "layers"
+        << std::setw(8) << "width" << std::setw(9) << "restart" << std::setw(8) << "epochs" << std::setw(15)
+        << "loss" << "status\n";
+    for (const int i : order) {
+        const HyperparameterTrial& trial = _trials[i];
+        table << std::setw(7) << i << std::setw(15) << trial.learningRate << std::setw(8) << trial.numHiddenLayers
+            << std::setw(8) << trial.numNeuronsPerHiddenLayer << std::setw(9) << trial.restart << std::setw(8)
+            << trial.epochs << std::setw(15) << trial.loss;
+        if (trial.rung < 0) { table << "not run\n"; }
+        else if (trial.rung == static_cast<int>(_rungEpochs.size()) - 1) { table << "completed\n"; }
+        else { table << "stopped at rung " << trial.rung << '\n'; }
+    }
+    return table.str();
+}
@@ -0,0 +1,150 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: HyperparameterSearch.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : parallel hyperparameter search with asynchronous successive halving
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef HYPERPARAMETERSEARCH_H
+#define HYPERPARAMETERSEARCH_H
+
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "NeuralNetwork.h"
+#include "ThreadPool.h"
+
+/**
+ * \brief Grid of constructor arguments to search, every combination is trained numRestarts times
+ *  from different random initialisations
+ */
+struct HyperparameterSpace {
+    std::vector<double> learningRates{0.1};
+    std::vector<int> numHiddenLayers{1};
+    std::vector<int> numNeuronsPerHiddenLayer{8};
+    int numRestarts{1};
+    EActivationFunction hiddenActivationFunction{EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION};
+    EActivationFunction outputActivationFunction{EActivationFunction::SIGMOID_FUNCTION};
+};
+
+/**
+ * \brief One configuration and restart of a search and how far it got
+ */
+struct HyperparameterTrial {
+    double learningRate{};
+    int numHiddenLayers{};
+    int numNeuronsPerHiddenLayer{};
+    int restart{};
+    int epochs{}; // epochs trained before the trial was stopped or completed
+    int rung{-1}; // highest rung reached, -1 if the trial never ran
+    double loss{std::numeric_limits<double>::infinity()}; // validation mean square error at that rung
+};
+
+/**
+ * \brief Trains many configurations and random restarts concurrently and stops poor runs early with
+ *  asynchronous successive halving (ASHA).
+ *
+ * Trials are trained in rungs of minEpochs, minEpochs * reductionFactor, ... up to maxEpochs epochs. Whenever a
+ * thread becomes free, it continues the best waiting trial that is in the top 1 / reductionFactor of its rung, and
+ * otherwise starts a new trial, so no thread waits for a rung to fill up. Trials that are never promoted are
+ * stopped where they are. All trials read the same dataset, which is never copied.
+ */
+class HyperparameterSearch {
+private:
+    int _numInputs{};
+    int _numOutputs{};
+    HyperparameterSpace _space{};
+    int _reductionFactor{};
+    std::vector<int> _rungEpochs{}; // epochs a trial has trained when it completes each rung
+
+    std::vector<HyperparameterTrial> _trials{};
+    std::vector<NeuralNetwork> _networks{};
+    int _bestTrial{-1};
+
+    // scheduler state, guarded by the mutex
+    struct RungEntry {
+        int trial;
+        double loss;
+    };
+
+    std::vector<std::vector<RungEntry>> _rungs{};
+    std::vector<bool> _running{};
+    int _nextTrial{};
+    int _numRunning{};
+    std::mutex _mutex{};
+    std::condition_variable _jobFinished{};
+
+    /**
+     * \brief pick the next trial to train, promoting a waiting trial before starting a new one
+     * \param trial receives the trial index
+     * \param rung receives the rung to train the trial to
+     * \return true if there was work
+     */
+    bool NextJob(int& trial, int& rung);
+
+public:
+    /**
+     * \brief set up a search
+     * \param numInputs number of network inputs
+     * \param numOutputs number of network outputs
+     * \param space configurations to search
+     * \param minEpochs epochs every trial is trained for before it may be stopped
+     * \param maxEpochs epochs the surviving trials are trained for
+     * \param reductionFactor only the top 1 / reductionFactor of each rung is promoted to the next
+     */
+    HyperparameterSearch(int numInputs, int numOutputs, HyperparameterSpace space, int minEpochs, int maxEpochs,
+                         int reductionFactor = 3);
+
+    /**
+     * \brief run the search, scoring the trials on the training data
+     * \param inputs matrix with one input vector per column
+     * \param targets matrix with one target vector per column
+     * \param pool threads to train the trials on; must not be the pool running the caller, as the scheduling loops
+     *  block on each other and a loop stacked on the worker training the trial it waits for deadlocks
+     * \return copy of the best network found
+     */
+    NeuralNetwork Run(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets, ThreadPool& pool);
+
+    /**
+     * \brief run the search, scoring the trials on held-out data
+     * \param inputs matrix with one training input vector per column
+     * \param targets matrix with one training target vector per column
+     * \param validationInputs matrix with one validation input vector per column
+     * \param validationTargets matrix with one validation target vector per column
+     * \param pool threads to train the trials on; must not be the pool running the caller, as the scheduling loops
+     *  block on each other and a loop stacked on the worker training the trial it waits for deadlocks
+     * \return copy of the best network found
+     */
+    NeuralNetwork Run(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets,
+                      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& validationInputs,
+                      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& validationTargets,
+                      ThreadPool& pool);
+
+    /**
+     * \brief get every trial of the last run
+     * \return trials in grid order
+     */
+    [[nodiscard]] const std::vector<HyperparameterTrial>& GetTrials() const { return _trials; }
+
+    /**
+     * \brief get the index of the best trial of the last run, the one with the lowest loss among those that got
+     *  furthest
+     * \return index into GetTrials, -1 before the first run
+     */
+    [[nodiscard]] int GetBestTrial() const { return _bestTrial; }
+
+    /**
+     * \brief format the trials of the last run as a text table, best first
+     * \return table with one line per trial
+     */
+    [[nodiscard]] std::string GetResultsTable() const;
+};
+#endif // HYPERPARAMETERSEARCH_H
@@ -0,0 +1,91 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: IncrementalTrainer.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "IncrementalTrainer.h"
+
+#include <stdexcept>
+
+IncrementalTrainer::IncrementalTrainer(NeuralNetwork& network, const std::vector<std::vector<double>>& inputs,
+                                       const std::vector<std::vector<double>>& targets, const double maxError,
+                                       const int maxEpochs) :
+    _network(network), _maxError(maxError), _maxEpochs(maxEpochs) {
+    if (inputs.empty() || inputs.size() != targets.size()) {
+        throw std::invalid_argument("Inputs and targets must be non-empty and of the same size");
+    }
+
+    // converted once, so no sample is copied while training
+    for (std::size_t j = 0; j < inputs.size(); ++j) {
+        _inputs.emplace_back(Eigen::Map<const Eigen::VectorXd>(inputs[j].data(),
+                                                               static_cast<Eigen::Index>(inputs[j].size())));
+        _targets.emplace_back(Eigen::Map<const Eigen::VectorXd>(targets[j].data(),
+                                                                static_cast<Eigen::Index>(targets[j].size())));
+    }
+}
+
+IncrementalTrainer::IncrementalTrainer(NeuralNetwork& network,
+                                       const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                                       const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets,
+                                       const double maxError, const int maxEpochs) :
+    _network(network), _maxError(maxError), _maxEpochs(maxEpochs) {
+    if (inputs.cols() == 0 || inputs.cols() != targets.cols()) {
+        throw std::invalid_argument("Inputs and targets must be non-empty and of the same size");
+    }
+
+    for (Eigen::Index j = 0; j < inputs.cols(); ++j) {
+        _inputs.emplace_back(inputs.col(j));
+        _targets.emplace_back(targets.col(j));
+    }
+}
+
+void IncrementalTrainer::TrainSample() {
+    _epochError += _network.BackPropagate(_inputs[_sampleIndex], _targets[_sampleIndex]);
+
+    if (++_sampleIndex == _inputs.size()) {
+        _sampleIndex = 0;
+        _network.FinishEpoch();
+        ++_epoch;
+        _lastEpochError = _epochError;
+        _epochError = 0.0;
+        _converged = _lastEpochError <= _maxError;
+    }
+}
+
+int IncrementalTrainer::Step(const std::chrono::nanoseconds budget) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + budget;
+    auto now = Clock::now();
+    int numSamples{};
+
+    while (!IsFinished()) {
+        // stop if the next sample is expected to overrun the budget
+        if (numSamples > 0 && now + std::chrono::nanoseconds(static_cast<long long>(_sampleTimeEstimate)) >
+            deadline) { break; }
+
+        TrainSample();
+        ++numSamples;
+
+        const auto previous = now;
+        now = Clock::now();
+        const auto sampleTime = static_cast<double>(std::chrono::nanoseconds(now - previous).count());
+        _sampleTimeEstimate = _sampleTimeEstimate == 0.0 ? sampleTime : 0.9 * _sampleTimeEstimate + 0.1 * sampleTime;
+    }
+    return numSamples;
+}
+
+#if defined(__cpp_impl_coroutine)
+TrainingTask IncrementalTrainer::Run(const std::chrono::nanoseconds budgetPerResume) {
+    while (!IsFinished()) {
+        Step(budgetPerResume);
+        if (IsFinished()) { break; }
+        co_await std::suspend_always{};
+    }
+}
+#endif
@@ -0,0 +1,177 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: IncrementalTrainer.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : time-budgeted training that can be spread over the frames of an application
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef INCREMENTALTRAINER_H
+#define INCREMENTALTRAINER_H
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <exception>
+#include <utility>
+#endif
+
+#include "NeuralNetwork.h"
+
+#if defined(__cpp_impl_coroutine)
+/**
+ * \brief Coroutine returned by IncrementalTrainer::Run, every Resume trains for one time budget
+ */
+class TrainingTask {
+public:
+    struct promise_type {
+        std::exception_ptr exception{};
+
+        TrainingTask get_return_object() {
+            return TrainingTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> _handle{};
+
+    explicit TrainingTask(const std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+public:
+    TrainingTask(TrainingTask&& other) noexcept : _handle(std::exchange(other._handle, {})) {}
+
+    TrainingTask& operator=(TrainingTask&& other) noexcept {
+        if (this != &other) {
+            if (_handle) { _handle.destroy(); }
+            _handle = std::exchange(other._handle, {});
+        }
+        return *this;
+    }
+
+    TrainingTask(const TrainingTask&) = delete;
+    TrainingTask& operator=(const TrainingTask&) = delete;
+
+    ~TrainingTask() { if (_handle) { _handle.destroy(); } }
+
+    /**
+     * \brief train for one time budget, exceptions thrown by the training are rethrown here
+     * \return false once training has finished, already on the resume that finishes it
+     */
+    bool Resume() {
+        if (Done()) { return false; }
+        _handle.resume();
+        if (_handle.promise().exception) { std::rethrow_exception(_handle.promise().exception); }
+        return !Done();
+    }
+
+    [[nodiscard]] bool Done() const { return !_handle || _handle.done(); }
+};
+#endif
+
+/**
+ * \brief Trains a network a few samples at a time within a wall-clock budget per call.
+ *
+ * Step runs back propagation over the samples in order, like NeuralNetwork::Train, and stops before the next
+ * sample would overrun the budget, judged by a running estimate of the time per sample. The position in the
+ * dataset is kept between calls, so a game loop can call Step once per frame. Training finishes when an epoch's
+ * error drops to maxError, after maxEpochs epochs, or when Cancel is called, which is safe from any thread.
+ */
+class IncrementalTrainer {
+private:
+    NeuralNetwork& _network;
+    std::vector<Eigen::Vector<double, Eigen::Dynamic>> _inputs{};
+    std::vector<Eigen::Vector<double, Eigen::Dynamic>> _targets{};
+    double _maxError{};
+    int _maxEpochs{};
+
+    std::size_t _sampleIndex{};
+    int _epoch{};
+    double _epochError{}; // error summed over the samples of the current epoch so far
+    double _lastEpochError{-1.0};
+    bool _converged{};
+    std::atomic<bool> _cancelRequested{};
+
+    double _sampleTimeEstimate{}; // running average of the time per sample in nanoseconds
+
+    /**
+     * \brief back propagate the next sample and finish the epoch if it was the last one
+     */
+    void TrainSample();
+
+public:
+    /**
+     * \brief set up training of a network
+     * \param network network to train, must outlive the trainer
+     * \param inputs vector of input vectors
+     * \param targets vector of target vectors
+     * \param maxError finish once the error of an epoch is at most this
+     * \param maxEpochs finish after this many epochs
+     */
+    IncrementalTrainer(NeuralNetwork& network, const std::vector<std::vector<double>>& inputs,
+                       const std::vector<std::vector<double>>& targets, double maxError = 1e-3,
+                       int maxEpochs = 1000);
+
+    /**
+     * \brief set up training of a network
+     * \param network network to train, must outlive the trainer
+     * \param inputs matrix with one input vector per column
+     * \param targets matrix with one target vector per column
+     * \param maxError finish once the error of an epoch is at most this
+     * \param maxEpochs finish after this many epochs
+     */
+    IncrementalTrainer(NeuralNetwork& network, const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                       const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets, double maxError = 1e-3,
+                       int maxEpochs = 1000);
+
+    /**
+     * \brief train for at most a wall-clock budget, at least one sample is trained per call so training always
+     *  progresses
+     * \param budget time to spend
+     * \return number of samples trained
+     */
+    int Step(std::chrono::nanoseconds budget);
+
+#if defined(__cpp_impl_coroutine)
+    /**
+     * \brief get a coroutine that calls Step once per resume until training finishes, and completes on the resume
+     *  that finishes it rather than suspending once more; the trainer must outlive it
+     * \param budgetPerResume time to spend per resume
+     * \return suspended training coroutine
+     */
+    TrainingTask Run(std::chrono::nanoseconds budgetPerResume);
+#endif
+
+    /**
+     * \brief ask training to stop before the next sample, safe to call from any thread
+     */
+    void Cancel() { _cancelRequested.store(true, std::memory_order_relaxed); }
+
+    [[nodiscard]] bool IsCancelled() const { return _cancelRequested.load(std::memory_order_relaxed); }
+    [[nodiscard]] bool IsConverged() const { return _converged; }
+
+    /**
+     * \brief check if training has converged, reached its epoch limit or been cancelled
+     * \return true if Step has nothing left to do
+     */
+    [[nodiscard]] bool IsFinished() const { return _converged || _epoch >= _maxEpochs || IsCancelled(); }
+
+    [[nodiscard]] int GetEpoch() const { return _epoch; }
+    [[nodiscard]] std::size_t GetSampleIndex() const { return _sampleIndex; }
+
+    /**
+     * \brief get the error of the last finished epoch
+     * \return sum of the mean square errors of its samples, -1 before the first epoch has finished
+     */
+    [[nodiscard]] double GetLastEpochError() const { return _lastEpochError; }
+};
+#endif // INCREMENTALTRAINER_H
@@ -0,0 +1,149 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: InferenceQueue.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "InferenceQueue.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+InferenceQueue::InferenceQueue(const NeuralNetwork& network, const int maxBatchSize,
+                               const std::chrono::microseconds maxWait) :
+    _network(network), _maxBatchSize(std::max(1, maxBatchSize)), _maxWait(maxWait),
+    _batchSizeHistogram(_maxBatchSize + 1) {
+    _latencies.reserve(latencyWindow);
+    _dispatcher = std::thread(&InferenceQueue::Dispatch, this);
+}
+
+InferenceQueue::~InferenceQueue() {
+    {
+        std::lock_guard lock(_mutex);
+        _stopRequested = true;
+    }
+    _condition.notify_all();
+    _dispatcher.join();
+}
+
+std::future<Eigen::Vector<double, Eigen::Dynamic>> InferenceQueue::Submit(
+    Eigen::Vector<double, Eigen::Dynamic> inputs) {
+    if (inputs.size() != _network.GetNumInputs()) {
+        throw std::invalid_argument("Input size does not match the network");
+    }
+
+    Request request{std::move(inputs), {}, Clock::now()};
+    auto result = request.result.get_future();
+    {
+        std::lock_guard lock(_mutex);
+        _requests.push_back(std::move(request));
+        _maxQueueDepth = std::max(_maxQueueDepth, _requests.size());
+    }
+    _condition.notify_one();
+    return result;
+}
+
+void InferenceQueue::Dispatch() {
+    std::vector<Request> batch{};
+    batch.reserve(_maxBatchSize);
+
+    while (true) {
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this] { return _stopRequested || !_requests.empty(); });
+            if (_requests.empty()) { return; }
+
+            // the batch closes when it is full or its oldest request has waited long enough,
+            // on shutdown the waiting requests are answered right away
+            const auto deadline = _requests.front().submitted + _maxWait;
+            _condition.wait_until(lock, deadline, [this] {
+                return _stopRequested || _requests.size() >= static_cast<std::size_t>(_maxBatchSize);
+            });
+
+            const auto batchSize = std::min(_requests.size(), static_cast<std::size_t>(_maxBatchSize));
+            for (std::size_t i = 0; i < batchSize; ++i) {
+                batch.push_back(std::move(_requests.front()));
+                _requests.pop_front();
+            }
+        }
+
+        RunBatch(batch);
+        batch.clear();
+    }
+}
+
+void InferenceQueue::RunBatch(std::vector<Request>& batch) {
+    const auto batchSize = static_cast<Eigen::Index>(batch.size());
+
+    try {
+        Eigen::MatrixXd inputs(_network.GetNumInputs(), batchSize);
+        for (Eigen::Index i = 0; i < batchSize; ++i) { inputs.col(i) = batch[i].inputs; }
+        const Eigen::MatrixXd outputs = _network.FeedForwardBatch(inputs);
+        for (Eigen::Index i = 0; i < batchSize; ++i) { batch[i].result.set_value(outputs.col(i)); }
+    }
+    catch (...) {
+        for (auto& request : batch) { request.result.set_exception(std::current_exception()); }
+    }
+
+    const auto finished = Clock::now();
+    std::lock_guard lock(_statisticsMutex);
+    _numRequests += batch.size();
+    ++_numBatches;
+    ++_batchSizeHistogram[batch.size()];
+    for (const auto& request : batch) {
+        const double latency = std::chrono::duration<double, std::micro>(finished - request.submitted).count();
+        if (_latencies.size() < latencyWindow) { _latencies.push_back(latency); }
+        else { _latencies[_nextLatency] = latency; }
+        _nextLatency = (_nextLatency + 1) % latencyWindow;
+    }
+}
+
+InferenceQueueStatistics InferenceQueue::GetStatistics() const {
+    InferenceQueueStatistics statistics{};
+    {
+        std::lock_guard lock(_mutex);
+        statistics.queueDepth = _requests.size();
+        statistics.maxQueueDepth = _maxQueueDepth;
+    }
+
+    std::vector<double> latencies{};
+    {
+        std::lock_guard lock(_statisticsMutex);
+        statistics.numRequests = _numRequests;
+        statistics.numBatches = _numBatches;
+        statistics.batchSizeHistogram = _batchSizeHistogram;
+        latencies = _latencies;
+    }
+
+    if (!latencies.empty()) {
+        const auto percentile = [&latencies](const double p) {
+            const auto rank = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1));
+            std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+            return latencies[rank];
+        };
+        statistics.latencyP50 = percentile(0.5);
+        statistics.latencyP90 = percentile(0.9);
+        statistics.latencyP99 = percentile(0.99);
+        statistics.latencyMax = *std::max_element(latencies.begin(), latencies.end());
+    }
+    return statistics;
+}
+
+void InferenceQueue::ResetStatistics() {
+    {
+        std::lock_guard lock(_mutex);
+        _maxQueueDepth = _requests.size();
+    }
+    std::lock_guard lock(_statisticsMutex);
+    _numRequests = 0;
+    _numBatches = 0;
+    std::fill(_batchSizeHistogram.begin(), _batchSizeHistogram.end(), 0);
+    _latencies.clear();
+    _nextLatency = 0;
+}
@@ -0,0 +1,127 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: InferenceQueue.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : in-process queue that groups single-sample requests into batched forward passes
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef INFERENCEQUEUE_H
+#define INFERENCEQUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "NeuralNetwork.h"
+
+/**
+ * \brief Snapshot of the statistics of an inference queue
+ */
+struct InferenceQueueStatistics {
+    std::size_t queueDepth{}; // requests waiting when the snapshot was taken
+    std::size_t maxQueueDepth{};
+    std::uint64_t numRequests{}; // requests answered
+    std::uint64_t numBatches{};
+    std::vector<std::uint64_t> batchSizeHistogram{}; // entry b counts the batches of b requests
+    // time from Submit until the result is ready, in microseconds, over the most recent requests
+    double latencyP50{};
+    double latencyP90{};
+    double latencyP99{};
+    double latencyMax{};
+};
+
+/**
+ * \brief Groups single-sample requests from many threads into micro-batches.
+ *
+ * Producers call Submit and get a future for the output. A dispatcher thread waits for the oldest waiting request
+ * to become maxWait old or for maxBatchSize requests, whichever comes first, and answers the whole batch with one
+ * FeedForwardBatch, so requests share matrix-matrix products instead of each running its own matrix-vector ones.
+ */
+class InferenceQueue {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        Eigen::Vector<double, Eigen::Dynamic> inputs;
+        std::promise<Eigen::Vector<double, Eigen::Dynamic>> result;
+        Clock::time_point submitted;
+    };
+
+    // latencies kept for the percentiles
+    static constexpr std::size_t latencyWindow = 8192;
+
+    NeuralNetwork _network{};
+    int _maxBatchSize{};
+    std::chrono::microseconds _maxWait{};
+
+    std::deque<Request> _requests{};
+    mutable std::mutex _mutex{};
+    std::condition_variable _condition{};
+    bool _stopRequested{};
+    std::size_t _maxQueueDepth{};
+
+    mutable std::mutex _statisticsMutex{};
+    std::uint64_t _numRequests{};
+    std::uint64_t _numBatches{};
+    std::vector<std::uint64_t> _batchSizeHistogram{};
+    std::vector<double> _latencies{}; // ring buffer of the latest latencies in microseconds
+    std::size_t _nextLatency{};
+
+    std::thread _dispatcher{};
+
+    /**
+     * \brief dispatcher loop forming and running the batches
+     */
+    void Dispatch();
+
+    /**
+     * \brief run one batch and fulfil its promises
+     * \param batch requests of the batch
+     */
+    void RunBatch(std::vector<Request>& batch);
+
+public:
+    /**
+     * \brief start the dispatcher
+     * \param network network to answer the requests with, it is copied
+     * \param maxBatchSize maximum number of requests per batch
+     * \param maxWait longest time a request waits for a batch to fill up
+     */
+    explicit InferenceQueue(const NeuralNetwork& network, int maxBatchSize = 32,
+                            std::chrono::microseconds maxWait = std::chrono::microseconds(500));
+
+    /**
+     * \brief answer the waiting requests and stop the dispatcher
+     */
+    ~InferenceQueue();
+
+    InferenceQueue(const InferenceQueue&) = delete;
+    InferenceQueue& operator=(const InferenceQueue&) = delete;
+
+    /**
+     * \brief queue one sample, safe to call from any thread
+     * \param inputs input vector
+     * \return future receiving the output vector, or the exception thrown while computing it
+     */
+    std::future<Eigen::Vector<double, Eigen::Dynamic>> Submit(Eigen::Vector<double, Eigen::Dynamic> inputs);
+
+    /**
+     * \brief take a snapshot of the statistics
+     * \return current statistics
+     */
+    [[nodiscard]] InferenceQueueStatistics GetStatistics() const;
+
+    /**
+     * \brief clear the counters, histogram and latencies, e.g. after a warm-up
+     */
+    void ResetStatistics();
+};
+#endif // INFERENCEQUEUE_H
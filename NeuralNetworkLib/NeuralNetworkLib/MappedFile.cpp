@@ -0,0 +1,107 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: MappedFile.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // PAGE_WRITECOPY together with FILE_MAP_COPY gives a private copy-on-write view
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (data == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    _fileHandle = file;
+    _mappingHandle = mapping;
+    _data = data;
+    _size = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (_data != nullptr) { UnmapViewOfFile(_data); }
+    if (_mappingHandle != nullptr) { CloseHandle(_mappingHandle); }
+    if (_fileHandle != nullptr) { CloseHandle(_fileHandle); }
+    _data = nullptr;
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+    _size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+
+    const int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0) { return false; }
+
+    struct stat status{};
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        close(file);
+        return false;
+    }
+
+    // MAP_PRIVATE keeps the pages shared until this process writes to them
+    void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file,
+                      0);
+    // the mapping holds its own reference to the file
+    close(file);
+    if (data == MAP_FAILED) { return false; }
+
+    _data = data;
+    _size = static_cast<std::size_t>(status.st_size);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (_data != nullptr) { munmap(_data, _size); }
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
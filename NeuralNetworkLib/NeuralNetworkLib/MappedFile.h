@@ -0,0 +1,64 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: MappedFile.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : copy-on-write memory mapping of a file
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * \brief Private copy-on-write view of a whole file mapped into memory.
+ *
+ * Writes to the view never reach the file, they give this process its own copy of the page. Untouched pages are
+ * shared through the page cache between every process that maps the same file. The file must not be truncated or
+ * rewritten in place while it is mapped, replace it by renaming a new file over it.
+ */
+class MappedFile {
+private:
+    void* _data{};
+    std::size_t _size{};
+#ifdef _WIN32
+    void* _fileHandle{};
+    void* _mappingHandle{};
+#endif
+
+    /**
+     * \brief release the mapping and the underlying handles
+     */
+    void Close();
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * \brief map a file into memory, replacing any previous mapping
+     * \param filename path of the file to map
+     * \return true if the file was mapped
+     */
+    bool Open(const std::string& filename);
+
+    /**
+     * \brief start of the mapped memory, writes only affect this process
+     * \return pointer to the first byte of the file
+     */
+    [[nodiscard]] std::byte* Data() const { return static_cast<std::byte*>(_data); }
+
+    /**
+     * \brief size of the mapped file
+     * \return size in bytes
+     */
+    [[nodiscard]] std::size_t Size() const { return _size; }
+};
+#endif // MAPPEDFILE_H
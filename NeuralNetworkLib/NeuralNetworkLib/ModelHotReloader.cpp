@@ -0,0 +1,104 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ModelHotReloader.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "ModelHotReloader.h"
+
+#include <stdexcept>
+
+ModelHotReloader::ModelHotReloader(std::string filename, const EModelFileFormat fileFormat,
+                                   const std::chrono::milliseconds pollInterval) : _filename(std::move(filename)),
+    _fileFormat(fileFormat), _pollInterval(pollInterval) {
+    Reload();
+    _watcher = std::thread(&ModelHotReloader::Watch, this);
+}
+
+ModelHotReloader::~ModelHotReloader() {
+    {
+        std::lock_guard lock(_stopMutex);
+        _stopRequested = true;
+    }
+    _stopCondition.notify_all();
+    _watcher.join();
+
+    delete _current.load(std::memory_order_acquire);
+}
+
+bool ModelHotReloader::Reload() {
+    std::lock_guard lock(_reloadMutex);
+
+    // remember the file stamp before loading, so a write racing with the load triggers another reload
+    std::error_code error{};
+    _lastWriteTime = std::filesystem::last_write_time(_filename, error);
+    _lastFileSize = std::filesystem::file_size(_filename, error);
+
+    // load the new version off the inference path
+    auto* network = new NeuralNetwork();
+    const bool loaded = _fileFormat == EModelFileFormat::BINARY
+                            ? network->LoadFromBinaryFile(_filename, false)
+                            : network->LoadFromFile(_filename);
+    if (!loaded) {
+        delete network;
+        return false;
+    }
+
+    // publish it, then free the old version once no reader can still be using it
+    const NeuralNetwork* old = _current.exchange(network, std::memory_order_seq_cst);
+    _version.fetch_add(1, std::memory_order_release);
+    if (old != nullptr) {
+        WaitForReaders();
+        delete old;
+    }
+    return true;
+}
+
+void ModelHotReloader::WaitForReaders() {
+    // flipping twice guarantees that both counters have drained once since the pointer swap,
+    // which covers readers that registered just before a flip
+    for (int flip = 0; flip < 2; ++flip) {
+        const std::uint32_t previousPhase = _phase.fetch_add(1, std::memory_order_seq_cst) & 1;
+        while (_readers[previousPhase].load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+ModelHotReloader::ReadGuard ModelHotReloader::Acquire() const {
+    const std::uint32_t phase = _phase.load(std::memory_order_seq_cst) & 1;
+    _readers[phase].fetch_add(1, std::memory_order_seq_cst);
+    return {_current.load(std::memory_order_seq_cst), &_readers[phase]};
+}
+
+Eigen::Vector<double, Eigen::Dynamic> ModelHotReloader::FeedForward(
+    const Eigen::Vector<double, Eigen::Dynamic>& inputs) const {
+    const ReadGuard guard = Acquire();
+    if (guard.Get() == nullptr) { throw std::runtime_error("No model loaded from " + _filename); }
+    return guard->FeedForward(inputs);
+}
+
+void ModelHotReloader::Watch() {
+    std::unique_lock lock(_stopMutex);
+    while (!_stopCondition.wait_for(lock, _pollInterval, [this] { return _stopRequested; })) {
+        lock.unlock();
+
+        // only reload when the file has changed since the last attempt
+        std::error_code error{};
+        const auto writeTime = std::filesystem::last_write_time(_filename, error);
+        const auto fileSize = error ? 0 : std::filesystem::file_size(_filename, error);
+        bool changed{};
+        if (!error) {
+            std::lock_guard reloadLock(_reloadMutex);
+            changed = writeTime != _lastWriteTime || fileSize != _lastFileSize;
+        }
+        if (changed) { Reload(); }
+
+        lock.lock();
+    }
+}
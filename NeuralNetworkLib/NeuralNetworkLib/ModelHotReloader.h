@@ -0,0 +1,152 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ModelHotReloader.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : watches a model file and swaps in new versions without blocking inference
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef MODELHOTRELOADER_H
+#define MODELHOTRELOADER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "NeuralNetwork.h"
+
+/**
+ * \brief Enum class to represent the file formats a model can be saved in
+ */
+enum class EModelFileFormat : uint8_t {
+    TEXT, // written by NeuralNetwork::SaveToFile
+    BINARY // written by NeuralNetwork::SaveToBinaryFile
+};
+
+/**
+ * \brief Keeps the latest version of a model file loaded.
+ *
+ * A background thread polls the file and loads new versions off the inference path. A new version is published
+ * with an atomic pointer swap, and the old one is freed RCU-style once every reader that could still see it has
+ * released it. Readers only touch two atomic counters, so FeedForward never takes a lock.
+ *
+ * Writers should save to a temporary file and rename it over the watched path, as SaveToFile and
+ * SaveToBinaryFile do. A file that fails to load,
+ * e.g. because it was caught half-written, is skipped and the current version stays published.
+ */
+class ModelHotReloader {
+private:
+    std::string _filename{};
+    EModelFileFormat _fileFormat{};
+    std::chrono::milliseconds _pollInterval{};
+
+    std::atomic<const NeuralNetwork*> _current{};
+    std::atomic<std::uint64_t> _version{};
+
+    // readers register in the counter of the current phase, a grace period flips the phase twice
+    // and waits for the counter of the phase it left to drain each time
+    std::atomic<std::uint32_t> _phase{};
+    mutable std::atomic<std::int64_t> _readers[2]{};
+
+    std::mutex _reloadMutex{}; // serialises writers only
+    std::filesystem::file_time_type _lastWriteTime{};
+    std::uintmax_t _lastFileSize{};
+
+    std::mutex _stopMutex{};
+    std::condition_variable _stopCondition{};
+    bool _stopRequested{};
+    std::thread _watcher{};
+
+    /**
+     * \brief background loop polling the model file
+     */
+    void Watch();
+
+    /**
+     * \brief wait until no reader can still hold a pointer published before the call
+     */
+    void WaitForReaders();
+
+public:
+    /**
+     * \brief Scoped read access to the currently published network, keeps it alive until destroyed
+     */
+    class ReadGuard {
+    private:
+        const NeuralNetwork* _network{};
+        std::atomic<std::int64_t>* _readers{};
+
+    public:
+        ReadGuard(const NeuralNetwork* network, std::atomic<std::int64_t>* readers) : _network(network),
+            _readers(readers) {}
+
+        ~ReadGuard() { if (_readers != nullptr) { _readers->fetch_sub(1, std::memory_order_release); } }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        ReadGuard(ReadGuard&& other) noexcept : _network(other._network), _readers(other._readers) {
+            other._readers = nullptr;
+        }
+
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        /**
+         * \brief get the network, null if no version has been loaded yet
+         * \return published network
+         */
+        [[nodiscard]] const NeuralNetwork* Get() const { return _network; }
+        const NeuralNetwork* operator->() const { return _network; }
+    };
+
+    /**
+     * \brief load the model and start watching it for changes
+     * \param filename model file to watch
+     * \param fileFormat format the model file is saved in
+     * \param pollInterval how often the file is checked for changes
+     */
+    explicit ModelHotReloader(std::string filename, EModelFileFormat fileFormat = EModelFileFormat::TEXT,
+                              std::chrono::milliseconds pollInterval = std::chrono::milliseconds(500));
+
+    /**
+     * \brief stop watching and free the published network, no ReadGuard may outlive the reloader
+     */
+    ~ModelHotReloader();
+
+    ModelHotReloader(const ModelHotReloader&) = delete;
+    ModelHotReloader& operator=(const ModelHotReloader&) = delete;
+
+    /**
+     * \brief load the model file now and publish it if it loads
+     * \return true if a new version was published
+     */
+    bool Reload();
+
+    /**
+     * \brief get read access to the currently published network
+     * \return guard keeping the network alive
+     */
+    [[nodiscard]] ReadGuard Acquire() const;
+
+    /**
+     * \brief feed forward the inputs through the currently published network
+     * \param inputs input vector
+     * \return output vector
+     */
+    [[nodiscard]] Eigen::Vector<double, Eigen::Dynamic> FeedForward(
+        const Eigen::Vector<double, Eigen::Dynamic>& inputs) const;
+
+    /**
+     * \brief get the number of versions published so far
+     * \return version counter, 0 if nothing has loaded yet
+     */
+    [[nodiscard]] std::uint64_t GetVersion() const { return _version.load(std::memory_order_acquire); }
+};
+#endif // MODELHOTRELOADER_H
@@ -0,0 +1,260 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NetworkEnsemble.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "NetworkEnsemble.h"
+
+#include <stdexcept>
+
+namespace {
+    std::vector<NeuralNetwork> CreateMembers(const int numInputs, const int numOutputs, const int numHiddenLayers,
+                                             const int numNeuronsPerHiddenLayer, const double learningRate,
+                                             const int numMembers) {
+        if (numMembers <= 0) { throw std::invalid_argument("Ensemble size must be positive"); }
+
+        std::vector<NeuralNetwork> members{};
+        members.reserve(numMembers);
+        for (int m = 0; m < numMembers; ++m) {
+            members.emplace_back(numInputs, numOutputs, numHiddenLayers, numNeuronsPerHiddenLayer, learningRate);
+        }
+        return members;
+    }
+}
+
+NetworkEnsemble::NetworkEnsemble(const int numInputs, const int numOutputs, const int numHiddenLayers,
+                                 const int numNeuronsPerHiddenLayer, const double learningRate,
+                                 const int numMembers) :
+    NetworkEnsemble(CreateMembers(numInputs, numOutputs, numHiddenLayers, numNeuronsPerHiddenLayer, learningRate,
+                                  numMembers)) {}
+
+NetworkEnsemble::NetworkEnsemble(const std::vector<NeuralNetwork>& members) {
+    if (members.empty()) { throw std::invalid_argument("Ensemble size must be positive"); }
+
+    _prototype = members.front();
+    _numMembers = static_cast<int>(members.size());
+    _learningRate = _prototype.GetLearningRate();
+
+    Eigen::Index offset{};
+    for (const auto& layer : _prototype.GetLayers()) {
+        _layerShapes.push_back({layer.numNeurons, layer.numNeuronInputs, offset});
+        offset += NeuronLayer::NumParameters(layer.numNeurons, layer.numNeuronInputs);
+    }
+
+    _parameters.resize(offset, _numMembers);
+    for (int m = 0; m < _numMembers; ++m) {
+        const auto& layers = members[m].GetLayers();
+        bool sameTopology = layers.size() == _layerShapes.size();
+        for (std::size_t l = 0; sameTopology && l < layers.size(); ++l) {
+            sameTopology = layers[l].numNeurons == _layerShapes[l].numNeurons &&
+                layers[l].numNeuronInputs == _layerShapes[l].numNeuronInputs;
+        }
+        if (!sameTopology) { throw std::invalid_argument("Ensemble members must share one topology"); }
+        _parameters.col(m) = members[m].GetParameters();
+    }
+}
+
+void NetworkEnsemble::SetHiddenActivationFunction(const EActivationFunction activationFunction) {
+    _prototype.SetHiddenActivationFunction(activationFunction);
+}
+
+void NetworkEnsemble::SetOutputActivationFunction(const EActivationFunction activationFunction) {
+    _prototype.SetOutputActivationFunction(activationFunction);
+}
+
+void NetworkEnsemble::CopyToNetwork(const int member, NeuralNetwork& network) const {
+    network.GetParameters() = _parameters.col(member);
+}
+
+NeuralNetwork NetworkEnsemble::GetMember(const int member) const {
+    NeuralNetwork network = _prototype;
+    CopyToNetwork(member, network);
+    return network;
+}
+
+void NetworkEnsemble::FeedForward(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
+                                  std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>>& netOutputs,
+                                  std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>>& activations)
+const {
+    const Eigen::Index numMembers = _numMembers;
+    const auto numLayers = static_cast<int>(_layerShapes.size());
+    netOutputs.resize(numLayers);
+    activations.resize(numLayers);
+
+    for (int l = 0; l < numLayers; ++l) {
+        const auto& shape = _layerShapes[l];
+        const double* layerData = _parameters.data() + shape.offset * numMembers;
+        const Eigen::Map<const Eigen::MatrixXd> biases(
+            layerData + static_cast<Eigen::Index>(shape.numNeurons) * shape.numNeuronInputs * numMembers,
+            numMembers, shape.numNeurons);
+        auto& outputs = netOutputs[l];
+        outputs.resize(numMembers, shape.numNeurons);
+
+        if (l == 0) {
+            // the input is shared, so the first layer of every member is one stacked matrix-vector product
+            const Eigen::Map<const Eigen::MatrixXd> stackedWeights(layerData, shape.numNeurons * numMembers,
+                                                                   shape.numNeuronInputs);
+            Eigen::Map<Eigen::VectorXd>(outputs.data(), outputs.size()).noalias() = stackedWeights * inputs;
+            outputs += biases;
+        }
+        else {
+            // the weights from input neuron c of every member form one members x neurons block
+            const auto& layerInputs = activations[l - 1];
+            outputs = biases;
+            for (int c = 0; c < shape.numNeuronInputs; ++c) {
+                const Eigen::Map<const Eigen::MatrixXd> weights(layerData + c * shape.numNeurons * numMembers,
+                                                                numMembers, shape.numNeurons);
+                outputs.array() += weights.array().colwise() * layerInputs.col(c).array();
+            }
+        }
+
+        activations[l] = outputs;
+        NeuronLayer::ApplyActivationFunction(activations[l], l == numLayers - 1
+                                                                 ? _prototype.GetOutputActivationFunction()
+                                                                 : _prototype.GetHiddenActivationFunction());
+    }
+}
+
+Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> NetworkEnsemble::FeedForward(
+    const Eigen::Vector<double, Eigen::Dynamic>& inputs) const {
+    std::vector<Eigen::MatrixXd> netOutputs{};
+    std::vector<Eigen::MatrixXd> activations{};
+    FeedForward(inputs, netOutputs, activations);
+    return activations.back().transpose();
+}
+
+Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> NetworkEnsemble::FeedForwardBatch(
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs) const {
+    const Eigen::Index numMembers = _numMembers;
+    const auto numLayers = static_cast<int>(_layerShapes.size());
+    Eigen::MatrixXd activations{};
+
+    for (int l = 0; l < numLayers; ++l) {
+        const auto& shape = _layerShapes[l];
+        const Eigen::Index numRows = shape.numNeurons * numMembers;
+        const double* layerData = _parameters.data() + shape.offset * numMembers;
+        const double* biasData = layerData + static_cast<Eigen::Index>(shape.numNeurons) * shape.numNeuronInputs *
+            numMembers;
+        Eigen::MatrixXd layerOutputs(numRows, inputs.cols());
+
+        if (l == 0) {
+            const Eigen::Map<const Eigen::MatrixXd> stackedWeights(layerData, numRows, shape.numNeuronInputs);
+            layerOutputs.noalias() = stackedWeights * inputs;
+            layerOutputs.colwise() += Eigen::Map<const Eigen::VectorXd>(biasData, numRows);
+        }
+        else {
+            // every column of the interleaved activations is a members x neurons matrix of one sample
+            for (Eigen::Index s = 0; s < inputs.cols(); ++s) {
+                Eigen::Map<Eigen::MatrixXd> outputs(layerOutputs.col(s).data(), numMembers, shape.numNeurons);
+                const Eigen::Map<const Eigen::MatrixXd> layerInputs(activations.col(s).data(), numMembers,
+                                                                    shape.numNeuronInputs);
+                outputs = Eigen::Map<const Eigen::MatrixXd>(biasData, numMembers, shape.numNeurons);
+                for (int c = 0; c < shape.numNeuronInputs; ++c) {
+                    const Eigen::Map<const Eigen::MatrixXd> weights(layerData + c * shape.numNeurons * numMembers,
+                                                                    numMembers, shape.numNeurons);
+                    outputs.array() += weights.array().colwise() * layerInputs.col(c).array();
+                }
+            }
+        }
+
+        NeuronLayer::ApplyActivationFunction(layerOutputs, l == numLayers - 1
+                                                               ? _prototype.GetOutputActivationFunction()
+                                                               : _prototype.GetHiddenActivationFunction());
+        activations = std::move(layerOutputs);
+    }
+    return activations;
+}
+
+EnsembleStatistics NetworkEnsemble::Predict(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs) const {
+    return Reduce(FeedForwardBatch(inputs), _numMembers);
+}
+
+EnsembleStatistics NetworkEnsemble::Reduce(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& memberOutputs,
+                                           const int numMembers) {
+    if (numMembers <= 0 || memberOutputs.rows() % numMembers != 0) {
+        throw std::invalid_argument("Member outputs do not match the number of members");
+    }
+
+    const Eigen::Index numOutputs = memberOutputs.rows() / numMembers;
+    EnsembleStatistics statistics{};
+    statistics.mean.resize(numOutputs, memberOutputs.cols());
+    statistics.variance.resize(numOutputs, memberOutputs.cols());
+
+    for (Eigen::Index s = 0; s < memberOutputs.cols(); ++s) {
+        const Eigen::Map<const Eigen::MatrixXd> outputs(memberOutputs.col(s).data(), numMembers, numOutputs);
+        statistics.mean.col(s) = outputs.colwise().mean().transpose();
+        statistics.variance.col(s) = (outputs.rowwise() - statistics.mean.col(s).transpose()).colwise().
+            squaredNorm().transpose() / static_cast<double>(numMembers);
+    }
+    return statistics;
+}
+
+Eigen::Vector<double, Eigen::Dynamic> NetworkEnsemble::BackPropagate(
+    const Eigen::Vector<double, Eigen::Dynamic>& inputs, const Eigen::Vector<double, Eigen::Dynamic>& targets) {
+    const Eigen::Index numMembers = _numMembers;
+    const auto numLayers = static_cast<int>(_layerShapes.size());
+    FeedForward(inputs, _netOutputs, _activations);
+
+    // members x outputs errors and the mean square error of every member
+    const Eigen::MatrixXd outputErrors = targets.transpose().replicate(numMembers, 1) - _activations.back();
+    const Eigen::VectorXd meanSquareErrors = 0.5 * outputErrors.rowwise().squaredNorm() / static_cast<double>(
+        targets.size());
+
+    // neuron deltas, the net outputs are overwritten with the activation derivatives as they are no longer needed
+    _neuronDeltas.resize(numLayers);
+    NeuronLayer::ApplyActivationFunctionDerivative(_netOutputs.back(), _prototype.GetOutputActivationFunction());
+    _neuronDeltas.back() = outputErrors.cwiseProduct(_netOutputs.back());
+    for (int i = numLayers - 2; i >= 0; --i) {
+        const auto& next = _layerShapes[i + 1];
+        const double* nextData = _parameters.data() + next.offset * numMembers;
+        auto& deltas = _neuronDeltas[i];
+        deltas.resize(numMembers, _layerShapes[i].numNeurons);
+
+        // transposed weights times the deltas of the next layer, one row-wise reduction per neuron
+        for (int c = 0; c < next.numNeuronInputs; ++c) {
+            const Eigen::Map<const Eigen::MatrixXd> weights(nextData + c * next.numNeurons * numMembers,
+                                                            numMembers, next.numNeurons);
+            deltas.col(c) = (weights.array() * _neuronDeltas[i + 1].array()).rowwise().sum();
+        }
+        NeuronLayer::ApplyActivationFunctionDerivative(_netOutputs[i], _prototype.GetHiddenActivationFunction());
+        deltas.array() *= _netOutputs[i].array();
+    }
+
+    // update every member with the outer products of its deltas and its layer inputs; like
+    // NeuralNetwork::CalcGradients, the output layer uses the raw errors
+    for (int i = 0; i < numLayers; ++i) {
+        const auto& shape = _layerShapes[i];
+        double* layerData = _parameters.data() + shape.offset * numMembers;
+        const Eigen::MatrixXd& gradients = i == numLayers - 1 ? outputErrors : _neuronDeltas[i];
+
+        for (int c = 0; c < shape.numNeuronInputs; ++c) {
+            Eigen::Map<Eigen::MatrixXd> weights(layerData + c * shape.numNeurons * numMembers, numMembers,
+                                                shape.numNeurons);
+            if (i == 0) { weights += _learningRate * inputs[c] * gradients; }
+            else {
+                weights.array() += _learningRate * (gradients.array().colwise() *
+                    _activations[i - 1].col(c).array());
+            }
+        }
+        Eigen::Map<Eigen::MatrixXd>(layerData + static_cast<Eigen::Index>(shape.numNeurons) * shape.numNeuronInputs *
+                                    numMembers, numMembers, shape.numNeurons) += _learningRate * gradients;
+    }
+
+    return meanSquareErrors;
+}
+
+Eigen::Vector<double, Eigen::Dynamic> NetworkEnsemble::TrainEpoch(
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets) {
+    Eigen::VectorXd meanSquareErrors = Eigen::VectorXd::Zero(_numMembers);
+    for (Eigen::Index j = 0; j < inputs.cols(); ++j) {
+        meanSquareErrors += BackPropagate(inputs.col(j), targets.col(j));
+    }
+    return meanSquareErrors;
+}
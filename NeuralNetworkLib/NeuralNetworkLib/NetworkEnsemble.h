@@ -0,0 +1,160 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NetworkEnsemble.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : ensemble of same-topology networks trained and evaluated with batched kernels
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef NETWORKENSEMBLE_H
+#define NETWORKENSEMBLE_H
+
+#include <vector>
+
+#include "NeuralNetwork.h"
+
+/**
+ * \brief Mean and variance of the outputs of the members of an ensemble
+ */
+struct EnsembleStatistics {
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> mean{}; // numOutputs x number of samples
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> variance{}; // across members, divided by their number
+};
+
+/**
+ * \brief Ensemble of networks sharing one topology, trained together on the same samples.
+ *
+ * The parameters of the members are interleaved the same way as in NeuroevolutionPopulation: row k of the
+ * parameter matrix holds parameter k of every member. The first layer of the whole ensemble is then one stacked
+ * matrix-vector product over the shared input, and for every other layer the weights connecting one input neuron
+ * are a contiguous members x neurons block, so each layer of every member advances with one vectorized
+ * multiply-add per input neuron instead of one tiny matrix-vector product per member. Back propagation runs on the
+ * same layout and gives every member exactly the update NeuralNetwork::BackPropagate would.
+ */
+class NetworkEnsemble {
+private:
+    struct LayerShape {
+        int numNeurons;
+        int numNeuronInputs;
+        Eigen::Index offset; // index of the first weight in the parameter vector
+    };
+
+    using ParameterMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    NeuralNetwork _prototype{};
+    std::vector<LayerShape> _layerShapes{};
+    int _numMembers{};
+    double _learningRate{};
+
+    ParameterMatrix _parameters{}; // numParameters x numMembers
+
+    // members x neurons scratch of the last training sample, net outputs and activated outputs per layer
+    std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> _netOutputs{};
+    std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> _activations{};
+    std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> _neuronDeltas{};
+
+    /**
+     * \brief feed one sample through every member
+     * \param inputs input vector shared by the members
+     * \param netOutputs receives the members x neurons net outputs of every layer
+     * \param activations receives the members x neurons activated outputs of every layer
+     */
+    void FeedForward(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
+                     std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>>& netOutputs,
+                     std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>>& activations) const;
+
+public:
+    /**
+     * \brief create an ensemble of randomly initialised members
+     * \param numInputs number of inputs
+     * \param numOutputs number of outputs
+     * \param numHiddenLayers number of hidden layers
+     * \param numNeuronsPerHiddenLayer number of neurons per hidden layer
+     * \param learningRate learning rate of every member
+     * \param numMembers number of members
+     */
+    NetworkEnsemble(int numInputs, int numOutputs, int numHiddenLayers, int numNeuronsPerHiddenLayer,
+                    double learningRate, int numMembers);
+
+    /**
+     * \brief create an ensemble from existing networks
+     * \param members networks with the same topology, the activation functions and learning rate of the first
+     *  one are used for all of them
+     */
+    explicit NetworkEnsemble(const std::vector<NeuralNetwork>& members);
+
+    void SetHiddenActivationFunction(EActivationFunction activationFunction);
+    void SetOutputActivationFunction(EActivationFunction activationFunction);
+
+    [[nodiscard]] int GetNumMembers() const { return _numMembers; }
+    [[nodiscard]] int GetNumInputs() const { return _prototype.GetNumInputs(); }
+    [[nodiscard]] int GetNumOutputs() const { return _prototype.GetNumOutputs(); }
+
+    /**
+     * \brief copy the parameters of a member into a network with the same topology
+     * \param member index of the member
+     * \param network network to overwrite
+     */
+    void CopyToNetwork(int member, NeuralNetwork& network) const;
+
+    /**
+     * \brief get a member as a standalone network
+     * \param member index of the member
+     * \return copy of the member
+     */
+    [[nodiscard]] NeuralNetwork GetMember(int member) const;
+
+    /**
+     * \brief feed one sample through every member
+     * \param inputs input vector
+     * \return numOutputs x numMembers matrix with the outputs of one member per column
+     */
+    [[nodiscard]] Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> FeedForward(
+        const Eigen::Vector<double, Eigen::Dynamic>& inputs) const;
+
+    /**
+     * \brief feed a batch of samples through every member
+     * \param inputs matrix with one input vector per column
+     * \return interleaved outputs, row j * numMembers + m holds output j of member m, one column per sample
+     */
+    [[nodiscard]] Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> FeedForwardBatch(
+        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs) const;
+
+    /**
+     * \brief reduce the member outputs of a batch to their mean and variance
+     * \param inputs matrix with one input vector per column
+     * \return mean and variance of every output and sample
+     */
+    [[nodiscard]] EnsembleStatistics Predict(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs) const;
+
+    /**
+     * \brief reduce interleaved member outputs, as returned by FeedForwardBatch, to their mean and variance
+     * \param memberOutputs interleaved outputs, (numOutputs * numMembers) x number of samples
+     * \param numMembers number of members
+     * \return mean and variance of every output and sample
+     */
+    static EnsembleStatistics Reduce(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& memberOutputs,
+                                     int numMembers);
+
+    /**
+     * \brief back propagate the error of one sample through every member and update them
+     * \param inputs vector of inputs
+     * \param targets vector of targets
+     * \return half the mean square error of the sample for every member
+     */
+    Eigen::Vector<double, Eigen::Dynamic> BackPropagate(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
+                                                        const Eigen::Vector<double, Eigen::Dynamic>& targets);
+
+    /**
+     * \brief train every member for one epoch over samples stored as matrix columns
+     * \param inputs matrix with one input vector per column
+     * \param targets matrix with one target vector per column
+     * \return sum of the mean square errors of the samples for every member
+     */
+    Eigen::Vector<double, Eigen::Dynamic> TrainEpoch(
+        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets);
+};
+#endif // NETWORKENSEMBLE_H
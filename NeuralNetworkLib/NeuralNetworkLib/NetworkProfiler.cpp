@@ -0,0 +1,119 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NetworkProfiler.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "NetworkProfiler.h"
+
+#include <algorithm>
+
+#include "NeuronLayer.h"
+
+NetworkProfiler::NetworkProfiler(const unsigned samplingInterval) :
+    _samplingInterval(std::max(1u, samplingInterval)) {}
+
+NetworkProfiler::NetworkProfiler(NetworkProfiler&& other) noexcept { *this = std::move(other); }
+
+NetworkProfiler& NetworkProfiler::operator=(NetworkProfiler&& other) noexcept {
+    if (this != &other) {
+        _samplingInterval = other._samplingInterval;
+        _shapes = std::move(other._shapes);
+        _layers = std::move(other._layers);
+        for (int p = 0; p < numProfilePhases; ++p) {
+            _phases[p].calls.store(other._phases[p].calls.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            _phases[p].samples.store(other._phases[p].samples.load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+        }
+    }
+    return *this;
+}
+
+void NetworkProfiler::Reset(const std::vector<NeuronLayer>& layers) {
+    _shapes.clear();
+    for (const NeuronLayer& layer : layers) { _shapes.push_back({layer.numNeurons, layer.numNeuronInputs}); }
+    _layers = std::make_unique<LayerCounters[]>(_shapes.size() * numProfilePhases);
+    for (PhaseCounters& phase : _phases) {
+        phase.calls.store(0, std::memory_order_relaxed);
+        phase.samples.store(0, std::memory_order_relaxed);
+    }
+}
+
+NetworkProfiler* NetworkProfiler::BeginPass(const EProfilePhase phase, const int numSamples, const bool exclusive) {
+    PhaseCounters& counters = _phases[static_cast<int>(phase)];
+    std::uint64_t calls{};
+    if (exclusive) {
+        // plain loads and stores, a locked addition would cost more than a small layer
+        calls = counters.calls.load(std::memory_order_relaxed);
+        counters.calls.store(calls + 1, std::memory_order_relaxed);
+        counters.samples.store(counters.samples.load(std::memory_order_relaxed) + numSamples,
+                               std::memory_order_relaxed);
+    }
+    else {
+        calls = counters.calls.fetch_add(1, std::memory_order_relaxed);
+        counters.samples.fetch_add(numSamples, std::memory_order_relaxed);
+    }
+    return calls % _samplingInterval == 0 ? this : nullptr;
+}
+
+void NetworkProfiler::AddTime(const EProfilePhase phase, const int layer, const int numSamples,
+                              const std::chrono::steady_clock::duration time) {
+    LayerCounters& counters = _layers[static_cast<std::size_t>(layer) * numProfilePhases + static_cast<int>(phase)];
+    counters.timedSamples.fetch_add(numSamples, std::memory_order_relaxed);
+    counters.timedNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+                                        std::memory_order_relaxed);
+}
+
+std::vector<LayerProfile> NetworkProfiler::GetProfile() const {
+    const auto numLayers = static_cast<int>(_shapes.size());
+    std::vector<LayerProfile> profiles(numLayers);
+    for (int i = 0; i < numLayers; ++i) {
+        const double n = _shapes[i].numNeurons;
+        const double m = _shapes[i].numNeuronInputs;
+        const double weights = n * m;
+        const double nextNeurons = i + 1 < numLayers ? _shapes[i + 1].numNeurons : 0.0;
+        const double nextWeights = nextNeurons * n;
+
+        for (int p = 0; p < numProfilePhases; ++p) {
+            PhaseProfile& profile = profiles[i].phases[p];
+            profile.calls = _phases[p].calls.load(std::memory_order_relaxed);
+            profile.samples = _phases[p].samples.load(std::memory_order_relaxed);
+
+            const LayerCounters& counters = _layers[static_cast<std::size_t>(i) * numProfilePhases + p];
+            const auto timedSamples = counters.timedSamples.load(std::memory_order_relaxed);
+            if (timedSamples > 0) {
+                profile.seconds = 1e-9 * static_cast<double>(counters.timedNanoseconds.load(std::memory_order_relaxed))
+                    * static_cast<double>(profile.samples) / static_cast<double>(timedSamples);
+            }
+
+            // per sample, except that a batch reads the parameters once
+            const auto calls = static_cast<double>(profile.calls);
+            const auto samples = static_cast<double>(profile.samples);
+            switch (static_cast<EProfilePhase>(p)) {
+            case EProfilePhase::FORWARD:
+                profile.flops = samples * (2.0 * weights + n);
+                profile.bytes = 8.0 * (calls * (weights + n) + samples * (m + n));
+                break;
+            case EProfilePhase::DELTAS:
+                // the deltas of a hidden layer come from the weights of the layer above
+                profile.flops = samples * (2.0 * nextWeights + n);
+                profile.bytes = 8.0 * samples * (nextWeights + nextNeurons + 2.0 * n);
+                break;
+            case EProfilePhase::GRADIENTS:
+                profile.flops = samples * weights;
+                profile.bytes = 8.0 * samples * (weights + 2.0 * n + m);
+                break;
+            case EProfilePhase::UPDATE:
+                profile.flops = samples * 2.0 * (weights + n);
+                profile.bytes = 8.0 * samples * 3.0 * (weights + n);
+                break;
+            }
+        }
+    }
+    return profiles;
+}
@@ -0,0 +1,167 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NetworkProfiler.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : per-layer time, call, FLOP and byte counters, compiled in with NNL_ENABLE_PROFILING
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef NETWORKPROFILER_H
+#define NETWORKPROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class NeuronLayer;
+
+/**
+ * \brief Enum class to represent the phases of training and inference that are profiled per layer
+ */
+enum class EProfilePhase : uint8_t {
+    FORWARD, // CalcOutputs, FeedForward and FeedForwardBatch, including the forward pass of BackPropagate
+    DELTAS, // neuron deltas of BackPropagate and CalcGradients
+    GRADIENTS, // weight and bias gradients of BackPropagate and CalcGradients
+    UPDATE // UpdateWeightsAndBiases
+};
+
+constexpr int numProfilePhases = 4;
+
+/**
+ * \brief Totals of one phase of one layer
+ */
+struct PhaseProfile {
+    std::uint64_t calls{}; // passes through the layer, a batch counts once
+    std::uint64_t samples{}; // samples processed, equal to calls except for batches
+    double seconds{}; // wall time, estimated from the timed calls
+    double flops{}; // floating-point operations, from the layer shape
+    double bytes{}; // bytes of parameters and activations read and written, from the layer shape
+};
+
+/**
+ * \brief Totals of every phase of one layer
+ */
+struct LayerProfile {
+    std::array<PhaseProfile, numProfilePhases> phases{};
+
+    [[nodiscard]] const PhaseProfile& operator[](EProfilePhase phase) const {
+        return phases[static_cast<int>(phase)];
+    }
+};
+
+/**
+ * \brief Counts calls, time, FLOPs and bytes per layer and phase for a NeuralNetwork built with
+ *  NNL_ENABLE_PROFILING defined, which must then be defined for every file including NeuralNetwork.h.
+ *
+ * Calls and samples are counted exactly, FLOPs and bytes follow from them and the layer shapes. Only one pass in
+ * every samplingInterval is timed, and the time of the others is extrapolated per sample, which keeps the
+ * overhead under 1% even for layers that take a few hundred nanoseconds. Without NNL_ENABLE_PROFILING the
+ * network holds no profiler and records nothing.
+ */
+class NetworkProfiler {
+private:
+    struct PhaseCounters {
+        std::atomic<std::uint64_t> calls{};
+        std::atomic<std::uint64_t> samples{};
+    };
+
+    struct LayerCounters {
+        std::atomic<std::uint64_t> timedSamples{};
+        std::atomic<std::uint64_t> timedNanoseconds{};
+    };
+
+    struct LayerShape {
+        int numNeurons{};
+        int numNeuronInputs{};
+    };
+
+    std::uint64_t _samplingInterval{};
+    std::vector<LayerShape> _shapes{};
+    std::array<PhaseCounters, numProfilePhases> _phases{};
+    std::unique_ptr<LayerCounters[]> _layers{}; // numProfilePhases entries per layer
+
+public:
+    /**
+     * \brief Times one layer of a timed pass and adds the time when it goes out of scope
+     */
+    class Timer {
+    private:
+        NetworkProfiler* _profiler{};
+        EProfilePhase _phase{};
+        int _layer{};
+        int _numSamples{};
+        std::chrono::steady_clock::time_point _start{};
+
+    public:
+        /**
+         * \brief start timing if the pass is timed
+         * \param profiler profiler to add to, or nullptr if the pass isn't timed
+         */
+        Timer(NetworkProfiler* profiler, const EProfilePhase phase, const int layer, const int numSamples) :
+            _profiler(profiler), _phase(phase), _layer(layer), _numSamples(numSamples) {
+            if (_profiler != nullptr) { _start = std::chrono::steady_clock::now(); }
+        }
+
+        ~Timer() {
+            if (_profiler != nullptr) {
+                _profiler->AddTime(_phase, _layer, _numSamples, std::chrono::steady_clock::now() - _start);
+            }
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+    };
+
+    /**
+     * \brief create a profiler without layers
+     * \param samplingInterval one pass in this many is timed
+     */
+    explicit NetworkProfiler(unsigned samplingInterval = 64);
+
+    NetworkProfiler(NetworkProfiler&& other) noexcept;
+    NetworkProfiler& operator=(NetworkProfiler&& other) noexcept;
+
+    /**
+     * \brief size the profiler for a network and clear the counters
+     * \param layers layers of the network
+     */
+    void Reset(const std::vector<NeuronLayer>& layers);
+
+    /**
+     * \brief count a pass of a phase through every layer
+     * \param phase phase of the pass
+     * \param numSamples samples in the pass
+     * \param exclusive true if no other thread can count at the same time, which avoids atomic additions
+     * \return this profiler if the pass is to be timed, nullptr otherwise
+     */
+    NetworkProfiler* BeginPass(EProfilePhase phase, int numSamples, bool exclusive);
+
+    /**
+     * \brief add the time of one layer of a timed pass
+     */
+    void AddTime(EProfilePhase phase, int layer, int numSamples, std::chrono::steady_clock::duration time);
+
+    /**
+     * \brief get the totals of every layer
+     * \return one profile per layer, the last one being the output layer
+     */
+    [[nodiscard]] std::vector<LayerProfile> GetProfile() const;
+};
+
+#ifdef NNL_ENABLE_PROFILING
+// count a pass of a phase, declaring the profiler of the pass as name, nullptr unless the pass is timed
+#define NNL_PROFILE_PASS(name, phase, numSamples, exclusive) \
+    NetworkProfiler* const name = _profiler.BeginPass(phase, numSamples, exclusive)
+// time a layer until the end of the enclosing scope, if the pass is timed
+#define NNL_PROFILE_LAYER(pass, phase, layer, numSamples) \
+    const NetworkProfiler::Timer nnlProfileTimer(pass, phase, layer, numSamples)
+#else
+#define NNL_PROFILE_PASS(name, phase, numSamples, exclusive) static_cast<void>(0)
+#define NNL_PROFILE_LAYER(pass, phase, layer, numSamples) static_cast<void>(0)
+#endif
+#endif // NETWORKPROFILER_H
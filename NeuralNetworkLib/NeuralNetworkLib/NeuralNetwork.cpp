@@ -4,14 +4,143 @@
 // //FileType: Visual C++ Source file
 // //Author : Anders P. Åsbø
 // //Created On : 22/2/2024
-// //Last Modified On : 22/2/2024
+// //Last Modified On : 19/10/2026
 // //Description :
 // //////////////////////////////////////////////////////////////////////////
 // //////////////////////////////
 
 #include "NeuralNetwork.h"
+#include "AllocationTracker.h"
+#include "AtomicFile.h"
+#include "MappedFile.h"
+#include "SimdKernels.h"
+#include "ThreadTeam.h"
+#include "Tracer.h"
+#include "TrainingCheckpointer.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
+
+namespace {
+    /**
+     * \brief append a number followed by a separator using the shortest representation that round-trips exactly
+     * \param text buffer to append to
+     * \param value number to format
+     * \param separator character written after the number
+     */
+    template <typename T>
+    void AppendNumber(std::string& text, const T value, const char separator) {
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        text.append(buffer, result.ptr);
+        text += separator;
+    }
+
+    /**
+     * \brief locale-independent reader of whitespace separated numbers in an in-memory buffer
+     */
+    class TextModelReader {
+    private:
+        const char* _current{};
+        const char* _end{};
+
+    public:
+        TextModelReader(const char* begin, const char* end) : _current(begin), _end(end) {}
+
+        /**
+         * \brief read the next number
+         * \param value receives the number
+         * \return false if the buffer is exhausted or the next token is not a number
+         */
+        template <typename T>
+        bool Read(T& value) {
+            while (_current != _end && std::isspace(static_cast<unsigned char>(*_current))) { ++_current; }
+            const auto result = std::from_chars(_current, _end, value);
+            if (result.ec != std::errc{}) { return false; }
+            _current = result.ptr;
+            return true;
+        }
+    };
+
+    // binary model layout (native endianness):
+    // header, one {numNeurons, numNeuronInputs} pair per layer, zero padding up to parametersOffset,
+    // then per layer the column-major weights followed by the biases as doubles
+    constexpr char binaryModelMagic[8] = {'N', 'N', 'L', 'I', 'B', 'B', 'I', 'N'};
+    constexpr std::uint32_t binaryModelVersion = 1;
+    constexpr std::uint64_t binaryModelAlignment = 64;
+
+    struct BinaryModelHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t numLayers;
+        std::int32_t numInputs;
+        std::int32_t numOutputs;
+        std::int32_t numHiddenLayers;
+        std::int32_t numNeuronsPerHiddenLayer;
+        double learningRate;
+        std::uint8_t hiddenActivationFunction;
+        std::uint8_t outputActivationFunction;
+        std::uint8_t reserved[2];
+        std::uint32_t trainedEpochs; // zero in files written before it was recorded
+        std::uint64_t parametersOffset;
+    };
+    static_assert(sizeof(BinaryModelHeader) == 56, "binary model header layout must not change");
+
+    struct BinaryLayerShape {
+        std::int32_t numNeurons;
+        std::int32_t numNeuronInputs;
+    };
+
+    /**
+     * \brief check that a layer is non-empty and its parameters can be counted in an int
+     */
+    bool IsValidLayerShape(const BinaryLayerShape& shape) {
+        return shape.numNeurons > 0 && shape.numNeuronInputs > 0 &&
+            static_cast<std::int64_t>(shape.numNeurons) * shape.numNeuronInputs + shape.numNeurons <=
+            std::numeric_limits<int>::max();
+    }
+
+    /**
+     * \brief check that the layers of a model file chain into the network its header describes, so the kernels
+     *  never read past a layer
+     * \param numInputs inputs of the network
+     * \param numOutputs outputs of the network
+     * \param numHiddenLayers hidden layers of the network
+     * \param numNeuronsPerHiddenLayer neurons of every hidden layer
+     * \param shapes numbers of neurons and inputs of every layer
+     * \return true if there is one layer per hidden layer (at least one, like the constructor builds) plus the
+     *  output layer, the first layer takes the inputs, every other layer takes the outputs of the one before, the
+     *  last layer gives the outputs and all parameters can be counted in an int
+     */
+    bool IsValidTopology(const int numInputs, const int numOutputs, const int numHiddenLayers,
+                         const int numNeuronsPerHiddenLayer, const std::vector<BinaryLayerShape>& shapes) {
+        if (numHiddenLayers < 0 || shapes.size() != static_cast<std::size_t>(std::max(numHiddenLayers, 1)) + 1) {
+            return false;
+        }
+
+        std::int64_t numParameters{};
+        for (std::size_t i = 0; i < shapes.size(); ++i) {
+            const bool isOutputLayer = i == shapes.size() - 1;
+            if (!IsValidLayerShape(shapes[i]) ||
+                shapes[i].numNeuronInputs != (i == 0 ? numInputs : shapes[i - 1].numNeurons) ||
+                shapes[i].numNeurons != (isOutputLayer ? numOutputs : numNeuronsPerHiddenLayer)) {
+                return false;
+            }
+            numParameters += NeuronLayer::NumParameters(shapes[i].numNeurons, shapes[i].numNeuronInputs);
+        }
+        return numParameters <= std::numeric_limits<int>::max();
+    }
+
+    bool IsValidActivationFunction(const int activationFunction) {
+        return activationFunction >= 0 && activationFunction <= static_cast<int>(EActivationFunction::NONE);
+    }
+}
 
 NeuralNetwork::NeuralNetwork(int numInputs, int numOutputs, int numHiddenLayers, int numNeuronsPerHiddenLayer,
                              double learningRate) : _numInputs(numInputs), _numOutputs(numOutputs),
@@ -32,37 +161,283 @@ NeuralNetwork::NeuralNetwork(int numInputs, int numOutputs, int numHiddenLayers,
 
     // Add the output layer
     _layers.emplace_back(_numOutputs, _layers.back().numNeurons);
+
+    AllocateArena();
+}
+
+NeuralNetwork::NeuralNetwork(const NeuralNetwork& other) : _numInputs(other._numInputs),
+                                                           _numOutputs(other._numOutputs),
+                                                           _numHiddenLayers(other._numHiddenLayers),
+                                                           _numNeuronsPerHiddenLayer(other._numNeuronsPerHiddenLayer),
+                                                           _learningRate(other._learningRate),
+                                                           _trainedEpochs(other._trainedEpochs),
+                                                           _layers(other._layers),
+                                                           _neuronDeltas(other._neuronDeltas),
+                                                           _useHugePages(other._useHugePages),
+                                                           _outputActivationFunction(other._outputActivationFunction),
+                                                           _hiddenActivationFunction(other._hiddenActivationFunction),
+                                                           _maxBatchSize(other._maxBatchSize) {
+    // the copied layers own their parameters until they are moved into the new arena
+    AllocateArena();
+}
+
+NeuralNetwork& NeuralNetwork::operator=(const NeuralNetwork& other) {
+    if (this != &other) { *this = NeuralNetwork(other); }
+    return *this;
+}
+
+void NeuralNetwork::AllocateArena(double* externalParameters) {
+    std::size_t numParameters{};
+    for (const auto& layer : _layers) {
+        numParameters += NeuronLayer::NumParameters(layer.numNeurons, layer.numNeuronInputs);
+    }
+
+    // the old arenas stay alive until every layer has been relocated
+    ParameterArena parameters = externalParameters != nullptr
+                                    ? ParameterArena(externalParameters, numParameters)
+                                    : ParameterArena(numParameters, _useHugePages);
+    ParameterArena gradients(numParameters, _useHugePages);
+
+    double* layerParameters = parameters.Data();
+    double* layerGradients = gradients.Data();
+    for (auto& layer : _layers) {
+        if (externalParameters != nullptr) { layer.BindParameters(layerParameters); }
+        else { layer.RelocateParameters(layerParameters); }
+        layer.BindGradients(layerGradients);
+
+        const int numLayerParameters = NeuronLayer::NumParameters(layer.numNeurons, layer.numNeuronInputs);
+        layerParameters += numLayerParameters;
+        layerGradients += numLayerParameters;
+    }
+
+    _parameters = std::move(parameters);
+    _gradients = std::move(gradients);
+    ResetProfile();
+}
+
+std::vector<LayerProfile> NeuralNetwork::GetProfile() const {
+#ifdef NNL_ENABLE_PROFILING
+    return _profiler.GetProfile();
+#else
+    return {};
+#endif
+}
+
+void NeuralNetwork::ResetProfile() {
+#ifdef NNL_ENABLE_PROFILING
+    _profiler.Reset(_layers);
+#endif
+}
+
+void NeuralNetwork::SetUseHugePages(const bool useHugePages) {
+    _useHugePages = useHugePages;
+
+    // a mapped model keeps its parameters in the mapping
+    if (_mappedFile != nullptr) {
+        _gradients = ParameterArena(_gradients.Size(), _useHugePages);
+        double* layerGradients = _gradients.Data();
+        for (auto& layer : _layers) {
+            layer.BindGradients(layerGradients);
+            layerGradients += NeuronLayer::NumParameters(layer.numNeurons, layer.numNeuronInputs);
+        }
+        return;
+    }
+    AllocateArena();
+}
+
+bool NeuralNetwork::IsParallelLayer(const int i) const {
+    return static_cast<long long>(_layers[i].numNeurons) * _layers[i].numNeuronInputs >= _minParallelWeights;
+}
+
+bool NeuralNetwork::UsesThreadTeam() const {
+    if (_threadTeam == nullptr) { return false; }
+    for (int i = 0; i < static_cast<int>(_layers.size()); ++i) {
+        if (IsParallelLayer(i)) { return true; }
+    }
+    return false;
+}
+
+void NeuralNetwork::FeedForwardOnTeam(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
+                                      const std::vector<Eigen::Vector<double, Eigen::Dynamic>*>& activatedOutputs,
+                                      const std::vector<Eigen::Vector<double, Eigen::Dynamic>*>& netOutputs) const {
+    const auto numLayers = static_cast<int>(_layers.size());
+    for (int i = 0; i < numLayers; ++i) {
+        activatedOutputs[i]->resize(_layers[i].numNeurons);
+        if (!netOutputs.empty()) { netOutputs[i]->resize(_layers[i].numNeurons); }
+    }
+
+    // net outputs are only kept by the non-const FeedForward, which never runs concurrently
+    NNL_PROFILE_PASS(pass, EProfilePhase::FORWARD, 1, !netOutputs.empty());
+    _threadTeam->RunOrInline([&](const int member, const int numMembers) {
+        for (int i = 0; i < numLayers; ++i) {
+            NNL_PROFILE_LAYER(member == 0 ? pass : nullptr, EProfilePhase::FORWARD, i, 1);
+            TraceSpan layerSpan("forward", "layer", i);
+            NoAllocationScope noAllocation;
+            const NeuronLayer& layer = _layers[i];
+            const bool parallel = numMembers > 1 && IsParallelLayer(i);
+
+            // each member computes a block of rows of the matrix-vector product, narrow layers run on member 0
+            const auto [first, end] = parallel
+                                          ? ThreadTeam::Split(layer.numNeurons, member, numMembers)
+                                          : std::pair<int, int>(0, member == 0 ? layer.numNeurons : 0);
+            if (end > first) {
+                const Eigen::Vector<double, Eigen::Dynamic>& layerInputs = i == 0 ? inputs : *activatedOutputs[i - 1];
+                SimdKernels::Get().layerForward(layer.weights.data() + first, layer.numNeurons,
+                                                layer.biases.data() + first, layerInputs.data(), end - first,
+                                                layer.numNeuronInputs, 1,
+                                                i == numLayers - 1
+                                                    ? _outputActivationFunction
+                                                    : _hiddenActivationFunction,
+                                                activatedOutputs[i]->data() + first,
+                                                netOutputs.empty() ? nullptr : netOutputs[i]->data() + first);
+            }
+
+            // the next layer reads every output of this one, unless both run on member 0 alone
+            if (numMembers > 1 && i < numLayers - 1 && (parallel || IsParallelLayer(i + 1))) {
+                _threadTeam->Barrier();
+            }
+        }
+    });
 }
 
 Eigen::Vector<double, Eigen::Dynamic> NeuralNetwork::FeedForward(const Eigen::Vector<double, Eigen::Dynamic>& inputs) {
+    TraceSpan span("FeedForward");
+    if (UsesThreadTeam()) {
+        // the activated outputs of each layer are written straight into the inputs of the next one
+        Eigen::Vector<double, Eigen::Dynamic> outputs{};
+        std::vector<Eigen::Vector<double, Eigen::Dynamic>*> activatedOutputs{};
+        std::vector<Eigen::Vector<double, Eigen::Dynamic>*> netOutputs{};
+        _layers.front().inputs = inputs;
+        for (int i = 0; i < static_cast<int>(_layers.size()); ++i) {
+            activatedOutputs.push_back(i + 1 < static_cast<int>(_layers.size()) ? &_layers[i + 1].inputs : &outputs);
+            netOutputs.push_back(&_layers[i].outputs);
+        }
+        FeedForwardOnTeam(inputs, activatedOutputs, netOutputs);
+        return outputs;
+    }
+
     // store the inputs
     Eigen::Vector<double, Eigen::Dynamic> outputs = inputs;
 
     // set the activation function to the hidden layer activation function
     EActivationFunction activationFunction = _hiddenActivationFunction;
+    NNL_PROFILE_PASS(pass, EProfilePhase::FORWARD, 1, true);
     for (int i = 0; i < static_cast<int>(_layers.size()); ++i) {
         // set the activation function to the output layer activation function if the current layer is the output layer
         if (i >= static_cast<int>(_layers.size()) - 1) { activationFunction = _outputActivationFunction; }
 
         // calculate the outputs of the layer and store them
+        NNL_PROFILE_LAYER(pass, EProfilePhase::FORWARD, i, 1);
+        TraceSpan layerSpan("forward", "layer", i);
         outputs = _layers[i].CalcOutputs(outputs, activationFunction);
     }
     // return the final outputs
     return outputs;
 }
 
-void NeuralNetwork::UpdateWeightsAndBiases(const Eigen::Vector<double, Eigen::Dynamic>& grad, const int i) {
-    // loop through the weights and biases and update them
-    for (int row = 0; row < _layers[i].weights.rows(); ++row) {
-        for (int col = 0; col < _layers[i].weights.cols(); ++col) {
-            _layers[i].weights(row, col) += _learningRate * grad[row] * _layers[i].inputs[col];
+Eigen::Vector<double, Eigen::Dynamic> NeuralNetwork::FeedForward(
+    const Eigen::Vector<double, Eigen::Dynamic>& inputs) const {
+    TraceSpan span("FeedForward");
+    if (UsesThreadTeam()) {
+        std::vector<Eigen::Vector<double, Eigen::Dynamic>> layerOutputs(_layers.size());
+        std::vector<Eigen::Vector<double, Eigen::Dynamic>*> activatedOutputs{};
+        for (auto& layerOutput : layerOutputs) { activatedOutputs.push_back(&layerOutput); }
+        FeedForwardOnTeam(inputs, activatedOutputs, {});
+        return std::move(layerOutputs.back());
+    }
+
+    Eigen::Vector<double, Eigen::Dynamic> outputs = inputs;
+
+    EActivationFunction activationFunction = _hiddenActivationFunction;
+    NNL_PROFILE_PASS(pass, EProfilePhase::FORWARD, 1, false);
+    for (int i = 0; i < static_cast<int>(_layers.size()); ++i) {
+        if (i >= static_cast<int>(_layers.size()) - 1) { activationFunction = _outputActivationFunction; }
+        NNL_PROFILE_LAYER(pass, EProfilePhase::FORWARD, i, 1);
+        TraceSpan layerSpan("forward", "layer", i);
+        outputs = _layers[i].CalcOutputs(outputs, activationFunction);
+    }
+    return outputs;
+}
+
+Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> NeuralNetwork::FeedForwardBatch(
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs) const {
+    TraceSpan span("FeedForwardBatch", "samples", inputs.cols());
+    NNL_PROFILE_PASS(pass, EProfilePhase::FORWARD, static_cast<int>(inputs.cols()), false);
+    if (_maxBatchSize > 0 && inputs.cols() > _maxBatchSize) {
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> outputs(_numOutputs, inputs.cols());
+        for (Eigen::Index first = 0; first < inputs.cols(); first += _maxBatchSize) {
+            const Eigen::Index numSamples = std::min<Eigen::Index>(_maxBatchSize, inputs.cols() - first);
+            Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> block = inputs.middleCols(first, numSamples);
+            for (int i = 0; i < static_cast<int>(_layers.size()); ++i) {
+                NNL_PROFILE_LAYER(pass, EProfilePhase::FORWARD, i, static_cast<int>(numSamples));
+                TraceSpan layerSpan("forward", "layer", i);
+                block = _layers[i].CalcOutputsBatch(block, i == static_cast<int>(_layers.size()) - 1
+                                                               ? _outputActivationFunction
+                                                               : _hiddenActivationFunction);
+            }
+            outputs.middleCols(first, numSamples) = block;
         }
+        return outputs;
     }
-    _layers[i].biases += _learningRate * grad;
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> outputs = inputs;
+
+    EActivationFunction activationFunction = _hiddenActivationFunction;
+    for (int i = 0; i < static_cast<int>(_layers.size()); ++i) {
+        if (i >= static_cast<int>(_layers.size()) - 1) { activationFunction = _outputActivationFunction; }
+        NNL_PROFILE_LAYER(pass, EProfilePhase::FORWARD, i, static_cast<int>(inputs.cols()));
+        TraceSpan layerSpan("forward", "layer", i);
+        outputs = _layers[i].CalcOutputsBatch(outputs, activationFunction);
+    }
+    return outputs;
+}
+
+void NeuralNetwork::CalcLayerGradients(const Eigen::Vector<double, Eigen::Dynamic>& grad, const int i) {
+    // outer product of the neuron deltas and the layer inputs
+    _layers[i].weightGradients.noalias() = grad * _layers[i].inputs.transpose();
+    _layers[i].biasGradients = grad;
+}
+
+void NeuralNetwork::UpdateWeightsAndBiases() {
+    TraceSpan span("UpdateWeightsAndBiases");
+    NoAllocationScope noAllocation;
+    NNL_PROFILE_PASS(pass, EProfilePhase::UPDATE, 1, true);
+#ifdef NNL_ENABLE_PROFILING
+    if (pass != nullptr) {
+        // timed passes go layer by layer to see each layer's share
+        double* parameters = GetParameters().data();
+        double* gradients = GetGradients().data();
+        for (int i = 0; i < static_cast<int>(_layers.size()); ++i) {
+            NNL_PROFILE_LAYER(pass, EProfilePhase::UPDATE, i, 1);
+            const auto numLayerParameters = static_cast<std::size_t>(
+                NeuronLayer::NumParameters(_layers[i].numNeurons, _layers[i].numNeuronInputs));
+            SimdKernels::Get().addScaled(parameters, gradients, _learningRate, numLayerParameters);
+            parameters += numLayerParameters;
+            gradients += numLayerParameters;
+        }
+        return;
+    }
+#endif
+
+    // every layer lives in the same arena, so the whole model is updated in one pass
+    SimdKernels::Get().addScaled(GetParameters().data(), GetGradients().data(), _learningRate,
+                                 static_cast<std::size_t>(GetParameters().size()));
 }
 
 double NeuralNetwork::BackPropagate(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
                                     const Eigen::Vector<double, Eigen::Dynamic>& targets) {
+    TraceSpan span("BackPropagate");
+    const double meanSquareError = CalcGradients(inputs, targets);
+
+    // update the weights and biases
+    UpdateWeightsAndBiases();
+
+    return meanSquareError;
+}
+
+double NeuralNetwork::CalcGradients(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
+                                    const Eigen::Vector<double, Eigen::Dynamic>& targets,
+                                    const std::function<void(int layer)>& onLayerGradients) {
 
     // calculate the outputs of the network and the errors
     const Eigen::Vector<double, Eigen::Dynamic> outputs = FeedForward(inputs);
@@ -78,41 +453,109 @@ double NeuralNetwork::BackPropagate(const Eigen::Vector<double, Eigen::Dynamic>&
     }
 
     const auto numLayers = static_cast<int>(_layers.size());
+    NNL_PROFILE_PASS(deltasPass, EProfilePhase::DELTAS, 1, true);
+    NNL_PROFILE_PASS(gradientsPass, EProfilePhase::GRADIENTS, 1, true);
 
     // calculate deltas of output layer
-    for (int j = 0; j < _numOutputs; ++j) {
-        // calculate the neuron deltas of the output layer
-        _neuronDeltas.back()[j] = outputErrors[j] * ActivationLib::ActivationFunctionDerivative(
-            _layers.back().outputs[j], _outputActivationFunction);
+    {
+        NNL_PROFILE_LAYER(deltasPass, EProfilePhase::DELTAS, numLayers - 1, 1);
+        TraceSpan layerSpan("backward deltas", "layer", numLayers - 1);
+        for (int j = 0; j < _numOutputs; ++j) {
+            // calculate the neuron deltas of the output layer
+            _neuronDeltas.back()[j] = outputErrors[j] * ActivationLib::ActivationFunctionDerivative(
+                _layers.back().outputs[j], _outputActivationFunction);
+        }
     }
+
+    // the gradients of a layer only depend on its deltas and inputs, so each layer is stored as soon as its deltas
+    // are known
+    {
+        NNL_PROFILE_LAYER(gradientsPass, EProfilePhase::GRADIENTS, numLayers - 1, 1);
+        TraceSpan layerSpan("backward gradients", "layer", numLayers - 1);
+        CalcLayerGradients(outputErrors, numLayers - 1);
+    }
+    if (onLayerGradients) { onLayerGradients(numLayers - 1); }
     
     // calculate the neuron deltas of the hidden layers
     for (int i = numLayers - 2; i >= 0; --i) {
-        
-        // calculate vector of weights * neuronDeltas for subsequent layer
-        _neuronDeltas[i] = _layers[i + 1].weights.transpose() * _neuronDeltas[i + 1];
+        {
+            NNL_PROFILE_LAYER(deltasPass, EProfilePhase::DELTAS, i, 1);
+            TraceSpan layerSpan("backward deltas", "layer", i);
+
+            // calculate vector of weights * neuronDeltas for subsequent layer
+            _neuronDeltas[i] = _layers[i + 1].weights.transpose() * _neuronDeltas[i + 1];
 
-        // multiply gradient sums with the derivative of the activation function
-        for (int j = 0; j < _neuronDeltas[i].size(); ++j) {
-            _neuronDeltas[i][j] *= ActivationLib::ActivationFunctionDerivative(
-                _layers[i].outputs[j], _hiddenActivationFunction);
+            // multiply gradient sums with the derivative of the activation function
+            for (int j = 0; j < _neuronDeltas[i].size(); ++j) {
+                _neuronDeltas[i][j] *= ActivationLib::ActivationFunctionDerivative(
+                    _layers[i].outputs[j], _hiddenActivationFunction);
+            }
+        }
+
+        // store the gradients of the weights and biases
+        {
+            NNL_PROFILE_LAYER(gradientsPass, EProfilePhase::GRADIENTS, i, 1);
+            TraceSpan layerSpan("backward gradients", "layer", i);
+            CalcLayerGradients(_neuronDeltas[i], i);
         }
+        if (onLayerGradients) { onLayerGradients(i); }
     }
 
-    // update the weights and biases
-    for (int i = 0; i < numLayers-1; ++i) {
-        UpdateWeightsAndBiases(_neuronDeltas[i], i);
+    return meanSquareError;
+}
+
+void NeuralNetwork::FinishEpoch() {
+    ++_trainedEpochs;
+    if (_checkpointer != nullptr) { _checkpointer->OnEpochEnd(*this); }
+}
+
+void NeuralNetwork::CopyStateFrom(const NeuralNetwork& other) {
+    if (this == &other) { return; }
+
+    _numInputs = other._numInputs;
+    _numOutputs = other._numOutputs;
+    _numHiddenLayers = other._numHiddenLayers;
+    _numNeuronsPerHiddenLayer = other._numNeuronsPerHiddenLayer;
+    _learningRate = other._learningRate;
+    _trainedEpochs = other._trainedEpochs;
+    _hiddenActivationFunction = other._hiddenActivationFunction;
+    _outputActivationFunction = other._outputActivationFunction;
+
+    bool sameTopology = _layers.size() == other._layers.size();
+    for (int i = 0; sameTopology && i < static_cast<int>(_layers.size()); ++i) {
+        sameTopology = _layers[i].numNeurons == other._layers[i].numNeurons &&
+            _layers[i].numNeuronInputs == other._layers[i].numNeuronInputs;
     }
-    UpdateWeightsAndBiases(outputErrors, numLayers - 1);
 
+    if (sameTopology) {
+        // both arenas share the same layout, so this is a single copy without allocating
+        GetParameters() = other.GetParameters();
+    }
+    else {
+        _layers = other._layers;
+        _mappedFile.reset();
+        AllocateArena();
+    }
+}
+
+double NeuralNetwork::TrainEpoch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                                const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets) {
+    TraceSpan span("epoch", "epoch", _trainedEpochs);
+    double meanSquareError{};
+    for (Eigen::Index j = 0; j < inputs.cols(); ++j) {
+        meanSquareError += BackPropagate(inputs.col(j), targets.col(j));
+    }
+    FinishEpoch();
     return meanSquareError;
 }
 
 std::string NeuralNetwork::Train(const std::vector<std::vector<double>>& inputs,
                                  const std::vector<std::vector<double>>& targets, const int numEpochs) {
+    TraceSpan span("Train", "epochs", numEpochs);
     std::string result;
 
     for (int i = 0; i < numEpochs; ++i) {
+        TraceSpan epochSpan("epoch", "epoch", _trainedEpochs);
         double meanSquareError = 0; // mean square error
 
         // loop through the inputs and targets and back propagate the error
@@ -127,6 +570,7 @@ std::string NeuralNetwork::Train(const std::vector<std::vector<double>>& inputs,
             }
             meanSquareError += BackPropagate(input, target);
         }
+        FinishEpoch();
         result += "Epoch " + std::to_string(i) + ", Mean Square Error: " + std::to_string(meanSquareError) + "\n";
     }
 
@@ -136,12 +580,14 @@ std::string NeuralNetwork::Train(const std::vector<std::vector<double>>& inputs,
 std::string NeuralNetwork::Train(const std::vector<std::vector<double>>& inputs,
                                  const std::vector<std::vector<double>>& targets, const double maxError,
                                  const int maxEpochs) {
+    TraceSpan span("Train", "epochs", maxEpochs);
     std::string result{};
     double meanSquareError{std::numeric_limits<double>::max()};
     int i{};
 
     // loop through the inputs and targets and back propagate the error until the error is below the threshold
     while (meanSquareError > maxError && maxEpochs > i++) {
+        TraceSpan epochSpan("epoch", "epoch", _trainedEpochs);
         meanSquareError = 0;
 
         for (int j = 0; j < static_cast<int>(inputs.size()); ++j) {
@@ -158,6 +604,7 @@ std::string NeuralNetwork::Train(const std::vector<std::vector<double>>& inputs,
             meanSquareError += BackPropagate(input, target);
         }
 
+        FinishEpoch();
         result += "Epoch " + std::to_string(i) + " Mean Square Error: " + std::to_string(meanSquareError) + "\n";
     }
 
@@ -165,68 +612,280 @@ std::string NeuralNetwork::Train(const std::vector<std::vector<double>>& inputs,
 }
 
 bool NeuralNetwork::SaveToFile(const std::string& filename) {
-    std::ofstream file(filename);
+    TraceSpan span("SaveToFile");
+    // write next to the file and rename it over, so readers never see a partly written model
+    const std::string temporaryFilename = AtomicFile::TemporaryFilename(filename);
+    std::ofstream file(temporaryFilename, std::ios::binary);
 
     if (file.is_open()) {
+        // format everything into one buffer, numbers are written as the shortest text that round-trips exactly
+        std::string text{};
+
         // save the network parameters
-        file << _numInputs << " " << _numOutputs << " " << _numHiddenLayers << " " << _numNeuronsPerHiddenLayer << " "
-             << _learningRate << " " << static_cast<int>(_hiddenActivationFunction) << " "
-             << static_cast<int>(_outputActivationFunction) << "\n";
+        AppendNumber(text, _numInputs, ' ');
+        AppendNumber(text, _numOutputs, ' ');
+        AppendNumber(text, _numHiddenLayers, ' ');
+        AppendNumber(text, _numNeuronsPerHiddenLayer, ' ');
+        AppendNumber(text, _learningRate, ' ');
+        AppendNumber(text, static_cast<int>(_hiddenActivationFunction), ' ');
+        AppendNumber(text, static_cast<int>(_outputActivationFunction), '\n');
 
         // save the layers
         for (const auto& layer : _layers) {
-            file << layer.numNeurons << " " << layer.numNeuronInputs << "\n";
+            AppendNumber(text, layer.numNeurons, ' ');
+            AppendNumber(text, layer.numNeuronInputs, '\n');
             for (int i = 0; i < layer.weights.rows(); ++i) {
                 for (int j = 0; j < layer.weights.cols(); ++j) {
-                    file << layer.weights(i, j) << " ";
+                    AppendNumber(text, layer.weights(i, j), ' ');
                 }
-                file << "\n";
+                text += '\n';
             }
             for (const double bias : layer.biases) {
-                file << bias << " ";
+                AppendNumber(text, bias, ' ');
             }
-            file << "\n";
+            text += '\n';
         }
-        return true;
+
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        file.close();
+        if (!file.good()) {
+            std::cerr << "Could not write file " << temporaryFilename << '\n';
+            std::remove(temporaryFilename.c_str());
+            return false;
+        }
+        return AtomicFile::Commit(filename);
     }
 
-    std::cerr << "Could not open file " << filename << '\n';
+    std::cerr << "Could not open file " << temporaryFilename << '\n';
     return false;
 }
 
 bool NeuralNetwork::LoadFromFile(const std::string& filename) {
-    std::ifstream file(filename);
+    TraceSpan span("LoadFromFile");
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
 
     if (file.is_open()) {
-        // load the network parameters
-        file >> _numInputs >> _numOutputs >> _numHiddenLayers >> _numNeuronsPerHiddenLayer >> _learningRate;
-        
-        int hiddenActivationFunction, outputActivationFunction;
-        file >> hiddenActivationFunction >> outputActivationFunction;
-        
-        _hiddenActivationFunction = static_cast<EActivationFunction>(hiddenActivationFunction);
-        _outputActivationFunction = static_cast<EActivationFunction>(outputActivationFunction);
+        // read the whole file at once and parse it in memory
+        std::string text(static_cast<std::size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        file.read(text.data(), static_cast<std::streamsize>(text.size()));
+        TextModelReader reader(text.data(), text.data() + text.size());
+
+        // load the network parameters into locals so a malformed file leaves the network untouched
+        int numInputs{}, numOutputs{}, numHiddenLayers{}, numNeuronsPerHiddenLayer{};
+        double learningRate{};
+        int hiddenActivationFunction{}, outputActivationFunction{};
+        if (!reader.Read(numInputs) || !reader.Read(numOutputs) || !reader.Read(numHiddenLayers) ||
+            !reader.Read(numNeuronsPerHiddenLayer) || !reader.Read(learningRate) ||
+            !reader.Read(hiddenActivationFunction) || !reader.Read(outputActivationFunction) || numHiddenLayers < 0 ||
+            !IsValidActivationFunction(hiddenActivationFunction) ||
+            !IsValidActivationFunction(outputActivationFunction)) {
+            std::cerr << "Invalid network parameters in file " << filename << '\n';
+            return false;
+        }
 
-        _layers.clear();
-        _layers.reserve(_numHiddenLayers + 1);
+        // the constructor always builds at least one hidden layer
+        const int numLayers = std::max(numHiddenLayers, 1) + 1;
+        std::vector<NeuronLayer> layers{};
+        layers.reserve(numLayers);
+        std::vector<BinaryLayerShape> shapes{};
+        std::vector<double> parameters{};
 
         // load the layers
-        for (int i = 0; i < _numHiddenLayers + 1; ++i) {
-            int numNeurons, numNeuronInputs;
-            file >> numNeurons >> numNeuronInputs;
-            _layers.emplace_back(numNeurons, numNeuronInputs);
-            for (int j = 0; j < _layers[i].weights.rows(); ++j) {
-                for (int k = 0; k < _layers[i].weights.cols(); ++k) {
-                    file >> _layers[i].weights(j, k);
+        for (int i = 0; i < numLayers; ++i) {
+            int numNeurons{}, numNeuronInputs{};
+            if (!reader.Read(numNeurons) || !reader.Read(numNeuronInputs) ||
+                !IsValidLayerShape({numNeurons, numNeuronInputs})) {
+                std::cerr << "Invalid layer " << i << " in file " << filename << '\n';
+                return false;
+            }
+            shapes.push_back({numNeurons, numNeuronInputs});
+
+            // the file stores the weights row by row, the layers store them column-major
+            parameters.resize(NeuronLayer::NumParameters(numNeurons, numNeuronInputs));
+            for (int j = 0; j < numNeurons; ++j) {
+                for (int k = 0; k < numNeuronInputs; ++k) {
+                    if (!reader.Read(parameters[j + k * numNeurons])) {
+                        std::cerr << "Invalid weight in layer " << i << " in file " << filename << '\n';
+                        return false;
+                    }
                 }
             }
-            for (double& bias : _layers[i].biases) {
-                file >> bias;
+            for (int j = 0; j < numNeurons; ++j) {
+                if (!reader.Read(parameters[numNeurons * numNeuronInputs + j])) {
+                    std::cerr << "Invalid bias in layer " << i << " in file " << filename << '\n';
+                    return false;
+                }
             }
+
+            // copying a view of the parameters gives the layer its own storage
+            const NeuronLayer layer(numNeurons, numNeuronInputs, parameters.data());
+            layers.push_back(layer);
+        }
+
+        // the layers must chain into the network the header describes, or the kernels read past them
+        if (!IsValidTopology(numInputs, numOutputs, numHiddenLayers, numNeuronsPerHiddenLayer, shapes)) {
+            std::cerr << "Layers do not match the network parameters in file " << filename << '\n';
+            return false;
         }
+
+        _numInputs = numInputs;
+        _numOutputs = numOutputs;
+        _numHiddenLayers = numHiddenLayers;
+        _numNeuronsPerHiddenLayer = numNeuronsPerHiddenLayer;
+        _learningRate = learningRate;
+        _hiddenActivationFunction = static_cast<EActivationFunction>(hiddenActivationFunction);
+        _outputActivationFunction = static_cast<EActivationFunction>(outputActivationFunction);
+        _layers = std::move(layers);
+        _mappedFile.reset();
+        AllocateArena();
         return true;
     }
 
     std::cerr << "Could not open file " << filename << '\n';
     return false;
 }
+
+bool NeuralNetwork::SaveToBinaryFile(const std::string& filename) const {
+    TraceSpan span("SaveToBinaryFile");
+    // write next to the file and rename it over, truncating it in place would pull the pages from under every
+    // mapping of it, including one this network may be running on
+    const std::string temporaryFilename = AtomicFile::TemporaryFilename(filename);
+    std::ofstream file(temporaryFilename, std::ios::binary);
+
+    if (file.is_open()) {
+        BinaryModelHeader header{};
+        std::memcpy(header.magic, binaryModelMagic, sizeof(header.magic));
+        header.version = binaryModelVersion;
+        header.numLayers = static_cast<std::uint32_t>(_layers.size());
+        header.numInputs = _numInputs;
+        header.numOutputs = _numOutputs;
+        header.numHiddenLayers = _numHiddenLayers;
+        header.numNeuronsPerHiddenLayer = _numNeuronsPerHiddenLayer;
+        header.learningRate = _learningRate;
+        header.hiddenActivationFunction = static_cast<std::uint8_t>(_hiddenActivationFunction);
+        header.outputActivationFunction = static_cast<std::uint8_t>(_outputActivationFunction);
+        header.trainedEpochs = static_cast<std::uint32_t>(_trainedEpochs);
+
+        // align the parameters so they can be used in place once the file is mapped
+        const std::uint64_t tableEnd = sizeof(BinaryModelHeader) + _layers.size() * sizeof(BinaryLayerShape);
+        header.parametersOffset = (tableEnd + binaryModelAlignment - 1) / binaryModelAlignment * binaryModelAlignment;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& layer : _layers) {
+            const BinaryLayerShape shape{layer.numNeurons, layer.numNeuronInputs};
+            file.write(reinterpret_cast<const char*>(&shape), sizeof(shape));
+        }
+        const char padding[binaryModelAlignment]{};
+        file.write(padding, static_cast<std::streamsize>(header.parametersOffset - tableEnd));
+
+        // the arena has the same layout as the file, so the layers are saved in one write
+        file.write(reinterpret_cast<const char*>(_parameters.Data()),
+                   static_cast<std::streamsize>(_parameters.Size() * sizeof(double)));
+        file.close();
+        if (!file.good()) {
+            std::cerr << "Could not write file " << temporaryFilename << '\n';
+            std::remove(temporaryFilename.c_str());
+            return false;
+        }
+        return AtomicFile::Commit(filename);
+    }
+
+    std::cerr << "Could not open file " << temporaryFilename << '\n';
+    return false;
+}
+
+bool NeuralNetwork::LoadFromBinaryFile(const std::string& filename, const bool memoryMapped) {
+    TraceSpan span("LoadFromBinaryFile");
+    // either map the file or read it into a temporary buffer, the parsing below is shared
+    auto mappedFile = std::make_shared<MappedFile>();
+    std::vector<double> buffer{};
+    const std::byte* data{};
+    std::size_t size{};
+
+    if (memoryMapped) {
+        if (!mappedFile->Open(filename)) {
+            std::cerr << "Could not map file " << filename << '\n';
+            return false;
+        }
+        data = mappedFile->Data();
+        size = mappedFile->Size();
+    }
+    else {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            std::cerr << "Could not open file " << filename << '\n';
+            return false;
+        }
+        size = static_cast<std::size_t>(file.tellg());
+        buffer.resize((size + sizeof(double) - 1) / sizeof(double));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size))) {
+            std::cerr << "Could not read file " << filename << '\n';
+            return false;
+        }
+        data = reinterpret_cast<const std::byte*>(buffer.data());
+    }
+
+    // validate the header and the layer table before touching any parameters
+    BinaryModelHeader header{};
+    if (size < sizeof(header)) {
+        std::cerr << "Invalid binary model file " << filename << '\n';
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    const std::uint64_t tableEnd = sizeof(header) + std::uint64_t{header.numLayers} * sizeof(BinaryLayerShape);
+    if (std::memcmp(header.magic, binaryModelMagic, sizeof(header.magic)) != 0 || header.version !=
+        binaryModelVersion || header.numLayers == 0 || header.parametersOffset % alignof(double) != 0 ||
+        tableEnd > size || header.parametersOffset < tableEnd ||
+        !IsValidActivationFunction(header.hiddenActivationFunction) ||
+        !IsValidActivationFunction(header.outputActivationFunction)) {
+        std::cerr << "Invalid binary model file " << filename << '\n';
+        return false;
+    }
+
+    std::vector<BinaryLayerShape> shapes(header.numLayers);
+    std::memcpy(shapes.data(), data + sizeof(header), shapes.size() * sizeof(BinaryLayerShape));
+    if (!IsValidTopology(header.numInputs, header.numOutputs, header.numHiddenLayers,
+                         header.numNeuronsPerHiddenLayer, shapes)) {
+        std::cerr << "Invalid binary model file " << filename << '\n';
+        return false;
+    }
+
+    std::uint64_t numParameters{};
+    for (const auto& shape : shapes) {
+        numParameters += static_cast<std::uint64_t>(NeuronLayer::NumParameters(shape.numNeurons,
+                                                                                shape.numNeuronInputs));
+    }
+    // subtracting from the size can't overflow, unlike adding to the offset
+    if (header.parametersOffset > size || numParameters > (size - header.parametersOffset) / sizeof(double)) {
+        std::cerr << "Truncated binary model file " << filename << '\n';
+        return false;
+    }
+
+    // load the network parameters
+    _numInputs = header.numInputs;
+    _numOutputs = header.numOutputs;
+    _numHiddenLayers = header.numHiddenLayers;
+    _numNeuronsPerHiddenLayer = header.numNeuronsPerHiddenLayer;
+    _learningRate = header.learningRate;
+    _hiddenActivationFunction = static_cast<EActivationFunction>(header.hiddenActivationFunction);
+    _outputActivationFunction = static_cast<EActivationFunction>(header.outputActivationFunction);
+    _trainedEpochs = static_cast<int>(header.trainedEpochs);
+
+    _layers.clear();
+    _layers.reserve(shapes.size());
+
+    // load the layers, referring to the mapping or the buffer for now
+    const auto parameters = const_cast<double*>(reinterpret_cast<const double*>(data + header.parametersOffset));
+    double* layerParameters = parameters;
+    for (const auto& shape : shapes) {
+        _layers.emplace_back(shape.numNeurons, shape.numNeuronInputs, layerParameters);
+        layerParameters += NeuronLayer::NumParameters(shape.numNeurons, shape.numNeuronInputs);
+    }
+
+    // a mapped file becomes the parameter arena, otherwise the parameters are copied into a new arena
+    AllocateArena(memoryMapped ? parameters : nullptr);
+    _mappedFile = memoryMapped ? std::move(mappedFile) : nullptr;
+    return true;
+}
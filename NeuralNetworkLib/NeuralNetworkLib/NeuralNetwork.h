@@ -4,7 +4,7 @@
 // //FileType: Visual C++ Source file
 // //Author : Anders P. Åsbø
 // //Created On : 22/2/2024
-// //Last Modified On : 22/2/2024
+// //Last Modified On : 19/10/2026
 // //Description :
 // //////////////////////////////////////////////////////////////////////////
 // //////////////////////////////
@@ -12,9 +12,17 @@
 #define NEURALNETWORK_H
 
 
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
+#include "NetworkProfiler.h"
 #include "NeuronLayer.h"
+#include "ParameterArena.h"
 
+class MappedFile;
+class ThreadTeam;
+class TrainingCheckpointer;
 
 class NeuralNetwork {
 private:
@@ -23,20 +31,77 @@ private:
     int _numHiddenLayers{};
     int _numNeuronsPerHiddenLayer{};
     double _learningRate{};
+    int _trainedEpochs{}; // number of epochs trained so far, kept across checkpoints
 
     std::vector<NeuronLayer> _layers{};
     std::vector<Eigen::Vector<double, Eigen::Dynamic>> _neuronDeltas{};
 
+    // all parameters and all gradients, each in one contiguous block the layers hold views into
+    ParameterArena _parameters{};
+    ParameterArena _gradients{};
+    bool _useHugePages{};
+
+    // keeps a memory-mapped model file alive while the layers refer to it
+    std::shared_ptr<MappedFile> _mappedFile{};
+
+    /**
+     * \brief move the parameters of every layer into one arena and bind the layers' gradients to another
+     * \param externalParameters if given, the layers already refer to this memory and it is used as the arena
+     */
+    void AllocateArena(double* externalParameters = nullptr);
+
     /**
-     * \brief update the weights and biases of a layer
+     * \brief store the gradients of the weights and biases of a layer
      * \param grad gradient vector to use
      * \param i layer index
      */
-    void UpdateWeightsAndBiases(const Eigen::Vector<double, Eigen::Dynamic>& grad, int i);
+    void CalcLayerGradients(const Eigen::Vector<double, Eigen::Dynamic>& grad, int i);
 
     EActivationFunction _outputActivationFunction{};
     EActivationFunction _hiddenActivationFunction{};
 
+    TrainingCheckpointer* _checkpointer{}; // not owned, notified at the end of every training epoch
+
+    ThreadTeam* _threadTeam{}; // not owned, splits the neurons of wide layers when feeding one sample forward
+    int _minParallelWeights{};
+
+    int _maxBatchSize{}; // FeedForwardBatch splits larger batches into blocks of this many samples, 0 for none
+
+#ifdef NNL_ENABLE_PROFILING
+    mutable NetworkProfiler _profiler{}; // counts const inference too, its counters are atomic
+#endif
+
+    /**
+     * \brief check whether a layer is wide enough to be split over the thread team
+     * \param i layer index
+     * \return true if the layer has at least the minimum number of weights for the team
+     */
+    [[nodiscard]] bool IsParallelLayer(int i) const;
+
+    /**
+     * \brief check whether single samples are fed forward on the thread team
+     * \return true if a team is set and at least one layer is wide enough to be split
+     */
+    [[nodiscard]] bool UsesThreadTeam() const;
+
+    /**
+     * \brief feed one sample forward with the neurons of the wide layers split over the thread team
+     * \param inputs input vector
+     * \param activatedOutputs activatedOutputs[i] receives the activated outputs of layer i
+     * \param netOutputs if not empty, netOutputs[i] receives the net outputs of layer i
+     */
+    void FeedForwardOnTeam(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
+                           const std::vector<Eigen::Vector<double, Eigen::Dynamic>*>& activatedOutputs,
+                           const std::vector<Eigen::Vector<double, Eigen::Dynamic>*>& netOutputs) const;
+
+    /**
+     * \brief count a finished epoch and let the checkpointer know about it
+     */
+    void FinishEpoch();
+
+    friend class IncrementalTrainer; // finishes epochs while training a few samples at a time
+    friend class PipelineNetwork; // finishes epochs trained through its stages
+
 public:
     /**
      * \brief Construct empty neural network
@@ -54,6 +119,16 @@ public:
     NeuralNetwork(int numInputs, int numOutputs, int numHiddenLayers, int numNeuronsPerHiddenLayer,
                   double learningRate);
 
+    /**
+     * \brief copying a network copies its parameters into a new arena; the copy has no checkpointer and no thread
+     *  team, as those belong to the training and inference of the original
+     */
+    NeuralNetwork(const NeuralNetwork& other);
+    NeuralNetwork(NeuralNetwork&& other) noexcept = default;
+    NeuralNetwork& operator=(const NeuralNetwork& other);
+    NeuralNetwork& operator=(NeuralNetwork&& other) noexcept = default;
+    ~NeuralNetwork() = default;
+
     /**
      * \brief set the activation function of the output layer
      * \param activationFunction given activation function
@@ -70,6 +145,134 @@ public:
         _hiddenActivationFunction = activationFunction;
     }
 
+    /**
+     * \brief get the activation function of the output layer
+     * \return activation function
+     */
+    [[nodiscard]] EActivationFunction GetOutputActivationFunction() const { return _outputActivationFunction; }
+
+    /**
+     * \brief get the activation function of the hidden layers
+     * \return activation function
+     */
+    [[nodiscard]] EActivationFunction GetHiddenActivationFunction() const { return _hiddenActivationFunction; }
+
+    /**
+     * \brief get the number of inputs to the network
+     * \return number of inputs
+     */
+    [[nodiscard]] int GetNumInputs() const { return _numInputs; }
+
+    /**
+     * \brief get the number of outputs from the network
+     * \return number of outputs
+     */
+    [[nodiscard]] int GetNumOutputs() const { return _numOutputs; }
+
+    /**
+     * \brief get the learning rate of the network
+     * \return learning rate
+     */
+    [[nodiscard]] double GetLearningRate() const { return _learningRate; }
+
+    /**
+     * \brief get the number of epochs the network has been trained for, restored when resuming from a checkpoint
+     * \return number of trained epochs
+     */
+    [[nodiscard]] int GetTrainedEpochs() const { return _trainedEpochs; }
+
+    /**
+     * \brief set a checkpointer to notify at the end of every training epoch
+     * \param checkpointer checkpointer to use, or nullptr to disable checkpointing; must outlive training
+     */
+    void SetCheckpointer(TrainingCheckpointer* checkpointer) { _checkpointer = checkpointer; }
+
+    /**
+     * \brief feed single samples forward on a thread team for lower latency: the neurons of every layer with at
+     *  least minParallelWeights weights are split over the members, with a barrier between layers, and smaller
+     *  layers stay on the calling thread
+     * \param team team to use, or nullptr to feed forward on the calling thread only; must outlive its use
+     * \param minParallelWeights number of weights from which a layer is split
+     */
+    void SetThreadTeam(ThreadTeam* team, const int minParallelWeights = 1 << 16) {
+        _threadTeam = team;
+        _minParallelWeights = minParallelWeights;
+    }
+
+    /**
+     * \brief feed large batches forward in blocks of samples, so the outputs of each layer stay in cache
+     *  until the next layer reads them, the outputs are the same
+     * \param maxBatchSize number of samples per block, 0 to feed every batch forward in one piece
+     */
+    void SetMaxBatchSize(const int maxBatchSize) { _maxBatchSize = maxBatchSize > 0 ? maxBatchSize : 0; }
+
+    [[nodiscard]] int GetMaxBatchSize() const { return _maxBatchSize; }
+
+    /**
+     * \brief get the time, calls, FLOPs and bytes of every layer and phase since the network was built or its
+     *  profile was reset
+     * \return one profile per layer, the last one being the output layer, empty unless NNL_ENABLE_PROFILING is
+     *  defined
+     */
+    [[nodiscard]] std::vector<LayerProfile> GetProfile() const;
+
+    /**
+     * \brief clear the profile counters
+     */
+    void ResetProfile();
+
+    /**
+     * \brief copy the parameters and training state of another network,
+     *  reusing this network's storage if the topologies match
+     * \param other network to copy from
+     */
+    void CopyStateFrom(const NeuralNetwork& other);
+
+    /**
+     * \brief get every weight and bias of the network as one flat vector, layer by layer,
+     *  each layer holding its column-major weights followed by its biases
+     * \return view of the parameters
+     */
+    [[nodiscard]] Eigen::Map<Eigen::Vector<double, Eigen::Dynamic>> GetParameters() {
+        return {_parameters.Data(), static_cast<Eigen::Index>(_parameters.Size())};
+    }
+
+    [[nodiscard]] Eigen::Map<const Eigen::Vector<double, Eigen::Dynamic>> GetParameters() const {
+        return {_parameters.Data(), static_cast<Eigen::Index>(_parameters.Size())};
+    }
+
+    /**
+     * \brief get the gradients of the last CalcGradients call as one flat vector laid out like the parameters,
+     *  they point in the direction that reduces the error, so an update is parameters += learningRate * gradients
+     * \return view of the gradients
+     */
+    [[nodiscard]] Eigen::Map<Eigen::Vector<double, Eigen::Dynamic>> GetGradients() {
+        return {_gradients.Data(), static_cast<Eigen::Index>(_gradients.Size())};
+    }
+
+    [[nodiscard]] Eigen::Map<const Eigen::Vector<double, Eigen::Dynamic>> GetGradients() const {
+        return {_gradients.Data(), static_cast<Eigen::Index>(_gradients.Size())};
+    }
+
+    /**
+     * \brief get the total number of weights and biases in the network
+     * \return number of parameters
+     */
+    [[nodiscard]] int GetNumParameters() const { return static_cast<int>(_parameters.Size()); }
+
+    /**
+     * \brief back the parameter and gradient arenas by huge pages, which helps large models,
+     *  the parameters are kept
+     * \param useHugePages true to request huge pages
+     */
+    void SetUseHugePages(bool useHugePages);
+
+    /**
+     * \brief get the layers of the network, the last one being the output layer
+     * \return layers of the network
+     */
+    [[nodiscard]] const std::vector<NeuronLayer>& GetLayers() const { return _layers; }
+
     /**
      * \brief feed forward the inputs through the network
      * \param inputs input vector
@@ -77,6 +280,41 @@ public:
      */
     Eigen::Vector<double, Eigen::Dynamic> FeedForward(const Eigen::Vector<double, Eigen::Dynamic>& inputs);
 
+    /**
+     * \brief feed forward the inputs through the network without caching anything for back propagation,
+     *  so a network can be evaluated from several threads at once
+     * \param inputs input vector
+     * \return output vector
+     */
+    Eigen::Vector<double, Eigen::Dynamic> FeedForward(const Eigen::Vector<double, Eigen::Dynamic>& inputs) const;
+
+    /**
+     * \brief feed forward a batch of samples through the network with one matrix-matrix product per layer,
+     *  safe to call from several threads at once
+     * \param inputs matrix with one input vector per column
+     * \return matrix with one output vector per column
+     */
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> FeedForwardBatch(
+        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs) const;
+
+    /**
+     * \brief calculate the gradients of every weight and bias for one sample without updating them
+     * \param inputs vector of inputs
+     * \param targets vector of targets
+     * \param onLayerGradients if given, called with the index of each layer as soon as its gradients are stored,
+     *  from the output layer down, so they can be used while the lower layers are still being calculated
+     * \return half the mean square error of the sample
+     */
+    double CalcGradients(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
+                         const Eigen::Vector<double, Eigen::Dynamic>& targets,
+                         const std::function<void(int layer)>& onLayerGradients = nullptr);
+
+    /**
+     * \brief update the weights and biases of every layer from the gradients of the last CalcGradients call,
+     *  in a single pass over the arena
+     */
+    void UpdateWeightsAndBiases();
+
     /**
      * \brief back propagate the error through the network
      * \param inputs vector of inputs
@@ -86,6 +324,15 @@ public:
     double BackPropagate(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
                          const Eigen::Vector<double, Eigen::Dynamic>& targets);
 
+    /**
+     * \brief train the network for one epoch over samples stored as matrix columns, without copying them
+     * \param inputs matrix with one input vector per column
+     * \param targets matrix with one target vector per column
+     * \return sum of the mean square errors of the samples
+     */
+    double TrainEpoch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets);
+
     /**
      * \brief train the network for a given number of epochs
      * \param inputs vector of input vectors
@@ -102,15 +349,40 @@ public:
      * \param inputs vector of input vectors
      * \param targets vector of target vectors
      * \param maxError error threshold
-     * \param maxEpochs maximum number of epochs
+     * \param maxEpochs maximum number of epochs of this call; epochs restored from a checkpoint don't count, so pass
+     *  maxEpochs - GetTrainedEpochs() to resume a budget
      * \return 
      */
     std::string Train(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& targets,
                       double maxError = 1e-3, int maxEpochs = 1000);
 
+    /**
+     * \brief save the network as text, written to a temporary file and renamed over filename like
+     *  SaveToBinaryFile
+     * \param filename file to write
+     * \return true if the file was written
+     */
     bool SaveToFile(const std::string& filename);
 
     bool LoadFromFile(const std::string& filename);
-     
+
+    /**
+     * \brief save the network in the native binary format, which can be memory mapped by LoadFromBinaryFile.
+     *  The file is written to filename + ".tmp", flushed to the disk and renamed over filename, so networks and
+     *  processes that have the old file mapped keep their view of it, and filename is always complete
+     * \param filename file to write
+     * \return true if the file was written
+     */
+    bool SaveToBinaryFile(const std::string& filename) const;
+
+    /**
+     * \brief load the network from a file written by SaveToBinaryFile, this also restores the number of trained
+     *  epochs, so it resumes training from a checkpoint
+     * \param filename file to read
+     * \param memoryMapped if true, the weights and biases are used in place from a copy-on-write mapping of the file,
+     *  so processes loading the same file share its memory until they modify the parameters
+     * \return true if the network was loaded
+     */
+    bool LoadFromBinaryFile(const std::string& filename, bool memoryMapped = true);
 };
 #endif // NEURALNETWORK_H
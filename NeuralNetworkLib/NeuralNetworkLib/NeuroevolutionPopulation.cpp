@@ -0,0 +1,214 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NeuroevolutionPopulation.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "NeuroevolutionPopulation.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    using StridedMatrix = Eigen::Map<Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+    using ConstStridedMatrix = Eigen::Map<const Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+
+    // rows of the stacked first layer handed to each thread at a time
+    constexpr Eigen::Index rowBlockSize = 64;
+}
+
+NeuroevolutionPopulation::NeuroevolutionPopulation(const NeuralNetwork& prototype, const int populationSize,
+                                                   const double initialSpread, const std::uint64_t seed) :
+    _prototype(prototype), _populationSize(populationSize), _generator(seed) {
+    if (populationSize <= 0) { throw std::invalid_argument("Population size must be positive"); }
+
+    Eigen::Index offset{};
+    for (const auto& layer : _prototype.GetLayers()) {
+        _layerShapes.push_back({layer.numNeurons, layer.numNeuronInputs, offset});
+        offset += NeuronLayer::NumParameters(layer.numNeurons, layer.numNeuronInputs);
+    }
+
+    // every individual starts as the prototype plus some noise
+    std::normal_distribution<double> noise{0.0, initialSpread};
+    _genomes = _prototype.GetParameters().replicate(1, populationSize);
+    _genomes += GenomeMatrix::NullaryExpr(_genomes.rows(), _genomes.cols(), [&] { return noise(_generator); });
+    _offspring.resizeLike(_genomes);
+    _fitness = Eigen::VectorXd::Zero(populationSize);
+}
+
+int NeuroevolutionPopulation::GetBestIndividual() const {
+    Eigen::Index best{};
+    _fitness.maxCoeff(&best);
+    return static_cast<int>(best);
+}
+
+Eigen::Vector<double, Eigen::Dynamic> NeuroevolutionPopulation::GetGenome(const int individual) const {
+    return _genomes.col(individual);
+}
+
+void NeuroevolutionPopulation::SetGenome(const int individual,
+                                         const Eigen::Ref<const Eigen::Vector<double, Eigen::Dynamic>>& genome) {
+    _genomes.col(individual) = genome;
+}
+
+void NeuroevolutionPopulation::CopyToNetwork(const int individual, NeuralNetwork& network) const {
+    network.GetParameters() = _genomes.col(individual);
+}
+
+void NeuroevolutionPopulation::Mutate(const int individual, const double mutationRate,
+                                      const double mutationStrength) {
+    Mutate(_genomes, individual, mutationRate, mutationStrength);
+}
+
+void NeuroevolutionPopulation::Mutate(GenomeMatrix& genomes, const int individual, const double mutationRate,
+                                      const double mutationStrength) {
+    std::normal_distribution<double> noise{0.0, mutationStrength};
+
+    // draw the gap to the next mutated parameter instead of one coin flip per parameter
+    if (mutationRate <= 0.0) { return; }
+    if (mutationRate >= 1.0) {
+        for (Eigen::Index k = 0; k < genomes.rows(); ++k) { genomes(k, individual) += noise(_generator); }
+        return;
+    }
+    std::geometric_distribution<Eigen::Index> gap{mutationRate};
+    for (Eigen::Index k = gap(_generator); k < genomes.rows(); k += 1 + gap(_generator)) {
+        genomes(k, individual) += noise(_generator);
+    }
+}
+
+void NeuroevolutionPopulation::Crossover(const int parentA, const int parentB, const int child) {
+    Crossover(_genomes, parentA, parentB, _genomes, child);
+}
+
+void NeuroevolutionPopulation::Crossover(const GenomeMatrix& parents, const int parentA, const int parentB,
+                                         GenomeMatrix& children, const int child) {
+    std::uniform_int_distribution<std::uint64_t> bits{};
+    std::uint64_t mask{};
+    for (Eigen::Index k = 0; k < parents.rows(); ++k) {
+        // one random draw supplies the coin flips for 64 parameters
+        if (k % 64 == 0) { mask = bits(_generator); }
+        children(k, child) = (mask >> (k % 64) & 1) != 0 ? parents(k, parentA) : parents(k, parentB);
+    }
+}
+
+Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> NeuroevolutionPopulation::FeedForwardBatch(
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs, ThreadPool& pool) const {
+    const Eigen::Index numIndividuals = _populationSize;
+    const auto numLayers = static_cast<int>(_layerShapes.size());
+    Eigen::MatrixXd activations{};
+
+    for (int l = 0; l < numLayers; ++l) {
+        const auto& shape = _layerShapes[l];
+        const Eigen::Index numRows = shape.numNeurons * numIndividuals;
+        const double* layerData = _genomes.data() + shape.offset * numIndividuals;
+        Eigen::MatrixXd layerOutputs(numRows, inputs.cols());
+
+        if (l == 0) {
+            // weight (r, c) of individual p sits at row (r * populationSize + p) of one stacked matrix
+            const Eigen::Map<const Eigen::MatrixXd> stackedWeights(layerData, numRows, shape.numNeuronInputs);
+            const auto numBlocks = static_cast<int>((numRows + rowBlockSize - 1) / rowBlockSize);
+            pool.ParallelFor(numBlocks, [&](const int block, int) {
+                const Eigen::Index begin = block * rowBlockSize;
+                const Eigen::Index rows = std::min(rowBlockSize, numRows - begin);
+                layerOutputs.middleRows(begin, rows).noalias() = stackedWeights.middleRows(begin, rows) * inputs;
+            });
+        }
+        else {
+            // every individual multiplies its own strided weights with its own strided inputs
+            const Eigen::Index numInputRows = activations.rows();
+            pool.ParallelFor(static_cast<int>(numIndividuals), [&](const int p, int) {
+                const ConstStridedMatrix weights(layerData + p, shape.numNeurons, shape.numNeuronInputs,
+                                                 Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(
+                                                     shape.numNeurons * numIndividuals, numIndividuals));
+                const ConstStridedMatrix layerInputs(activations.data() + p, shape.numNeuronInputs, inputs.cols(),
+                                                     Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(
+                                                         numInputRows, numIndividuals));
+                StridedMatrix outputs(layerOutputs.data() + p, shape.numNeurons, inputs.cols(),
+                                      Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(numRows, numIndividuals));
+                outputs = weights * layerInputs;
+            });
+        }
+
+        // the biases of the whole population are one interleaved vector following the weights
+        const Eigen::Map<const Eigen::VectorXd> biases(
+            layerData + static_cast<Eigen::Index>(shape.numNeurons) * shape.numNeuronInputs * numIndividuals,
+            numRows);
+        layerOutputs.colwise() += biases;
+        NeuronLayer::ApplyActivationFunction(layerOutputs, l == numLayers - 1
+                                                               ? _prototype.GetOutputActivationFunction()
+                                                               : _prototype.GetHiddenActivationFunction());
+        activations = std::move(layerOutputs);
+    }
+    return activations;
+}
+
+void NeuroevolutionPopulation::EvaluateBatch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                                             const std::function<double(
+                                                 int individual,
+                                                 const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>&
+                                                 outputs)>& fitness, ThreadPool& pool) {
+    const Eigen::MatrixXd outputs = FeedForwardBatch(inputs, pool);
+    const int numOutputs = _layerShapes.back().numNeurons;
+
+    pool.ParallelFor(_populationSize, [&](const int p, int) {
+        const Eigen::MatrixXd individualOutputs = ConstStridedMatrix(
+            outputs.data() + p, numOutputs, outputs.cols(),
+            Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(outputs.rows(), _populationSize));
+        _fitness[p] = fitness(p, individualOutputs);
+    });
+}
+
+void NeuroevolutionPopulation::Evaluate(const std::function<double(const NeuralNetwork& network)>& fitness,
+                                        ThreadPool& pool) {
+    // one network per thread, the individuals are copied into it instead of constructing new networks
+    std::vector<NeuralNetwork> networks(pool.GetNumThreads() + 1, _prototype);
+
+    pool.ParallelFor(_populationSize, [&](const int p, const int worker) {
+        CopyToNetwork(p, networks[worker]);
+        _fitness[p] = fitness(networks[worker]);
+    });
+}
+
+int NeuroevolutionPopulation::SelectByTournament(const int tournamentSize) {
+    std::uniform_int_distribution<int> individuals{0, _populationSize - 1};
+    int winner = individuals(_generator);
+    for (int i = 1; i < tournamentSize; ++i) {
+        const int challenger = individuals(_generator);
+        if (_fitness[challenger] > _fitness[winner]) { winner = challenger; }
+    }
+    return winner;
+}
+
+void NeuroevolutionPopulation::NextGeneration(const int numElites, const int tournamentSize,
+                                              const double mutationRate, const double mutationStrength) {
+    // rank the population to find the elites
+    std::vector<int> ranking(_populationSize);
+    for (int p = 0; p < _populationSize; ++p) { ranking[p] = p; }
+    const int elites = std::clamp(numElites, 0, _populationSize);
+    std::partial_sort(ranking.begin(), ranking.begin() + elites, ranking.end(),
+                      [this](const int a, const int b) { return _fitness[a] > _fitness[b]; });
+
+    for (int child = 0; child < elites; ++child) {
+        _offspring.col(child) = _genomes.col(ranking[child]);
+    }
+
+    for (int child = elites; child < _populationSize; ++child) {
+        const int parentA = SelectByTournament(tournamentSize);
+        const int parentB = SelectByTournament(tournamentSize);
+        Crossover(_genomes, parentA, parentB, _offspring, child);
+        Mutate(_offspring, child, mutationRate, mutationStrength);
+    }
+
+    _genomes.swap(_offspring);
+
+    // the elites keep their fitness, the children are unknown until the next evaluation
+    Eigen::VectorXd fitness = Eigen::VectorXd::Constant(_populationSize, -std::numeric_limits<double>::infinity());
+    for (int child = 0; child < elites; ++child) { fitness[child] = _fitness[ranking[child]]; }
+    _fitness = std::move(fitness);
+}
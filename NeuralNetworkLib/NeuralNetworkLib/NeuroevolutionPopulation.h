@@ -0,0 +1,183 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NeuroevolutionPopulation.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : gradient-free evolution of network parameters
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef NEUROEVOLUTIONPOPULATION_H
+#define NEUROEVOLUTIONPOPULATION_H
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "NeuralNetwork.h"
+#include "ThreadPool.h"
+
+/**
+ * \brief Population of networks sharing one topology, evolved with selection, crossover and mutation.
+ *
+ * The parameters of the whole population are stored structure-of-arrays: row k of the genome matrix holds
+ * parameter k of every individual, using the layout of NeuralNetwork::GetParameters. With that layout the first
+ * layer of every individual is one stacked matrix, so a forward pass of the whole population over a shared batch
+ * of inputs is a single matrix-matrix product for the first layer and one strided product per individual
+ * for the others, instead of one FeedForward per individual and sample.
+ *
+ * Layer outputs of the population are interleaved: row r * populationSize + p holds neuron r of individual p.
+ */
+class NeuroevolutionPopulation {
+private:
+    struct LayerShape {
+        int numNeurons;
+        int numNeuronInputs;
+        Eigen::Index offset; // index of the first weight in the parameter vector
+    };
+
+    using GenomeMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    NeuralNetwork _prototype{};
+    std::vector<LayerShape> _layerShapes{};
+    int _populationSize{};
+
+    GenomeMatrix _genomes{}; // numParameters x populationSize
+    GenomeMatrix _offspring{}; // next generation, swapped with the genomes
+    Eigen::Vector<double, Eigen::Dynamic> _fitness{};
+
+    std::mt19937_64 _generator{};
+
+    /**
+     * \brief add gaussian noise to some parameters of a genome
+     * \param genomes matrix holding the genome
+     * \param individual column of the genome
+     * \param mutationRate probability of mutating each parameter
+     * \param mutationStrength standard deviation of the noise
+     */
+    void Mutate(GenomeMatrix& genomes, int individual, double mutationRate, double mutationStrength);
+
+    /**
+     * \brief uniform crossover of two parents into a child
+     * \param parents matrix holding the parents
+     * \param parentA column of the first parent
+     * \param parentB column of the second parent
+     * \param children matrix receiving the child, may be the parents
+     * \param child column of the child
+     */
+    void Crossover(const GenomeMatrix& parents, int parentA, int parentB, GenomeMatrix& children, int child);
+
+    /**
+     * \brief pick the fittest of a few randomly drawn individuals
+     * \param tournamentSize number of individuals drawn
+     * \return index of the winner
+     */
+    int SelectByTournament(int tournamentSize);
+
+public:
+    /**
+     * \brief create a population around a prototype network
+     * \param prototype network whose topology and activation functions every individual shares,
+     *  its parameters seed the population
+     * \param populationSize number of individuals
+     * \param initialSpread standard deviation of the noise added to the prototype parameters of every individual
+     * \param seed seed of the random number generator
+     */
+    NeuroevolutionPopulation(const NeuralNetwork& prototype, int populationSize, double initialSpread = 0.1,
+                             std::uint64_t seed = std::random_device{}());
+
+    [[nodiscard]] int GetPopulationSize() const { return _populationSize; }
+    [[nodiscard]] int GetNumParameters() const { return static_cast<int>(_genomes.rows()); }
+
+    /**
+     * \brief get the fitness of every individual from the last evaluation
+     * \return fitness, higher is better
+     */
+    [[nodiscard]] const Eigen::Vector<double, Eigen::Dynamic>& GetFitness() const { return _fitness; }
+
+    /**
+     * \brief get the fittest individual of the last evaluation
+     * \return index of the individual
+     */
+    [[nodiscard]] int GetBestIndividual() const;
+
+    /**
+     * \brief get a copy of the parameters of an individual
+     * \param individual index of the individual
+     * \return flat parameter vector in the layout of NeuralNetwork::GetParameters
+     */
+    [[nodiscard]] Eigen::Vector<double, Eigen::Dynamic> GetGenome(int individual) const;
+
+    /**
+     * \brief overwrite the parameters of an individual
+     * \param individual index of the individual
+     * \param genome flat parameter vector in the layout of NeuralNetwork::GetParameters
+     */
+    void SetGenome(int individual, const Eigen::Ref<const Eigen::Vector<double, Eigen::Dynamic>>& genome);
+
+    /**
+     * \brief copy the parameters of an individual into a network with the same topology
+     * \param individual index of the individual
+     * \param network network to overwrite
+     */
+    void CopyToNetwork(int individual, NeuralNetwork& network) const;
+
+    /**
+     * \brief add gaussian noise to some parameters of an individual
+     * \param individual index of the individual
+     * \param mutationRate probability of mutating each parameter
+     * \param mutationStrength standard deviation of the noise
+     */
+    void Mutate(int individual, double mutationRate, double mutationStrength);
+
+    /**
+     * \brief uniform crossover, each parameter of the child comes from either parent with equal probability
+     * \param parentA index of the first parent
+     * \param parentB index of the second parent
+     * \param child index of the individual to overwrite, may be one of the parents
+     */
+    void Crossover(int parentA, int parentB, int child);
+
+    /**
+     * \brief feed a shared batch of inputs through every individual
+     * \param inputs matrix with one input vector per column
+     * \param pool threads to spread the work over
+     * \return interleaved outputs, (numOutputs * populationSize) x number of samples
+     */
+    [[nodiscard]] Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> FeedForwardBatch(
+        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs, ThreadPool& pool) const;
+
+    /**
+     * \brief evaluate every individual on a shared batch of inputs
+     * \param inputs matrix with one input vector per column
+     * \param fitness called concurrently as fitness(individual, outputs) with one output vector per column,
+     *  returns the fitness of the individual, higher is better
+     * \param pool threads to spread the work over
+     */
+    void EvaluateBatch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                       const std::function<double(int individual,
+                                                  const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>&
+                                                  outputs)>& fitness, ThreadPool& pool);
+
+    /**
+     * \brief evaluate every individual with an arbitrary objective, e.g. a simulated game episode;
+     *  each thread reuses one network that the individuals are copied into
+     * \param fitness called concurrently with a network holding the individual, returns its fitness,
+     *  higher is better
+     * \param pool threads to spread the work over
+     */
+    void Evaluate(const std::function<double(const NeuralNetwork& network)>& fitness, ThreadPool& pool);
+
+    /**
+     * \brief replace the population with the next generation, the elites are kept unchanged and the others are
+     *  bred from tournament-selected parents by crossover and mutation
+     * \param numElites number of fittest individuals to keep
+     * \param tournamentSize number of individuals competing for each parent slot
+     * \param mutationRate probability of mutating each parameter of a child
+     * \param mutationStrength standard deviation of the mutation noise
+     */
+    void NextGeneration(int numElites, int tournamentSize, double mutationRate, double mutationStrength);
+};
+#endif // NEUROEVOLUTIONPOPULATION_H
@@ -4,19 +4,25 @@
 // //FileType: Visual C++ Source file
 // //Author : Anders P. Åsbø
 // //Created On : 15/2/2024
-// //Last Modified On : 22/2/2024
+// //Last Modified On : 19/10/2026
 // //Description :
 // //////////////////////////////////////////////////////////////////////////
 // //////////////////////////////
 
 #include "NeuronLayer.h"
 
+#include <algorithm>
 #include <random>
+#include <stdexcept>
 
+#include "SimdKernels.h"
 
-void NeuronLayer::CalcOutputs() {
-    // in-place calculation of the outputs using matrix multiplication and vector addition
-    outputs = weights * inputs + biases;
+namespace {
+    void CheckActivationFunction(const EActivationFunction activationFunction) {
+        if (activationFunction > EActivationFunction::NONE) {
+            throw std::invalid_argument("Invalid activation function");
+        }
+    }
 }
 
 NeuronLayer::NeuronLayer(int numberOfNeurons, int numberOfNeuronInputs): numNeurons(numberOfNeurons),
@@ -26,6 +32,10 @@ NeuronLayer::NeuronLayer(int numberOfNeurons, int numberOfNeuronInputs): numNeur
     std::mt19937_64 gen{rd()};
     std::uniform_real_distribution<double> distribution{-1, 1};
 
+    // allocate storage for the weights and biases and point the maps at it
+    _ownedParameters.resize(NumParameters(numNeurons, numNeuronInputs));
+    BindParameters(_ownedParameters.data());
+
     // Initialize the outputs, weights and biases with zeros, random values and random values, respectively
     outputs = Eigen::VectorXd::Zero(numNeurons);
     weights = Eigen::MatrixXd::NullaryExpr(numNeurons, numNeuronInputs,
@@ -36,19 +46,149 @@ NeuronLayer::NeuronLayer(int numberOfNeurons, int numberOfNeuronInputs): numNeur
     );
 }
 
+NeuronLayer::NeuronLayer(int numberOfNeurons, int numberOfNeuronInputs, double* parameters):
+    numNeurons(numberOfNeurons), numNeuronInputs(numberOfNeuronInputs) {
+    outputs = Eigen::VectorXd::Zero(numNeurons);
+    BindParameters(parameters);
+}
+
+NeuronLayer::NeuronLayer(const NeuronLayer& other): numNeurons(other.numNeurons),
+                                                    numNeuronInputs(other.numNeuronInputs), outputs(other.outputs),
+                                                    inputs(other.inputs) {
+    // deep copy, even if the other layer refers to external memory
+    _ownedParameters.assign(other.weights.data(),
+                            other.weights.data() + NumParameters(numNeurons, numNeuronInputs));
+    BindParameters(_ownedParameters.data());
+}
+
+NeuronLayer::NeuronLayer(NeuronLayer&& other) noexcept: numNeurons(other.numNeurons),
+                                                        numNeuronInputs(other.numNeuronInputs),
+                                                        outputs(std::move(other.outputs)),
+                                                        inputs(std::move(other.inputs)) {
+    // the data pointer of a moved vector stays valid, external memory is simply shared
+    const bool ownsParameters = other.OwnsParameters();
+    double* parameters = other.weights.data();
+    _ownedParameters = std::move(other._ownedParameters);
+    BindParameters(ownsParameters ? _ownedParameters.data() : parameters);
+    BindGradients(other.weightGradients.data());
+    other.BindParameters(nullptr);
+    other.BindGradients(nullptr);
+}
+
+NeuronLayer& NeuronLayer::operator=(const NeuronLayer& other) {
+    if (this != &other) { *this = NeuronLayer(other); }
+    return *this;
+}
+
+NeuronLayer& NeuronLayer::operator=(NeuronLayer&& other) noexcept {
+    if (this != &other) {
+        numNeurons = other.numNeurons;
+        numNeuronInputs = other.numNeuronInputs;
+        outputs = std::move(other.outputs);
+        inputs = std::move(other.inputs);
+
+        const bool ownsParameters = other.OwnsParameters();
+        double* parameters = other.weights.data();
+        _ownedParameters = std::move(other._ownedParameters);
+        BindParameters(ownsParameters ? _ownedParameters.data() : parameters);
+        BindGradients(other.weightGradients.data());
+        other.BindParameters(nullptr);
+        other.BindGradients(nullptr);
+    }
+    return *this;
+}
+
+void NeuronLayer::BindParameters(double* parameters) {
+    // Eigen::Map cannot be reassigned to new memory, so it is reconstructed in place
+    const int rows = parameters != nullptr ? numNeurons : 0;
+    const int cols = parameters != nullptr ? numNeuronInputs : 0;
+    new(&weights) Eigen::Map<Eigen::MatrixXd>(parameters, rows, cols);
+    new(&biases) Eigen::Map<Eigen::VectorXd>(parameters != nullptr ? parameters + rows * cols : nullptr, rows);
+}
+
+void NeuronLayer::RelocateParameters(double* parameters) {
+    if (parameters == weights.data()) { return; }
+    if (weights.data() != nullptr) {
+        std::copy_n(weights.data(), NumParameters(numNeurons, numNeuronInputs), parameters);
+    }
+    BindParameters(parameters);
+    _ownedParameters = std::vector<double>();
+}
+
+void NeuronLayer::BindGradients(double* gradients) {
+    const int rows = gradients != nullptr ? numNeurons : 0;
+    const int cols = gradients != nullptr ? numNeuronInputs : 0;
+    new(&weightGradients) Eigen::Map<Eigen::MatrixXd>(gradients, rows, cols);
+    new(&biasGradients) Eigen::Map<Eigen::VectorXd>(gradients != nullptr ? gradients + rows * cols : nullptr, rows);
+}
+
 Eigen::Vector<double, Eigen::Dynamic> NeuronLayer::CalcOutputs(const Eigen::Vector<double, Eigen::Dynamic>& Inputs,
                                                                EActivationFunction activationFunction) {
+    CheckActivationFunction(activationFunction);
+    eigen_assert(Inputs.size() == numNeuronInputs);
     inputs = Inputs; // store the inputs
 
-    // in-place calculation of the outputs
-    CalcOutputs();
+    // one kernel stores the net outputs and returns the activated ones
+    outputs.resize(numNeurons);
+    Eigen::Vector<double, Eigen::Dynamic> activatedOutputs(numNeurons);
+    SimdKernels::Get().layerForward(weights.data(), numNeurons, biases.data(), inputs.data(), numNeurons,
+                                    numNeuronInputs, 1, activationFunction, activatedOutputs.data(), outputs.data());
+    return activatedOutputs;
+}
 
-    // create a vector to store the activated outputs
-    Eigen::Vector<double, Eigen::Dynamic> activatedOutputs = outputs;
+Eigen::Vector<double, Eigen::Dynamic> NeuronLayer::CalcOutputs(const Eigen::Vector<double, Eigen::Dynamic>& Inputs,
+                                                               EActivationFunction activationFunction) const {
+    CheckActivationFunction(activationFunction);
+    eigen_assert(Inputs.size() == numNeuronInputs);
+    Eigen::Vector<double, Eigen::Dynamic> activatedOutputs(numNeurons);
+    SimdKernels::Get().layerForward(weights.data(), numNeurons, biases.data(), Inputs.data(), numNeurons,
+                                    numNeuronInputs, 1, activationFunction, activatedOutputs.data(), nullptr);
+    return activatedOutputs;
+}
 
-    // Apply the activation function to each output
-    for (auto& activatedOutput : activatedOutputs) {
-        activatedOutput = ActivationLib::ActivationFunction(activatedOutput, activationFunction);
-    }
+Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> NeuronLayer::CalcOutputsBatch(
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& Inputs,
+    EActivationFunction activationFunction) const {
+    CheckActivationFunction(activationFunction);
+    eigen_assert(Inputs.rows() == numNeuronInputs);
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> activatedOutputs(numNeurons, Inputs.cols());
+    SimdKernels::Get().layerForward(weights.data(), numNeurons, biases.data(), Inputs.data(), numNeurons,
+                                    numNeuronInputs, static_cast<int>(Inputs.cols()), activationFunction,
+                                    activatedOutputs.data(), nullptr);
     return activatedOutputs;
 }
+
+void NeuronLayer::ApplyActivationFunction(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> values,
+                                          EActivationFunction activationFunction) {
+    CheckActivationFunction(activationFunction);
+    const SimdKernelTable& kernels = SimdKernels::Get();
+    if (values.outerStride() == values.rows()) {
+        kernels.activate(values.data(), static_cast<std::size_t>(values.size()), activationFunction);
+        return;
+    }
+    for (Eigen::Index j = 0; j < values.cols(); ++j) {
+        kernels.activate(values.col(j).data(), static_cast<std::size_t>(values.rows()), activationFunction);
+    }
+}
+
+void NeuronLayer::ApplyActivationFunctionDerivative(
+    Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> values,
+    EActivationFunction activationFunction) {
+    switch (activationFunction) {
+    case EActivationFunction::HEAVISIDE_STEP_FUNCTION:
+    case EActivationFunction::NONE:
+        values.setOnes();
+        return;
+    case EActivationFunction::SIGMOID_FUNCTION:
+        values = (1.0 / (1.0 + (-values.array()).exp())).matrix();
+        values = (values.array() * (1.0 - values.array())).matrix();
+        return;
+    case EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION:
+        values = (1.0 - values.array().tanh().square()).matrix();
+        return;
+    case EActivationFunction::RELU_FUNCTION:
+        values = (values.array() > 0.0).cast<double>().matrix();
+        return;
+    }
+    throw std::invalid_argument("Invalid activation function");
+}
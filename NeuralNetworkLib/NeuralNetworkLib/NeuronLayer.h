@@ -4,7 +4,7 @@
 // //FileType: Visual C++ Source file
 // //Author : Anders P. Åsbø
 // //Created On : 15/2/2024
-// //Last Modified On : 22/2/2024
+// //Last Modified On : 19/10/2026
 // //Description :
 // //////////////////////////////////////////////////////////////////////////
 // //////////////////////////////
@@ -15,23 +15,35 @@
 #ifndef NEURONLAYER_H
 #define NEURONLAYER_H
 
+#include <vector>
+
 #include "ActivationLib.h"
+#include "AllocationTracker.h"
 #include "../Eigen/Eigen"
 
 class NeuronLayer {
 private:
-    /**
-     * \brief in-place calculation of the outputs of the layer
-     */
-    void CalcOutputs();
+    std::vector<double> _ownedParameters{}; // Storage for weights and biases unless bound to external memory
 
 public:
     int numNeurons{}; // Holds the number of neurons in this layer
     int numNeuronInputs{}; // Holds the number of inputs to each neuron
     Eigen::Vector<double, Eigen::Dynamic> outputs{}; // Holds the net outputs of each neuron in this layer
     Eigen::Vector<double, Eigen::Dynamic> inputs{}; // Holds the inputs to each neuron in this layer
-    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> weights{}; // Holds the weights of each neuron in this layer
-    Eigen::Vector<double, Eigen::Dynamic> biases{}; // Holds the biases of each neuron in this layer
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> weights{nullptr, 0, 0}; // Holds the weights of each neuron in this layer
+    Eigen::Map<Eigen::Vector<double, Eigen::Dynamic>> biases{nullptr, 0}; // Holds the biases of each neuron in this layer
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> weightGradients{nullptr, 0, 0}; // Holds the gradients of the weights, bound by the owning network
+    Eigen::Map<Eigen::Vector<double, Eigen::Dynamic>> biasGradients{nullptr, 0}; // Holds the gradients of the biases, bound by the owning network
+
+    /**
+     * \brief number of parameters (weights followed by biases) of a layer with the given shape
+     * \param numberOfNeurons number of neurons in the layer
+     * \param numberOfNeuronInputs number of inputs to each neuron
+     * \return number of doubles needed to store the parameters
+     */
+    static int NumParameters(const int numberOfNeurons, const int numberOfNeuronInputs) {
+        return numberOfNeurons * numberOfNeuronInputs + numberOfNeurons;
+    }
 
     /**
      * \brief construct an empty neuron layer
@@ -45,6 +57,50 @@ public:
      */
     NeuronLayer(int numberOfNeurons, int numberOfNeuronInputs);
 
+    /**
+     * \brief construct a neuron layer whose weights and biases live in external memory, nothing is copied
+     * \param numberOfNeurons number of neurons in the layer
+     * \param numberOfNeuronInputs number of inputs to each neuron
+     * \param parameters column-major weights followed by the biases, must outlive the layer
+     */
+    NeuronLayer(int numberOfNeurons, int numberOfNeuronInputs, double* parameters);
+
+    /**
+     * \brief copying a layer always copies its parameters into storage owned by the new layer,
+     *  gradients are left unbound
+     */
+    NeuronLayer(const NeuronLayer& other);
+    NeuronLayer(NeuronLayer&& other) noexcept;
+    NeuronLayer& operator=(const NeuronLayer& other);
+    NeuronLayer& operator=(NeuronLayer&& other) noexcept;
+    ~NeuronLayer() = default;
+
+    /**
+     * \brief point the weights and biases at the given memory without copying
+     * \param parameters column-major weights followed by the biases
+     */
+    void BindParameters(double* parameters);
+
+    /**
+     * \brief copy the weights and biases to the given memory, point the layer at it and free any owned storage
+     * \param parameters memory for the column-major weights followed by the biases, must outlive the layer
+     */
+    void RelocateParameters(double* parameters);
+
+    /**
+     * \brief point the weight and bias gradients at the given memory without copying
+     * \param gradients column-major weight gradients followed by the bias gradients
+     */
+    void BindGradients(double* gradients);
+
+    /**
+     * \brief check whether the parameters are stored in memory owned by the layer
+     * \return true if the layer owns its parameters
+     */
+    [[nodiscard]] bool OwnsParameters() const {
+        return !_ownedParameters.empty() && weights.data() == _ownedParameters.data();
+    }
+
     /**
      * \brief calculate the outputs of the layer
      * \param inputs vector of inputs to the layer
@@ -53,5 +109,44 @@ public:
      */
     Eigen::Vector<double, Eigen::Dynamic> CalcOutputs(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
                                                       EActivationFunction activationFunction);
+
+    /**
+     * \brief calculate the outputs of the layer without storing the inputs and net outputs,
+     *  so a layer can be evaluated from several threads at once
+     * \param inputs vector of inputs to the layer
+     * \param activationFunction activation function to apply to the outputs
+     * \return activated outputs
+     */
+    Eigen::Vector<double, Eigen::Dynamic> CalcOutputs(const Eigen::Vector<double, Eigen::Dynamic>& inputs,
+                                                      EActivationFunction activationFunction) const;
+
+    /**
+     * \brief calculate the outputs of the layer for a batch of samples with one matrix-matrix product,
+     *  without storing anything, so a layer can be evaluated from several threads at once
+     * \param inputs matrix with one sample per column
+     * \param activationFunction activation function to apply to the outputs
+     * \return activated outputs, one column per sample
+     */
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> CalcOutputsBatch(
+        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+        EActivationFunction activationFunction) const;
+
+    /**
+     * \brief apply an activation function to every element of a matrix in place with the SIMD kernels
+     * \param values net outputs to activate
+     * \param activationFunction activation function to apply
+     */
+    static void ApplyActivationFunction(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> values,
+                                        EActivationFunction activationFunction);
+
+    /**
+     * \brief replace every element of a matrix of net outputs by the derivative of an activation function there,
+     *  matching ActivationLib::ActivationFunctionDerivative
+     * \param values net outputs, overwritten by the derivatives
+     * \param activationFunction activation function to differentiate
+     */
+    static void ApplyActivationFunctionDerivative(
+        Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> values,
+        EActivationFunction activationFunction);
 };
 #endif // NEURONLAYER_H
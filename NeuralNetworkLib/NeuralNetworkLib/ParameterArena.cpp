@@ -0,0 +1,121 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ParameterArena.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "ParameterArena.h"
+
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <malloc.h>
+#else
+#include <cstdlib>
+#include <sys/mman.h>
+#endif
+
+namespace {
+    constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+    std::size_t RoundUp(const std::size_t value, const std::size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+}
+
+ParameterArena::ParameterArena(const std::size_t size, const bool useHugePages) : _size(size), _ownsData(true) {
+    if (size == 0) { return; }
+    const std::size_t bytes = size * sizeof(double);
+
+#ifdef _WIN32
+    if (useHugePages && GetLargePageMinimum() > 0) {
+        // large pages need the SeLockMemoryPrivilege, fall back to normal pages without it
+        _allocatedBytes = RoundUp(bytes, GetLargePageMinimum());
+        _data = static_cast<double*>(VirtualAlloc(nullptr, _allocatedBytes,
+                                                  MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+        _hugePages = _data != nullptr;
+        _mapped = _hugePages;
+    }
+    if (_data == nullptr) {
+        _allocatedBytes = RoundUp(bytes, alignment);
+        _data = static_cast<double*>(_aligned_malloc(_allocatedBytes, alignment));
+    }
+#else
+    if (useHugePages) {
+        // anonymous mappings are page aligned, transparent huge pages are requested with madvise
+        _allocatedBytes = RoundUp(bytes, hugePageSize);
+        void* data = mmap(nullptr, _allocatedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+            _hugePages = madvise(data, _allocatedBytes, MADV_HUGEPAGE) == 0;
+#endif
+            _data = static_cast<double*>(data);
+            _mapped = true;
+            return; // anonymous mappings are already zeroed
+        }
+    }
+    _allocatedBytes = RoundUp(bytes, alignment);
+    _data = static_cast<double*>(std::aligned_alloc(alignment, _allocatedBytes));
+#endif
+
+    if (_data == nullptr) { throw std::bad_alloc(); }
+    if (!_mapped) { std::memset(_data, 0, _allocatedBytes); }
+}
+
+ParameterArena::ParameterArena(double* data, const std::size_t size) : _data(data), _size(size) {}
+
+ParameterArena::~ParameterArena() {
+    Release();
+}
+
+ParameterArena::ParameterArena(ParameterArena&& other) noexcept : _data(other._data), _size(other._size),
+                                                                 _allocatedBytes(other._allocatedBytes),
+                                                                 _ownsData(other._ownsData),
+                                                                 _mapped(other._mapped),
+                                                                 _hugePages(other._hugePages) {
+    other._data = nullptr;
+    other._size = 0;
+    other._ownsData = false;
+}
+
+ParameterArena& ParameterArena::operator=(ParameterArena&& other) noexcept {
+    if (this != &other) {
+        Release();
+        _data = other._data;
+        _size = other._size;
+        _allocatedBytes = other._allocatedBytes;
+        _ownsData = other._ownsData;
+        _mapped = other._mapped;
+        _hugePages = other._hugePages;
+        other._data = nullptr;
+        other._size = 0;
+        other._ownsData = false;
+    }
+    return *this;
+}
+
+void ParameterArena::Release() {
+    if (_ownsData && _data != nullptr) {
+#ifdef _WIN32
+        if (_mapped) { VirtualFree(_data, 0, MEM_RELEASE); }
+        else { _aligned_free(_data); }
+#else
+        if (_mapped) { munmap(_data, _allocatedBytes); }
+        else { std::free(_data); }
+#endif
+    }
+    _data = nullptr;
+    _size = 0;
+    _ownsData = false;
+    _mapped = false;
+    _hugePages = false;
+}
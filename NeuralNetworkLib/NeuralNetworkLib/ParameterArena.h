@@ -0,0 +1,81 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ParameterArena.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : aligned contiguous storage for the parameters of a whole network
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef PARAMETERARENA_H
+#define PARAMETERARENA_H
+
+#include <cstddef>
+
+/**
+ * \brief One contiguous, cache-line aligned block of doubles.
+ *
+ * A network keeps all of its parameters in one arena and all of its gradients in another, and its layers
+ * hold Eigen::Map views into them. The arena can optionally be backed by huge pages to reduce TLB misses for
+ * large models, and it can also be a non-owning view of memory that lives elsewhere, e.g. a mapped model file.
+ */
+class ParameterArena {
+private:
+    double* _data{};
+    std::size_t _size{};
+    std::size_t _allocatedBytes{};
+    bool _ownsData{};
+    bool _mapped{}; // allocated with mmap/VirtualAlloc instead of an aligned malloc
+    bool _hugePages{};
+
+    /**
+     * \brief free the memory if it is owned by the arena
+     */
+    void Release();
+
+public:
+    static constexpr std::size_t alignment = 64;
+
+    ParameterArena() = default;
+
+    /**
+     * \brief allocate a zero-initialised arena
+     * \param size number of doubles
+     * \param useHugePages back the arena by huge pages if the system allows it, falls back to normal pages
+     */
+    explicit ParameterArena(std::size_t size, bool useHugePages = false);
+
+    /**
+     * \brief view external memory as an arena without taking ownership
+     * \param data first double, must outlive the arena
+     * \param size number of doubles
+     */
+    ParameterArena(double* data, std::size_t size);
+
+    ~ParameterArena();
+
+    ParameterArena(const ParameterArena&) = delete;
+    ParameterArena& operator=(const ParameterArena&) = delete;
+    ParameterArena(ParameterArena&& other) noexcept;
+    ParameterArena& operator=(ParameterArena&& other) noexcept;
+
+    /**
+     * \brief first double of the arena
+     * \return pointer to the data, null if the arena is empty
+     */
+    [[nodiscard]] double* Data() const { return _data; }
+
+    /**
+     * \brief number of doubles in the arena
+     * \return size of the arena
+     */
+    [[nodiscard]] std::size_t Size() const { return _size; }
+
+    /**
+     * \brief check whether the arena ended up on huge pages
+     * \return true if huge pages were requested and granted
+     */
+    [[nodiscard]] bool UsesHugePages() const { return _hugePages; }
+};
+#endif // PARAMETERARENA_H
@@ -0,0 +1,368 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: PipelineNetwork.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "PipelineNetwork.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "SimdKernels.h"
+#include "Tracer.h"
+
+PipelineNetwork::PipelineNetwork(NeuralNetwork& network, int numStages, const int microBatchSize) :
+    _network(network), _hiddenActivationFunction(network.GetHiddenActivationFunction()),
+    _outputActivationFunction(network.GetOutputActivationFunction()), _microBatchSize(microBatchSize),
+    _outputQueue(8) {
+    const auto numLayers = static_cast<int>(network.GetLayers().size());
+    if (numStages <= 0 || microBatchSize <= 0 || numLayers == 0) {
+        throw std::invalid_argument("The pipeline needs at least one stage, layer and sample per micro-batch");
+    }
+    numStages = std::min(numStages, numLayers);
+
+    Eigen::Index offset{};
+    for (const auto& layer : network.GetLayers()) {
+        _layerShapes.push_back({layer.numNeurons, layer.numNeuronInputs, offset});
+        offset += NeuronLayer::NumParameters(layer.numNeurons, layer.numNeuronInputs);
+    }
+
+    // contiguous stages with about the same number of parameters, each with at least one layer
+    Eigen::Index assigned{};
+    int firstLayer = 0;
+    for (int s = 0; s < numStages; ++s) {
+        const int remainingStages = numStages - s;
+        const double target = static_cast<double>(offset - assigned) / remainingStages;
+        int endLayer = firstLayer + 1;
+        Eigen::Index stageParameters = NeuronLayer::NumParameters(_layerShapes[firstLayer].numNeurons,
+                                                                  _layerShapes[firstLayer].numNeuronInputs);
+        while (endLayer < numLayers - (remainingStages - 1)) {
+            const Eigen::Index next = NeuronLayer::NumParameters(_layerShapes[endLayer].numNeurons,
+                                                                  _layerShapes[endLayer].numNeuronInputs);
+            if (remainingStages > 1 && static_cast<double>(stageParameters) + 0.5 * next > target) { break; }
+            stageParameters += next;
+            ++endLayer;
+        }
+
+        auto stage = std::make_unique<Stage>(8);
+        stage->firstLayer = firstLayer;
+        stage->endLayer = endLayer;
+        _stages.push_back(std::move(stage));
+        assigned += stageParameters;
+        firstLayer = endLayer;
+    }
+
+    for (int s = 0; s < numStages; ++s) { _stages[s]->thread = std::thread(&PipelineNetwork::RunStage, this, s); }
+}
+
+PipelineNetwork::~PipelineNetwork() {
+    // the stop message is passed down the pipeline, so every queue keeps a single producer
+    Message stop{EMessage::STOP};
+    Send(_stages.front()->forwardQueue, stop, _stages.front().get());
+    for (const auto& stage : _stages) { stage->thread.join(); }
+}
+
+std::pair<int, int> PipelineNetwork::GetStageLayers(const int stage) const {
+    return {_stages[stage]->firstLayer, _stages[stage]->endLayer};
+}
+
+void PipelineNetwork::Wake(Stage& stage) {
+    // pairs with the fence in RunStage, either the stage sees the new message or we see it parked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (stage.parked.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard lock(stage.mutex);
+            stage.parked.store(false, std::memory_order_relaxed);
+        }
+        stage.condition.notify_one();
+    }
+}
+
+void PipelineNetwork::Send(SpscQueue<Message>& queue, Message& message, Stage* consumer) {
+    while (!queue.TryPush(message)) { std::this_thread::yield(); }
+    if (consumer != nullptr) { Wake(*consumer); }
+}
+
+void PipelineNetwork::CheckForErrors() {
+    if (_failed.load(std::memory_order_acquire)) {
+        std::lock_guard lock(_mutex);
+        std::rethrow_exception(_stageError);
+    }
+}
+
+void PipelineNetwork::RunStage(const int stageIndex) {
+    Tracer::SetThreadName("pipeline stage " + std::to_string(stageIndex));
+    Stage& stage = *_stages[stageIndex];
+    const bool isFirst = stageIndex == 0;
+    const bool isLast = stageIndex == GetNumStages() - 1;
+    Stage* next = isLast ? nullptr : _stages[stageIndex + 1].get();
+    Stage* previous = isFirst ? nullptr : _stages[stageIndex - 1].get();
+
+    Message message{};
+    int idleRounds{};
+    while (true) {
+        // back propagation first, it frees the kept activations
+        if (!stage.backwardQueue.TryPop(message) && !stage.forwardQueue.TryPop(message)) {
+            if (++idleRounds < 256) {
+                std::this_thread::yield();
+                continue;
+            }
+            stage.parked.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!stage.forwardQueue.Empty() || !stage.backwardQueue.Empty()) {
+                stage.parked.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            std::unique_lock lock(stage.mutex);
+            stage.condition.wait(lock, [&stage] { return !stage.parked.load(std::memory_order_relaxed); });
+            idleRounds = 0;
+            continue;
+        }
+        idleRounds = 0;
+
+        try {
+            switch (message.kind) {
+            case EMessage::STOP:
+                if (next != nullptr) { Send(next->forwardQueue, message, next); }
+                return;
+            case EMessage::FORWARD:
+                Forward(stageIndex, message);
+                if (next != nullptr) { Send(next->forwardQueue, message, next); }
+                else if (!_training) { Send(_outputQueue, message, nullptr); }
+                else {
+                    const int k = message.microBatch;
+                    const Eigen::Index firstColumn = static_cast<Eigen::Index>(k) * _microBatchSize;
+                    message.values = _targets->middleCols(firstColumn, message.values.cols()) - message.values;
+                    _batchError += 0.5 * message.values.squaredNorm() / static_cast<double>(message.values.rows());
+                    stage.outputErrors[k] = std::move(message.values);
+
+                    // GPipe: the backward pass starts once every micro-batch has been fed forward
+                    if (++stage.numForwarded == _numMicroBatches) {
+                        for (int j = _numMicroBatches - 1; j >= 0; --j) {
+                            Message backward{EMessage::BACKWARD, j, std::move(stage.outputErrors[j])};
+                            Backward(stageIndex, j, backward.values);
+                            if (previous != nullptr) { Send(previous->backwardQueue, backward, previous); }
+                        }
+                    }
+                }
+                break;
+            case EMessage::BACKWARD:
+                Backward(stageIndex, message.microBatch, message.values);
+                if (previous != nullptr) { Send(previous->backwardQueue, message, previous); }
+                break;
+            }
+        }
+        catch (...) {
+            {
+                std::lock_guard lock(_mutex);
+                if (!_stageError) { _stageError = std::current_exception(); }
+            }
+            _failed.store(true, std::memory_order_release);
+            _batchFinished.notify_all();
+        }
+    }
+}
+
+void PipelineNetwork::Forward(const int stageIndex, Message& message) {
+    Stage& stage = *_stages[stageIndex];
+    const int k = message.microBatch;
+    TraceSpan span("forward", "micro-batch", k);
+    if (_training && k == 0) {
+        // storage is kept between batches, so steady-state training reuses it
+        const auto numStageLayers = static_cast<std::size_t>(stage.endLayer - stage.firstLayer);
+        stage.inputs.resize(_numMicroBatches, std::vector<Eigen::MatrixXd>(numStageLayers));
+        stage.netOutputs.resize(_numMicroBatches, std::vector<Eigen::MatrixXd>(numStageLayers));
+        stage.outputErrors.resize(_numMicroBatches);
+    }
+
+    const double* parameters = _network.GetParameters().data();
+    const auto numLayers = static_cast<int>(_layerShapes.size());
+    for (int i = stage.firstLayer; i < stage.endLayer; ++i) {
+        const LayerShape& shape = _layerShapes[i];
+        const double* weights = parameters + shape.offset;
+        const double* biases = weights + static_cast<std::ptrdiff_t>(shape.numNeurons) * shape.numNeuronInputs;
+
+        // the net outputs are only needed by the backward pass
+        const auto numSamples = static_cast<int>(message.values.cols());
+        Eigen::MatrixXd netOutputs(_training ? shape.numNeurons : 0, numSamples);
+        Eigen::MatrixXd activatedOutputs(shape.numNeurons, numSamples);
+        SimdKernels::Get().layerForward(weights, shape.numNeurons, biases, message.values.data(), shape.numNeurons,
+                                        shape.numNeuronInputs, numSamples,
+                                        i == numLayers - 1 ? _outputActivationFunction : _hiddenActivationFunction,
+                                        activatedOutputs.data(), _training ? netOutputs.data() : nullptr);
+
+        if (_training) {
+            const int l = i - stage.firstLayer;
+            stage.inputs[k][l] = std::move(message.values);
+            stage.netOutputs[k][l] = std::move(netOutputs);
+        }
+        message.values = std::move(activatedOutputs);
+    }
+}
+
+void PipelineNetwork::Backward(const int stageIndex, const int microBatch,
+                               Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& sums) {
+    TraceSpan span("backward", "micro-batch", microBatch);
+    Stage& stage = *_stages[stageIndex];
+    double* parameters = _network.GetParameters().data();
+    double* gradients = _network.GetGradients().data();
+    const auto numLayers = static_cast<int>(_layerShapes.size());
+
+    // every layer of a stage is contiguous in the arenas
+    const Eigen::Index stageBegin = _layerShapes[stage.firstLayer].offset;
+    const LayerShape& lastShape = _layerShapes[stage.endLayer - 1];
+    const Eigen::Index stageSize = lastShape.offset - stageBegin +
+        NeuronLayer::NumParameters(lastShape.numNeurons, lastShape.numNeuronInputs);
+    Eigen::Map<Eigen::VectorXd> stageGradients(gradients + stageBegin, stageSize);
+    if (stage.numBackPropagated == 0) { stageGradients.setZero(); }
+
+    // same rules as NeuralNetwork::CalcGradients, batched over the columns of the micro-batch
+    for (int i = stage.endLayer - 1; i >= stage.firstLayer; --i) {
+        const int l = i - stage.firstLayer;
+        const LayerShape& shape = _layerShapes[i];
+        const Eigen::Index numWeights = static_cast<Eigen::Index>(shape.numNeurons) * shape.numNeuronInputs;
+        const Eigen::Map<const Eigen::MatrixXd> weights(parameters + shape.offset, shape.numNeurons,
+                                                        shape.numNeuronInputs);
+        Eigen::Map<Eigen::MatrixXd> weightGradients(gradients + shape.offset, shape.numNeurons,
+                                                    shape.numNeuronInputs);
+        Eigen::Map<Eigen::VectorXd> biasGradients(gradients + shape.offset + numWeights, shape.numNeurons);
+
+        const bool isOutputLayer = i == numLayers - 1;
+        Eigen::MatrixXd& derivatives = stage.netOutputs[microBatch][l];
+        NeuronLayer::ApplyActivationFunctionDerivative(derivatives, isOutputLayer
+                                                                        ? _outputActivationFunction
+                                                                        : _hiddenActivationFunction);
+        const Eigen::MatrixXd deltas = sums.cwiseProduct(derivatives);
+
+        // the output layer's gradients are taken from the raw errors, like in NeuralNetwork::CalcGradients
+        const Eigen::MatrixXd& layerGradients = isOutputLayer ? sums : deltas;
+        weightGradients.noalias() += layerGradients * stage.inputs[microBatch][l].transpose();
+        biasGradients += layerGradients.rowwise().sum();
+
+        if (i > 0) { sums.noalias() = weights.transpose() * deltas; }
+    }
+
+    if (++stage.numBackPropagated == _numMicroBatches) {
+        // every micro-batch has passed, so the stage applies the averaged gradients to its own layers
+        Eigen::Map<Eigen::VectorXd>(parameters + stageBegin, stageSize) +=
+            _network.GetLearningRate() / static_cast<double>(_batchSize) * stageGradients;
+        stage.numForwarded = 0;
+        stage.numBackPropagated = 0;
+
+        if (stageIndex == 0) {
+            {
+                std::lock_guard lock(_mutex);
+                ++_numFinishedBatches;
+            }
+            _batchFinished.notify_all();
+        }
+    }
+}
+
+void PipelineNetwork::QueueMicroBatches(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs) {
+    Stage& first = *_stages.front();
+    for (int k = 0; k < _numMicroBatches; ++k) {
+        const Eigen::Index firstColumn = static_cast<Eigen::Index>(k) * _microBatchSize;
+        Message message{EMessage::FORWARD, k,
+                        inputs.middleCols(firstColumn, std::min<Eigen::Index>(_microBatchSize,
+                                                                              inputs.cols() - firstColumn))};
+        Send(first.forwardQueue, message, &first);
+    }
+}
+
+Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> PipelineNetwork::FeedForwardBatch(
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs) {
+    if (inputs.rows() != _layerShapes.front().numNeuronInputs) {
+        throw std::invalid_argument("Number of inputs does not match the network");
+    }
+    CheckForErrors();
+
+    _training = false;
+    _numMicroBatches = static_cast<int>((inputs.cols() + _microBatchSize - 1) / _microBatchSize);
+    Eigen::MatrixXd outputs(_layerShapes.back().numNeurons, inputs.cols());
+
+    // the caller feeds the first stage and drains the last one, so neither end can block the other
+    Stage& first = *_stages.front();
+    int numQueued{};
+    int numReceived{};
+    Message pending{};
+    Message result{};
+    while (numReceived < _numMicroBatches) {
+        bool progressed{};
+        if (numQueued < _numMicroBatches) {
+            if (pending.values.size() == 0) {
+                const Eigen::Index firstColumn = static_cast<Eigen::Index>(numQueued) * _microBatchSize;
+                pending = {EMessage::FORWARD, numQueued,
+                           inputs.middleCols(firstColumn, std::min<Eigen::Index>(_microBatchSize,
+                                                                                 inputs.cols() - firstColumn))};
+            }
+            if (first.forwardQueue.TryPush(pending)) {
+                Wake(first);
+                pending.values.resize(0, 0);
+                ++numQueued;
+                progressed = true;
+            }
+        }
+        while (_outputQueue.TryPop(result)) {
+            outputs.middleCols(static_cast<Eigen::Index>(result.microBatch) * _microBatchSize,
+                               result.values.cols()) = result.values;
+            ++numReceived;
+            progressed = true;
+        }
+        if (!progressed) {
+            CheckForErrors();
+            std::this_thread::yield();
+        }
+    }
+    return outputs;
+}
+
+double PipelineNetwork::TrainBatch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                                   const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets) {
+    if (inputs.rows() != _layerShapes.front().numNeuronInputs || targets.rows() != _layerShapes.back().numNeurons ||
+        inputs.cols() != targets.cols()) {
+        throw std::invalid_argument("Inputs and targets do not match the network");
+    }
+    if (inputs.cols() == 0) { return 0.0; }
+    CheckForErrors();
+    TraceSpan span("mini-batch", "samples", inputs.cols());
+
+    _training = true;
+    _targets = &targets;
+    _numMicroBatches = static_cast<int>((inputs.cols() + _microBatchSize - 1) / _microBatchSize);
+    _batchSize = inputs.cols();
+    _batchError = 0.0;
+
+    int finishedBatches{};
+    {
+        std::lock_guard lock(_mutex);
+        finishedBatches = _numFinishedBatches;
+    }
+    QueueMicroBatches(inputs);
+
+    std::unique_lock lock(_mutex);
+    _batchFinished.wait(lock, [&] { return _numFinishedBatches > finishedBatches || _stageError; });
+    if (_stageError) { std::rethrow_exception(_stageError); }
+    return _batchError;
+}
+
+double PipelineNetwork::TrainEpoch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                                   const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets,
+                                   const int batchSize) {
+    if (batchSize <= 0) { throw std::invalid_argument("Batch size must be positive"); }
+
+    double meanSquareError{};
+    for (Eigen::Index first = 0; first < inputs.cols(); first += batchSize) {
+        const Eigen::Index count = std::min<Eigen::Index>(batchSize, inputs.cols() - first);
+        meanSquareError += TrainBatch(inputs.middleCols(first, count), targets.middleCols(first, count));
+    }
+    _network.FinishEpoch();
+    return meanSquareError;
+}
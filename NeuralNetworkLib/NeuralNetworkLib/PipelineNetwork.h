@@ -0,0 +1,205 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: PipelineNetwork.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : pipeline-parallel inference and training of deep networks
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef PIPELINENETWORK_H
+#define PIPELINENETWORK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "NeuralNetwork.h"
+#include "SpscQueue.h"
+
+/**
+ * \brief Runs a network as a pipeline of stages, each a contiguous run of layers owned by one thread.
+ *
+ * The layers are split into stages with about the same number of parameters, so each stage thread keeps its
+ * weights hot in its own core's cache. Batches are cut into micro-batches that stream from stage to stage through
+ * single-producer single-consumer queues, so all stages work at once on different micro-batches.
+ *
+ * Training follows the GPipe schedule: every micro-batch of a batch is fed forward while the stages keep their
+ * inputs and net outputs, then the micro-batches are back propagated in reverse order. Each stage sums the
+ * gradients of its layers and applies the averaged gradients to them once the last micro-batch has passed, so
+ * the update matches one mini-batch step of the whole network.
+ *
+ * The network must outlive the pipeline and keep its topology and activation functions, which are captured on
+ * construction, and it must not be used elsewhere while a call is running. Calls come from one thread at a time.
+ */
+class PipelineNetwork {
+private:
+    enum class EMessage : uint8_t {
+        FORWARD, // activations for the next stage
+        BACKWARD, // weights^T * deltas for the previous stage
+        STOP
+    };
+
+    struct Message {
+        EMessage kind{};
+        int microBatch{};
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> values{};
+    };
+
+    struct LayerShape {
+        int numNeurons;
+        int numNeuronInputs;
+        Eigen::Index offset; // index of the first weight in the parameter vector
+    };
+
+    struct Stage {
+        int firstLayer{};
+        int endLayer{}; // one past the last layer
+        SpscQueue<Message> forwardQueue; // from the previous stage, or the caller for the first stage
+        SpscQueue<Message> backwardQueue; // from the next stage
+        std::thread thread{};
+
+        // an idle stage sleeps until a producer wakes it
+        std::atomic<bool> parked{};
+        std::mutex mutex{};
+        std::condition_variable condition{};
+
+        // per micro-batch and layer of the stage, kept from the forward to the backward pass
+        std::vector<std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>>> inputs{};
+        std::vector<std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>>> netOutputs{};
+        std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>> outputErrors{}; // last stage only
+        int numForwarded{};
+        int numBackPropagated{};
+
+        explicit Stage(std::size_t queueCapacity) : forwardQueue(queueCapacity), backwardQueue(queueCapacity) {}
+    };
+
+    NeuralNetwork& _network;
+    std::vector<LayerShape> _layerShapes{};
+    EActivationFunction _hiddenActivationFunction{};
+    EActivationFunction _outputActivationFunction{};
+    int _microBatchSize{};
+    std::vector<std::unique_ptr<Stage>> _stages{};
+    SpscQueue<Message> _outputQueue; // inference results from the last stage
+
+    // batch in flight, written by the caller before the first micro-batch is queued
+    bool _training{};
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>* _targets{};
+    int _numMicroBatches{};
+    Eigen::Index _batchSize{};
+    double _batchError{}; // written by the last stage
+
+    // the first stage reports finished training batches, stage threads report errors
+    std::mutex _mutex{};
+    std::condition_variable _batchFinished{};
+    int _numFinishedBatches{};
+    std::exception_ptr _stageError{};
+    std::atomic<bool> _failed{};
+
+    /**
+     * \brief wake a stage if it is sleeping, called after pushing into one of its queues
+     */
+    static void Wake(Stage& stage);
+
+    /**
+     * \brief move a message into a queue, waiting while it is full, and wake the consuming stage
+     * \param queue queue to push into
+     * \param message message to move
+     * \param consumer stage popping from the queue, nullptr for the caller
+     */
+    static void Send(SpscQueue<Message>& queue, Message& message, Stage* consumer);
+
+    /**
+     * \brief rethrow the first error raised by a stage thread
+     */
+    void CheckForErrors();
+
+    /**
+     * \brief thread loop of a stage
+     */
+    void RunStage(int stage);
+
+    /**
+     * \brief feed a micro-batch through the layers of a stage
+     * \param stage index of the stage
+     * \param message activations from the previous stage, replaced by the activations of the stage
+     */
+    void Forward(int stage, Message& message);
+
+    /**
+     * \brief back propagate a micro-batch through the layers of a stage and add up their gradients
+     * \param stage index of the stage
+     * \param microBatch index of the micro-batch
+     * \param sums output errors for the last stage, weights^T * deltas of the next stage otherwise,
+     *  replaced by weights^T * deltas of the first layer of the stage
+     */
+    void Backward(int stage, int microBatch, Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& sums);
+
+    /**
+     * \brief queue every micro-batch of a batch into the first stage
+     */
+    void QueueMicroBatches(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs);
+
+public:
+    /**
+     * \brief start one thread per stage
+     * \param network network to run, its layers are split into stages
+     * \param numStages number of stages, at most one per layer
+     * \param microBatchSize samples per micro-batch
+     */
+    PipelineNetwork(NeuralNetwork& network, int numStages, int microBatchSize = 16);
+
+    /**
+     * \brief stop and join the stage threads
+     */
+    ~PipelineNetwork();
+
+    PipelineNetwork(const PipelineNetwork&) = delete;
+    PipelineNetwork& operator=(const PipelineNetwork&) = delete;
+
+    [[nodiscard]] int GetNumStages() const { return static_cast<int>(_stages.size()); }
+    [[nodiscard]] int GetMicroBatchSize() const { return _microBatchSize; }
+
+    /**
+     * \brief get the layers run by a stage
+     * \param stage index of the stage
+     * \return index of the first layer and one past the last layer
+     */
+    [[nodiscard]] std::pair<int, int> GetStageLayers(int stage) const;
+
+    /**
+     * \brief feed a batch of inputs through the pipeline
+     * \param inputs matrix with one input vector per column
+     * \return outputs, one column per sample
+     */
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> FeedForwardBatch(
+        const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs);
+
+    /**
+     * \brief train on one mini-batch with the GPipe schedule, the parameters move by the learning rate times the
+     *  mean of the sample gradients
+     * \param inputs matrix with one input vector per column
+     * \param targets matrix with one target vector per column
+     * \return sum of the mean square errors of the samples
+     */
+    double TrainBatch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets);
+
+    /**
+     * \brief train for one epoch of mini-batches and finish the epoch of the network
+     * \param inputs matrix with one input vector per column
+     * \param targets matrix with one target vector per column
+     * \param batchSize samples per mini-batch
+     * \return sum of the mean square errors of the samples
+     */
+    double TrainEpoch(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+                      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& targets, int batchSize);
+};
+#endif // PIPELINENETWORK_H
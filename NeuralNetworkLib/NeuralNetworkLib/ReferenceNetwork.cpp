@@ -0,0 +1,132 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ReferenceNetwork.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "ReferenceNetwork.h"
+
+#include <stdexcept>
+
+namespace {
+    /**
+     * \brief net outputs and activated outputs of every layer for one sample
+     */
+    struct LayerValues {
+        std::vector<std::vector<double>> inputs{}; // inputs of each layer
+        std::vector<std::vector<double>> netOutputs{}; // weights * inputs + biases of each layer
+        std::vector<double> outputs{}; // activated outputs of the output layer
+    };
+
+    LayerValues Forward(const NeuralNetwork& network, const std::vector<double>& inputs) {
+        const std::vector<NeuronLayer>& layers = network.GetLayers();
+        if (static_cast<int>(inputs.size()) != network.GetNumInputs()) {
+            throw std::invalid_argument("Number of inputs does not match the network");
+        }
+
+        LayerValues values{};
+        std::vector<double> layerInputs = inputs;
+        for (int i = 0; i < static_cast<int>(layers.size()); ++i) {
+            const NeuronLayer& layer = layers[i];
+            const EActivationFunction activationFunction = i == static_cast<int>(layers.size()) - 1
+                                                               ? network.GetOutputActivationFunction()
+                                                               : network.GetHiddenActivationFunction();
+
+            std::vector<double> netOutputs(layer.numNeurons);
+            std::vector<double> activatedOutputs(layer.numNeurons);
+            for (int neuron = 0; neuron < layer.numNeurons; ++neuron) {
+                double sum = layer.biases[neuron];
+                for (int input = 0; input < layer.numNeuronInputs; ++input) {
+                    sum += layer.weights(neuron, input) * layerInputs[input];
+                }
+                netOutputs[neuron] = sum;
+                activatedOutputs[neuron] = ActivationLib::ActivationFunction(sum, activationFunction);
+            }
+
+            values.inputs.push_back(std::move(layerInputs));
+            values.netOutputs.push_back(std::move(netOutputs));
+            layerInputs = std::move(activatedOutputs);
+        }
+        values.outputs = std::move(layerInputs);
+        return values;
+    }
+}
+
+std::vector<double> ReferenceNetwork::FeedForward(const NeuralNetwork& network, const std::vector<double>& inputs) {
+    return Forward(network, inputs).outputs;
+}
+
+ReferencePass ReferenceNetwork::CalcGradients(const NeuralNetwork& network, const std::vector<double>& inputs,
+                                              const std::vector<double>& targets) {
+    const std::vector<NeuronLayer>& layers = network.GetLayers();
+    if (static_cast<int>(targets.size()) != network.GetNumOutputs()) {
+        throw std::invalid_argument("Number of targets does not match the network");
+    }
+
+    ReferencePass pass{};
+    LayerValues values = Forward(network, inputs);
+    const auto numLayers = static_cast<int>(layers.size());
+
+    std::vector<double> errors(targets.size());
+    for (std::size_t j = 0; j < targets.size(); ++j) {
+        errors[j] = targets[j] - values.outputs[j];
+        pass.meanSquareError += errors[j] * errors[j];
+    }
+    pass.meanSquareError = 0.5 * pass.meanSquareError / static_cast<double>(targets.size());
+    pass.outputs = std::move(values.outputs);
+
+    // offset of every layer in the parameter arena: column-major weights followed by the biases
+    std::vector<int> offsets(numLayers);
+    int numParameters{};
+    for (int i = 0; i < numLayers; ++i) {
+        offsets[i] = numParameters;
+        numParameters += NeuronLayer::NumParameters(layers[i].numNeurons, layers[i].numNeuronInputs);
+    }
+    pass.gradients.assign(numParameters, 0.0);
+
+    std::vector<double> deltas(errors.size());
+    for (int i = numLayers - 1; i >= 0; --i) {
+        const NeuronLayer& layer = layers[i];
+        const bool isOutputLayer = i == numLayers - 1;
+        const EActivationFunction activationFunction = isOutputLayer
+                                                           ? network.GetOutputActivationFunction()
+                                                           : network.GetHiddenActivationFunction();
+
+        // deltas of this layer: the errors, or weights^T * deltas of the layer above, times the derivative
+        std::vector<double> sums(layer.numNeurons);
+        if (isOutputLayer) { sums = errors; }
+        else {
+            const NeuronLayer& above = layers[i + 1];
+            for (int neuron = 0; neuron < layer.numNeurons; ++neuron) {
+                double sum{};
+                for (int k = 0; k < above.numNeurons; ++k) { sum += above.weights(k, neuron) * deltas[k]; }
+                sums[neuron] = sum;
+            }
+        }
+        std::vector<double> layerDeltas(layer.numNeurons);
+        for (int neuron = 0; neuron < layer.numNeurons; ++neuron) {
+            layerDeltas[neuron] = sums[neuron] * ActivationLib::ActivationFunctionDerivative(
+                values.netOutputs[i][neuron], activationFunction);
+        }
+
+        // the output layer's gradients are taken from the raw errors
+        const std::vector<double>& gradientSource = isOutputLayer ? errors : layerDeltas;
+        double* weightGradients = pass.gradients.data() + offsets[i];
+        double* biasGradients = weightGradients + static_cast<std::ptrdiff_t>(layer.numNeurons) *
+            layer.numNeuronInputs;
+        for (int input = 0; input < layer.numNeuronInputs; ++input) {
+            for (int neuron = 0; neuron < layer.numNeurons; ++neuron) {
+                weightGradients[input * layer.numNeurons + neuron] = gradientSource[neuron] * values.inputs[i][input];
+            }
+        }
+        for (int neuron = 0; neuron < layer.numNeurons; ++neuron) { biasGradients[neuron] = gradientSource[neuron]; }
+
+        deltas = std::move(layerDeltas);
+    }
+    return pass;
+}
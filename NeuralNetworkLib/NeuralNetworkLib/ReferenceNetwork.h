@@ -0,0 +1,56 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ReferenceNetwork.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : slow, straightforward forward and backward passes that the optimized engines are checked against
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef REFERENCENETWORK_H
+#define REFERENCENETWORK_H
+
+#include <vector>
+
+#include "NeuralNetwork.h"
+
+/**
+ * \brief Outputs of one sample computed by the reference engine, and the gradients it leads to
+ */
+struct ReferencePass {
+    std::vector<double> outputs{}; // activated outputs of the output layer
+    double meanSquareError{}; // 0.5 * sum of the squared errors / number of outputs
+    std::vector<double> gradients{}; // in the order of NeuralNetwork::GetGradients
+};
+
+/**
+ * \brief Golden reference for the forward pass and the gradients of a NeuralNetwork.
+ *
+ * Every value is computed with scalar loops over the weights of NeuronLayer, summing in index order and using
+ * the std::exp based functions of ActivationLib, without Eigen expressions, SIMD kernels, threads or batching.
+ * It follows the same rules as NeuralNetwork::CalcGradients: derivatives are taken at the net outputs, and the
+ * gradients of the output layer come from the raw errors. It is deliberately never optimized, so the faster
+ * engines can be checked against it.
+ */
+class ReferenceNetwork {
+public:
+    /**
+     * \brief feed one sample through a network
+     * \param network network whose parameters and activation functions are used
+     * \param inputs inputs of the sample
+     * \return activated outputs of the output layer
+     */
+    static std::vector<double> FeedForward(const NeuralNetwork& network, const std::vector<double>& inputs);
+
+    /**
+     * \brief feed one sample through a network and compute its error and gradients
+     * \param network network whose parameters and activation functions are used
+     * \param inputs inputs of the sample
+     * \param targets targets of the sample
+     * \return outputs, mean square error and gradients of the sample
+     */
+    static ReferencePass CalcGradients(const NeuralNetwork& network, const std::vector<double>& inputs,
+                                       const std::vector<double>& targets);
+};
+#endif // REFERENCENETWORK_H
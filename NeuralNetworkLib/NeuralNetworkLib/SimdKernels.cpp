@@ -0,0 +1,179 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: SimdKernels.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "SimdKernels.h"
+
+#include <atomic>
+
+#if defined(NNL_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "AllocationTracker.h"
+#include "../Eigen/Eigen"
+
+// defined in the instruction set specific files, which MSVC compiles without /arch flags since it accepts every
+// intrinsic anyway, while GCC and Clang compile them under target pragmas
+#ifdef NNL_SIMD_X86
+extern const SimdKernelTable sse2Kernels;
+extern const SimdKernelTable avx2Kernels;
+extern const SimdKernelTable avx512Kernels;
+#endif
+
+namespace {
+    // the generic kernels use Eigen, which vectorizes for whatever the build targets, e.g. NEON on ARM
+
+    void GenericActivate(double* values, const std::size_t count, const EActivationFunction activationFunction) {
+        Eigen::Map<Eigen::ArrayXd> array(values, static_cast<Eigen::Index>(count));
+        switch (activationFunction) {
+        case EActivationFunction::HEAVISIDE_STEP_FUNCTION:
+            array = (array > 0.0).cast<double>();
+            return;
+        case EActivationFunction::SIGMOID_FUNCTION:
+            array = 1.0 / (1.0 + (-array).exp());
+            return;
+        case EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION:
+            array = array.tanh();
+            return;
+        case EActivationFunction::RELU_FUNCTION:
+            array = array.max(0.0);
+            return;
+        case EActivationFunction::NONE:
+            return;
+        }
+    }
+
+    void GenericLayerForward(const double* weights, const std::ptrdiff_t weightStride, const double* biases,
+                             const double* inputs, const int numNeurons, const int numInputs, const int numSamples,
+                             const EActivationFunction activationFunction, double* outputs, double* netOutputs) {
+        const Eigen::Map<const Eigen::MatrixXd, 0, Eigen::OuterStride<>> weightMatrix(
+            weights, numNeurons, numInputs, Eigen::OuterStride<>(weightStride));
+        const Eigen::Map<const Eigen::VectorXd> biasVector(biases, numNeurons);
+        const Eigen::Map<const Eigen::MatrixXd> inputMatrix(inputs, numInputs, numSamples);
+        Eigen::Map<Eigen::MatrixXd> outputMatrix(outputs, numNeurons, numSamples);
+
+        outputMatrix.noalias() = weightMatrix * inputMatrix;
+        outputMatrix.colwise() += biasVector;
+        if (netOutputs != nullptr) { Eigen::Map<Eigen::MatrixXd>(netOutputs, numNeurons, numSamples) = outputMatrix; }
+        GenericActivate(outputs, static_cast<std::size_t>(numNeurons) * numSamples, activationFunction);
+    }
+
+    void GenericAddScaled(double* values, const double* increments, const double scale, const std::size_t count) {
+        Eigen::Map<Eigen::VectorXd>(values, static_cast<Eigen::Index>(count)) +=
+            scale * Eigen::Map<const Eigen::VectorXd>(increments, static_cast<Eigen::Index>(count));
+    }
+
+    constexpr SimdKernelTable genericKernels{&GenericLayerForward, &GenericActivate, &GenericAddScaled};
+
+    ESimdLevel DetectLevel() {
+#if defined(NNL_SIMD_X86) && defined(_MSC_VER)
+        int info[4]{};
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool sse2 = (info[3] & (1 << 26)) != 0;
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool osSavesRegisters = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        bool avx2{};
+        bool avx512{};
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+            avx512 = (info[1] & (1 << 16)) != 0;
+        }
+
+        // the operating system must save the upper halves of the vector registers and the mask registers
+        const unsigned long long enabledState = osSavesRegisters ? _xgetbv(0) : 0;
+        const bool osAvx = (enabledState & 0x06) == 0x06;
+        const bool osAvx512 = (enabledState & 0xE6) == 0xE6;
+
+        if (avx512 && osAvx512) { return ESimdLevel::AVX512; }
+        if (avx && avx2 && fma && osAvx) { return ESimdLevel::AVX2; }
+        if (sse2) { return ESimdLevel::SSE2; }
+        return ESimdLevel::GENERIC;
+#elif defined(NNL_SIMD_X86)
+        // these checks include the operating system support
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) { return ESimdLevel::AVX512; }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return ESimdLevel::AVX2; }
+        if (__builtin_cpu_supports("sse2")) { return ESimdLevel::SSE2; }
+        return ESimdLevel::GENERIC;
+#else
+        return ESimdLevel::GENERIC;
+#endif
+    }
+
+    const SimdKernelTable* GetKernelTable(const ESimdLevel level) {
+        switch (level) {
+#ifdef NNL_SIMD_X86
+        case ESimdLevel::SSE2:
+            return &sse2Kernels;
+        case ESimdLevel::AVX2:
+            return &avx2Kernels;
+        case ESimdLevel::AVX512:
+            return &avx512Kernels;
+#endif
+        default:
+            return &genericKernels;
+        }
+    }
+
+    struct DispatchState {
+        ESimdLevel supportedLevel{DetectLevel()};
+        std::atomic<ESimdLevel> level{supportedLevel};
+        std::atomic<const SimdKernelTable*> kernels{GetKernelTable(supportedLevel)};
+    };
+
+    DispatchState& GetState() {
+        static DispatchState state{};
+        return state;
+    }
+}
+
+const SimdKernelTable& SimdKernels::Get() {
+    return *GetState().kernels.load(std::memory_order_acquire);
+}
+
+ESimdLevel SimdKernels::GetSupportedLevel() {
+    return GetState().supportedLevel;
+}
+
+ESimdLevel SimdKernels::GetLevel() {
+    return GetState().level.load();
+}
+
+bool SimdKernels::SetLevel(const ESimdLevel level) {
+    DispatchState& state = GetState();
+    if (level > state.supportedLevel) { return false; }
+    state.level.store(level);
+    state.kernels.store(GetKernelTable(level), std::memory_order_release);
+    return true;
+}
+
+const char* SimdKernels::GetLevelName(const ESimdLevel level) {
+    switch (level) {
+    case ESimdLevel::GENERIC:
+        return "generic";
+    case ESimdLevel::SSE2:
+        return "sse2";
+    case ESimdLevel::AVX2:
+        return "avx2";
+    case ESimdLevel::AVX512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+std::string SimdKernels::GetReport() {
+    return std::string("simd: ") + GetLevelName(GetLevel()) + " (supported: " + GetLevelName(GetSupportedLevel()) +
+        ")";
+}
@@ -0,0 +1,110 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: SimdKernels.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : hot numeric kernels compiled for several instruction sets and picked at runtime
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ActivationLib.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NNL_SIMD_X86 // the SSE2, AVX2 and AVX-512 kernels are only built for x86
+#endif
+
+/**
+ * \brief Enum class to represent the instruction set levels the kernels are built for, in increasing order
+ */
+enum class ESimdLevel : uint8_t {
+    GENERIC, // Eigen with the instruction set of the build, any CPU
+    SSE2,
+    AVX2, // AVX2 with FMA
+    AVX512 // AVX-512 foundation
+};
+
+/**
+ * \brief Kernels of one instruction set level. Matrices are column-major doubles.
+ */
+struct SimdKernelTable {
+    /**
+     * \brief outputs = activation(weights * inputs + biases) for a batch of samples, one sample per column
+     * \param weights numNeurons x numInputs weights
+     * \param weightStride distance between the columns of the weights, at least numNeurons
+     * \param biases numNeurons biases
+     * \param inputs numInputs x numSamples inputs
+     * \param outputs numNeurons x numSamples activated outputs
+     * \param netOutputs numNeurons x numSamples net outputs before activation, or nullptr
+     */
+    void (*layerForward)(const double* weights, std::ptrdiff_t weightStride, const double* biases,
+                         const double* inputs, int numNeurons, int numInputs, int numSamples,
+                         EActivationFunction activationFunction, double* outputs, double* netOutputs);
+
+    /**
+     * \brief apply an activation function to every value in place
+     */
+    void (*activate)(double* values, std::size_t count, EActivationFunction activationFunction);
+
+    /**
+     * \brief values += scale * increments
+     */
+    void (*addScaled)(double* values, const double* increments, double scale, std::size_t count);
+};
+
+/**
+ * \brief Picks the kernels for the best instruction set level of the CPU the first time they are used.
+ *
+ * Each level lives in its own source file compiled for that instruction set, so one binary runs on every x86 CPU
+ * and still uses AVX2 or AVX-512 where they are available. The sigmoid and hyperbolic tangent kernels use a
+ * polynomial exponential rather than std::exp, accurate to a few units in the last place; the hyperbolic tangent is
+ * computed from e^(2x) - 1, so it keeps that accuracy near zero.
+ */
+class SimdKernels {
+public:
+    /**
+     * \brief get the kernels in use
+     * \return kernel table of the current level
+     */
+    static const SimdKernelTable& Get();
+
+    /**
+     * \brief get the best level this CPU and operating system support, detected once with cpuid
+     * \return supported level
+     */
+    static ESimdLevel GetSupportedLevel();
+
+    /**
+     * \brief get the level in use
+     * \return current level
+     */
+    static ESimdLevel GetLevel();
+
+    /**
+     * \brief use the kernels of another level, e.g. to compare levels or to rule out a kernel when debugging
+     * \param level level to use
+     * \return false, leaving the level unchanged, if the CPU doesn't support the level or it isn't built
+     */
+    static bool SetLevel(ESimdLevel level);
+
+    /**
+     * \brief get the name of a level
+     * \param level level to name
+     * \return lowercase name, e.g. "avx2"
+     */
+    static const char* GetLevelName(ESimdLevel level);
+
+    /**
+     * \brief describe the supported level and the level in use
+     * \return one line report, e.g. "simd: avx2 (supported: avx512)"
+     */
+    static std::string GetReport();
+};
+#endif // SIMDKERNELS_H
@@ -0,0 +1,63 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: SimdKernelsAvx2.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "SimdKernels.h"
+
+#include <cstring>
+
+#ifdef NNL_SIMD_X86
+#include <immintrin.h>
+
+// everything below is compiled for AVX2 and FMA, and only called when cpuid reports them;
+// the standard headers must stay above, so none of their inline functions are compiled for it
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+#include "SimdKernelsImpl.h"
+
+namespace {
+    struct Avx2Traits {
+        using Vector = __m256d;
+        static constexpr int width = 4;
+        static Vector Load(const double* p) { return _mm256_loadu_pd(p); }
+        static void Store(double* p, const Vector v) { _mm256_storeu_pd(p, v); }
+        static Vector Broadcast(const double v) { return _mm256_set1_pd(v); }
+        static Vector Add(const Vector a, const Vector b) { return _mm256_add_pd(a, b); }
+        static Vector Sub(const Vector a, const Vector b) { return _mm256_sub_pd(a, b); }
+        static Vector Mul(const Vector a, const Vector b) { return _mm256_mul_pd(a, b); }
+        static Vector Div(const Vector a, const Vector b) { return _mm256_div_pd(a, b); }
+        static Vector MulAdd(const Vector a, const Vector b, const Vector c) { return _mm256_fmadd_pd(a, b, c); }
+        static Vector Max(const Vector a, const Vector b) { return _mm256_max_pd(a, b); }
+        static Vector Min(const Vector a, const Vector b) { return _mm256_min_pd(a, b); }
+
+        static Vector Positive(const Vector v) {
+            return _mm256_and_pd(_mm256_cmp_pd(v, _mm256_setzero_pd(), _CMP_GT_OQ), _mm256_set1_pd(1.0));
+        }
+
+        static Vector Pow2(const Vector t) {
+            const __m256i bias = _mm256_set1_epi64x(static_cast<long long>(roundingMagicBits - exponentBias));
+            return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_sub_epi64(_mm256_castpd_si256(t), bias), 52));
+        }
+    };
+}
+
+extern const SimdKernelTable avx2Kernels = MakeKernelTable<Avx2Traits>();
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
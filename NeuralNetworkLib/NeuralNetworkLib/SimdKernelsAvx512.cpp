@@ -0,0 +1,68 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: SimdKernelsAvx512.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "SimdKernels.h"
+
+#include <cstring>
+
+#ifdef NNL_SIMD_X86
+#include <immintrin.h>
+
+// everything below is compiled for AVX-512F, and only called when cpuid reports it;
+// the standard headers must stay above, so none of their inline functions are compiled for it
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+// GCC 12 warns about the deliberately undefined pass-through operands inside its own AVX-512 intrinsics
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "SimdKernelsImpl.h"
+
+namespace {
+    struct Avx512Traits {
+        using Vector = __m512d;
+        static constexpr int width = 8;
+        static Vector Load(const double* p) { return _mm512_loadu_pd(p); }
+        static void Store(double* p, const Vector v) { _mm512_storeu_pd(p, v); }
+        static Vector Broadcast(const double v) { return _mm512_set1_pd(v); }
+        static Vector Add(const Vector a, const Vector b) { return _mm512_add_pd(a, b); }
+        static Vector Sub(const Vector a, const Vector b) { return _mm512_sub_pd(a, b); }
+        static Vector Mul(const Vector a, const Vector b) { return _mm512_mul_pd(a, b); }
+        static Vector Div(const Vector a, const Vector b) { return _mm512_div_pd(a, b); }
+        static Vector MulAdd(const Vector a, const Vector b, const Vector c) { return _mm512_fmadd_pd(a, b, c); }
+        static Vector Max(const Vector a, const Vector b) { return _mm512_max_pd(a, b); }
+        static Vector Min(const Vector a, const Vector b) { return _mm512_min_pd(a, b); }
+
+        static Vector Positive(const Vector v) {
+            return _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(v, _mm512_setzero_pd(), _CMP_GT_OQ), _mm512_set1_pd(1.0));
+        }
+
+        static Vector Pow2(const Vector t) {
+            const __m512i bias = _mm512_set1_epi64(static_cast<long long>(roundingMagicBits - exponentBias));
+            return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_sub_epi64(_mm512_castpd_si512(t), bias), 52));
+        }
+    };
+}
+
+extern const SimdKernelTable avx512Kernels = MakeKernelTable<Avx512Traits>();
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+#endif
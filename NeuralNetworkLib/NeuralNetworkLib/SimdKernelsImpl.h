@@ -0,0 +1,367 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: SimdKernelsImpl.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : kernel templates shared by the instruction set specific source files
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+// Only included by the SimdKernels*.cpp files, after every other header, each of which defines a traits struct
+// wrapping the intrinsics of its instruction set:
+//   Vector, width, Load, Store, Broadcast, Add, Sub, Mul, Div, MulAdd(a, b, c) = a * b + c, Max, Min,
+//   Positive(v) = v > 0 ? 1 : 0, Pow2(t) = 2^n for t = n + roundingMagic
+// Everything here has internal linkage, so code compiled for AVX2 or AVX-512 can't be merged by the linker with the
+// code other files call on CPUs without them.
+#ifndef SIMDKERNELSIMPL_H
+#define SIMDKERNELSIMPL_H
+
+namespace {
+    // adding 1.5 * 2^52 rounds a double to an integer that ends up in the low bits of the mantissa
+    constexpr double roundingMagic = 6755399441055744.0;
+    constexpr std::uint64_t roundingMagicBits = 0x4338000000000000ULL;
+    constexpr std::uint64_t exponentBias = 1023;
+
+    struct ScalarTraits {
+        using Vector = double;
+        static constexpr int width = 1;
+        static Vector Load(const double* p) { return *p; }
+        static void Store(double* p, const Vector v) { *p = v; }
+        static Vector Broadcast(const double v) { return v; }
+        static Vector Add(const Vector a, const Vector b) { return a + b; }
+        static Vector Sub(const Vector a, const Vector b) { return a - b; }
+        static Vector Mul(const Vector a, const Vector b) { return a * b; }
+        static Vector Div(const Vector a, const Vector b) { return a / b; }
+        static Vector MulAdd(const Vector a, const Vector b, const Vector c) { return a * b + c; }
+        // same operand order as maxpd and minpd, the second operand wins if either is NaN
+        static Vector Max(const Vector a, const Vector b) { return a > b ? a : b; }
+        static Vector Min(const Vector a, const Vector b) { return a < b ? a : b; }
+        static Vector Positive(const Vector v) { return v > 0.0 ? 1.0 : 0.0; }
+
+        static Vector Pow2(const Vector t) {
+            std::uint64_t bits{};
+            std::memcpy(&bits, &t, sizeof(bits));
+            bits = (bits - (roundingMagicBits - exponentBias)) << 52;
+            Vector result{};
+            std::memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+    };
+
+    /**
+     * \brief split x = n ln(2) + r and evaluate e^r - 1 with a degree 13 Taylor polynomial on
+     *  [-ln(2) / 2, ln(2) / 2], the argument clamped to where 2^n is a normal double
+     * \param x argument
+     * \param t receives n + roundingMagic, for Pow2
+     * \return e^r - 1
+     */
+    template <typename T>
+    typename T::Vector ReducedExpm1(typename T::Vector x, typename T::Vector& t) {
+        using V = typename T::Vector;
+        x = T::Min(T::Broadcast(709.0), T::Max(T::Broadcast(-708.0), x));
+
+        // x = n ln(2) + r, with ln(2) split so n * ln2High is exact
+        t = T::MulAdd(x, T::Broadcast(1.4426950408889634), T::Broadcast(roundingMagic));
+        const V n = T::Sub(t, T::Broadcast(roundingMagic));
+        V r = T::MulAdd(n, T::Broadcast(-6.93147180369123816490e-01), x);
+        r = T::MulAdd(n, T::Broadcast(-1.90821492927058770002e-10), r);
+
+        V p = T::Broadcast(1.0 / 6227020800.0);
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 479001600.0));
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 39916800.0));
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 3628800.0));
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 362880.0));
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 40320.0));
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 5040.0));
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 720.0));
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 120.0));
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 24.0));
+        p = T::MulAdd(p, r, T::Broadcast(1.0 / 6.0));
+        p = T::MulAdd(p, r, T::Broadcast(0.5));
+        p = T::MulAdd(p, r, T::Broadcast(1.0));
+        return T::Mul(p, r);
+    }
+
+    /**
+     * \brief e^x = 2^n (e^r - 1) + 2^n
+     */
+    template <typename T>
+    typename T::Vector Exp(const typename T::Vector x) {
+        typename T::Vector t{};
+        const auto q = ReducedExpm1<T>(x, t);
+        const auto scale = T::Pow2(t);
+        return T::MulAdd(q, scale, scale);
+    }
+
+    /**
+     * \brief e^x - 1 = 2^n (e^r - 1) + (2^n - 1), which keeps its relative accuracy for x near 0 where e^x - 1
+     *  would cancel
+     */
+    template <typename T>
+    typename T::Vector Expm1(const typename T::Vector x) {
+        typename T::Vector t{};
+        const auto q = ReducedExpm1<T>(x, t);
+        const auto scale = T::Pow2(t);
+        return T::MulAdd(q, scale, T::Sub(scale, T::Broadcast(1.0)));
+    }
+
+    template <typename T>
+    typename T::Vector Activate(const typename T::Vector v, const EActivationFunction activationFunction) {
+        const auto one = T::Broadcast(1.0);
+        switch (activationFunction) {
+        case EActivationFunction::HEAVISIDE_STEP_FUNCTION:
+            return T::Positive(v);
+        case EActivationFunction::SIGMOID_FUNCTION:
+            return T::Div(one, T::Add(one, Exp<T>(T::Sub(T::Broadcast(0.0), v))));
+        case EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION: {
+            // tanh(x) = (e^(2x) - 1) / (e^(2x) - 1 + 2), which doesn't cancel near 0 like 1 - 2 / (e^(2x) + 1);
+            // tanh rounds to +-1 beyond |x| = 20, and clamping there keeps e^(2x) - 1 finite
+            const auto limit = T::Broadcast(40.0);
+            const auto e = Expm1<T>(T::Min(limit, T::Max(T::Sub(T::Broadcast(0.0), limit), T::Add(v, v))));
+            return T::Div(e, T::Add(e, T::Broadcast(2.0)));
+        }
+        case EActivationFunction::RELU_FUNCTION:
+            return T::Max(T::Broadcast(0.0), v);
+        case EActivationFunction::NONE:
+            break;
+        }
+        return v;
+    }
+
+    template <typename T, EActivationFunction A>
+    void ActivateAll(double* values, const std::size_t count) {
+        std::size_t i = 0;
+        for (; i + T::width <= count; i += T::width) { T::Store(values + i, Activate<T>(T::Load(values + i), A)); }
+        for (; i < count; ++i) { values[i] = Activate<ScalarTraits>(values[i], A); }
+    }
+
+    template <typename T>
+    void ActivateRange(double* values, const std::size_t count, const EActivationFunction activationFunction) {
+        // one switch per call, so the activation is inlined into the loop
+        switch (activationFunction) {
+        case EActivationFunction::HEAVISIDE_STEP_FUNCTION:
+            ActivateAll<T, EActivationFunction::HEAVISIDE_STEP_FUNCTION>(values, count);
+            return;
+        case EActivationFunction::SIGMOID_FUNCTION:
+            ActivateAll<T, EActivationFunction::SIGMOID_FUNCTION>(values, count);
+            return;
+        case EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION:
+            ActivateAll<T, EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION>(values, count);
+            return;
+        case EActivationFunction::RELU_FUNCTION:
+            ActivateAll<T, EActivationFunction::RELU_FUNCTION>(values, count);
+            return;
+        case EActivationFunction::NONE:
+            return;
+        }
+    }
+
+    template <typename T>
+    void AddScaled(double* values, const double* increments, const double scale, const std::size_t count) {
+        const auto factor = T::Broadcast(scale);
+        std::size_t i = 0;
+        for (; i + 2 * T::width <= count; i += 2 * T::width) {
+            T::Store(values + i, T::MulAdd(T::Load(increments + i), factor, T::Load(values + i)));
+            T::Store(values + i + T::width,
+                     T::MulAdd(T::Load(increments + i + T::width), factor, T::Load(values + i + T::width)));
+        }
+        for (; i < count; ++i) { values[i] += scale * increments[i]; }
+    }
+
+    /**
+     * \brief y = weights * x + biases, four columns at a time so y is read and written once per four columns
+     *  while the weights stream through in memory order
+     */
+    template <typename T>
+    void Gemv(const double* weights, const std::ptrdiff_t weightStride, const double* biases, const double* x,
+              const int numRows, const int numColumns, double* y) {
+        for (int i = 0; i < numRows; ++i) { y[i] = biases[i]; }
+
+        int j = 0;
+        for (; j + 4 <= numColumns; j += 4) {
+            const double* w0 = weights + j * weightStride;
+            const double* w1 = w0 + weightStride;
+            const double* w2 = w1 + weightStride;
+            const double* w3 = w2 + weightStride;
+            const auto x0 = T::Broadcast(x[j]);
+            const auto x1 = T::Broadcast(x[j + 1]);
+            const auto x2 = T::Broadcast(x[j + 2]);
+            const auto x3 = T::Broadcast(x[j + 3]);
+            int i = 0;
+            for (; i + T::width <= numRows; i += T::width) {
+                auto sum = T::MulAdd(T::Load(w0 + i), x0, T::Load(y + i));
+                sum = T::MulAdd(T::Load(w1 + i), x1, sum);
+                sum = T::MulAdd(T::Load(w2 + i), x2, sum);
+                T::Store(y + i, T::MulAdd(T::Load(w3 + i), x3, sum));
+            }
+            for (; i < numRows; ++i) { y[i] += w0[i] * x[j] + w1[i] * x[j + 1] + w2[i] * x[j + 2] + w3[i] * x[j + 3]; }
+        }
+        for (; j < numColumns; ++j) {
+            const double* w0 = weights + j * weightStride;
+            const auto x0 = T::Broadcast(x[j]);
+            int i = 0;
+            for (; i + T::width <= numRows; i += T::width) {
+                T::Store(y + i, T::MulAdd(T::Load(w0 + i), x0, T::Load(y + i)));
+            }
+            for (; i < numRows; ++i) { y[i] += w0[i] * x[j]; }
+        }
+    }
+
+    struct GemmArguments {
+        const double* weights;
+        std::ptrdiff_t weightStride;
+        const double* biases;
+        const double* inputs;
+        int numNeurons;
+        int numInputs;
+        EActivationFunction activationFunction;
+        double* outputs;
+        double* netOutputs;
+    };
+
+    /**
+     * \brief edge tile of the batched product, rows [row, row + numRows) of samples [sample, sample + numSamples)
+     *  over inputs [k, k + numK)
+     */
+    inline void GemmEdgeTile(const GemmArguments& a, const int row, const int numRows, const int sample,
+                             const int numSamples, const int k, const int numK) {
+        const bool first = k == 0;
+        const bool last = k + numK == a.numInputs;
+        for (int s = sample; s < sample + numSamples; ++s) {
+            const double* x = a.inputs + static_cast<std::ptrdiff_t>(s) * a.numInputs;
+            double* y = a.outputs + static_cast<std::ptrdiff_t>(s) * a.numNeurons;
+            for (int i = row; i < row + numRows; ++i) {
+                double sum = first ? a.biases[i] : y[i];
+                for (int kk = k; kk < k + numK; ++kk) { sum += a.weights[i + kk * a.weightStride] * x[kk]; }
+                if (last) {
+                    if (a.netOutputs != nullptr) {
+                        a.netOutputs[i + static_cast<std::ptrdiff_t>(s) * a.numNeurons] = sum;
+                    }
+                    sum = Activate<ScalarTraits>(sum, a.activationFunction);
+                }
+                y[i] = sum;
+            }
+        }
+    }
+
+    /**
+     * \brief full tile of the batched product, 2 * width rows of 4 samples kept in registers over inputs
+     *  [k, k + numK), activated on the last pass over the inputs
+     */
+    template <typename T>
+    void GemmTile(const GemmArguments& a, const int row, const int sample, const int k, const int numK) {
+        using V = typename T::Vector;
+        constexpr int w = T::width;
+        const bool first = k == 0;
+        const bool last = k + numK == a.numInputs;
+
+        const double* x0 = a.inputs + static_cast<std::ptrdiff_t>(sample) * a.numInputs;
+        const double* x1 = x0 + a.numInputs;
+        const double* x2 = x1 + a.numInputs;
+        const double* x3 = x2 + a.numInputs;
+        double* y0 = a.outputs + static_cast<std::ptrdiff_t>(sample) * a.numNeurons + row;
+        double* y1 = y0 + a.numNeurons;
+        double* y2 = y1 + a.numNeurons;
+        double* y3 = y2 + a.numNeurons;
+
+        V a00, a01, a10, a11, a20, a21, a30, a31;
+        if (first) {
+            a00 = a10 = a20 = a30 = T::Load(a.biases + row);
+            a01 = a11 = a21 = a31 = T::Load(a.biases + row + w);
+        }
+        else {
+            a00 = T::Load(y0), a01 = T::Load(y0 + w);
+            a10 = T::Load(y1), a11 = T::Load(y1 + w);
+            a20 = T::Load(y2), a21 = T::Load(y2 + w);
+            a30 = T::Load(y3), a31 = T::Load(y3 + w);
+        }
+
+        const double* weights = a.weights + row + k * a.weightStride;
+        for (int kk = k; kk < k + numK; ++kk, weights += a.weightStride) {
+            const V w0 = T::Load(weights);
+            const V w1 = T::Load(weights + w);
+            V b = T::Broadcast(x0[kk]);
+            a00 = T::MulAdd(w0, b, a00), a01 = T::MulAdd(w1, b, a01);
+            b = T::Broadcast(x1[kk]);
+            a10 = T::MulAdd(w0, b, a10), a11 = T::MulAdd(w1, b, a11);
+            b = T::Broadcast(x2[kk]);
+            a20 = T::MulAdd(w0, b, a20), a21 = T::MulAdd(w1, b, a21);
+            b = T::Broadcast(x3[kk]);
+            a30 = T::MulAdd(w0, b, a30), a31 = T::MulAdd(w1, b, a31);
+        }
+
+        if (last) {
+            if (a.netOutputs != nullptr) {
+                double* n0 = a.netOutputs + static_cast<std::ptrdiff_t>(sample) * a.numNeurons + row;
+                T::Store(n0, a00), T::Store(n0 + w, a01);
+                n0 += a.numNeurons;
+                T::Store(n0, a10), T::Store(n0 + w, a11);
+                n0 += a.numNeurons;
+                T::Store(n0, a20), T::Store(n0 + w, a21);
+                n0 += a.numNeurons;
+                T::Store(n0, a30), T::Store(n0 + w, a31);
+            }
+            const EActivationFunction f = a.activationFunction;
+            a00 = Activate<T>(a00, f), a01 = Activate<T>(a01, f);
+            a10 = Activate<T>(a10, f), a11 = Activate<T>(a11, f);
+            a20 = Activate<T>(a20, f), a21 = Activate<T>(a21, f);
+            a30 = Activate<T>(a30, f), a31 = Activate<T>(a31, f);
+        }
+        T::Store(y0, a00), T::Store(y0 + w, a01);
+        T::Store(y1, a10), T::Store(y1 + w, a11);
+        T::Store(y2, a20), T::Store(y2 + w, a21);
+        T::Store(y3, a30), T::Store(y3 + w, a31);
+    }
+
+    template <typename T>
+    void LayerForward(const double* weights, const std::ptrdiff_t weightStride, const double* biases,
+                      const double* inputs, const int numNeurons, const int numInputs, const int numSamples,
+                      const EActivationFunction activationFunction, double* outputs, double* netOutputs) {
+        if (numSamples == 1 || numInputs == 0) {
+            // matrix-vector products are bound by memory bandwidth, so the activation is a separate pass over the
+            // outputs while they are still in the L1 cache
+            for (int s = 0; s < numSamples; ++s) {
+                double* y = outputs + static_cast<std::ptrdiff_t>(s) * numNeurons;
+                Gemv<T>(weights, weightStride, biases, inputs + static_cast<std::ptrdiff_t>(s) * numInputs,
+                        numNeurons, numInputs, y);
+                if (netOutputs != nullptr) {
+                    std::memcpy(netOutputs + static_cast<std::ptrdiff_t>(s) * numNeurons, y,
+                                sizeof(double) * numNeurons);
+                }
+                ActivateRange<T>(y, numNeurons, activationFunction);
+            }
+            return;
+        }
+
+        // blocked so a block of weights stays in the L2 cache while every sample passes over it
+        constexpr int tileRows = 2 * T::width;
+        constexpr int tileSamples = 4;
+        constexpr int blockInputs = 256;
+        constexpr int blockRows = 32 * tileRows;
+        const GemmArguments a{
+            weights, weightStride, biases, inputs, numNeurons, numInputs, activationFunction, outputs, netOutputs
+        };
+        for (int k = 0; k < numInputs; k += blockInputs) {
+            const int numK = numInputs - k < blockInputs ? numInputs - k : blockInputs;
+            for (int rowBlock = 0; rowBlock < numNeurons; rowBlock += blockRows) {
+                const int rowEnd = numNeurons - rowBlock < blockRows ? numNeurons : rowBlock + blockRows;
+                for (int s = 0; s < numSamples; s += tileSamples) {
+                    const int numTileSamples = numSamples - s < tileSamples ? numSamples - s : tileSamples;
+                    int row = rowBlock;
+                    if (numTileSamples == tileSamples) {
+                        for (; row + tileRows <= rowEnd; row += tileRows) { GemmTile<T>(a, row, s, k, numK); }
+                    }
+                    if (row < rowEnd) { GemmEdgeTile(a, row, rowEnd - row, s, numTileSamples, k, numK); }
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    constexpr SimdKernelTable MakeKernelTable() {
+        return {&LayerForward<T>, &ActivateRange<T>, &AddScaled<T>};
+    }
+}
+#endif // SIMDKERNELSIMPL_H
@@ -0,0 +1,63 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: SimdKernelsSse2.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "SimdKernels.h"
+
+#include <cstring>
+
+#ifdef NNL_SIMD_X86
+#include <immintrin.h>
+
+// everything below is compiled for SSE2, which 32-bit builds may not target by default;
+// the standard headers must stay above, so none of their inline functions are compiled for it
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#include "SimdKernelsImpl.h"
+
+namespace {
+    struct Sse2Traits {
+        using Vector = __m128d;
+        static constexpr int width = 2;
+        static Vector Load(const double* p) { return _mm_loadu_pd(p); }
+        static void Store(double* p, const Vector v) { _mm_storeu_pd(p, v); }
+        static Vector Broadcast(const double v) { return _mm_set1_pd(v); }
+        static Vector Add(const Vector a, const Vector b) { return _mm_add_pd(a, b); }
+        static Vector Sub(const Vector a, const Vector b) { return _mm_sub_pd(a, b); }
+        static Vector Mul(const Vector a, const Vector b) { return _mm_mul_pd(a, b); }
+        static Vector Div(const Vector a, const Vector b) { return _mm_div_pd(a, b); }
+        static Vector MulAdd(const Vector a, const Vector b, const Vector c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+        static Vector Max(const Vector a, const Vector b) { return _mm_max_pd(a, b); }
+        static Vector Min(const Vector a, const Vector b) { return _mm_min_pd(a, b); }
+
+        static Vector Positive(const Vector v) {
+            return _mm_and_pd(_mm_cmpgt_pd(v, _mm_setzero_pd()), _mm_set1_pd(1.0));
+        }
+
+        static Vector Pow2(const Vector t) {
+            const __m128i bias = _mm_set1_epi64x(static_cast<long long>(roundingMagicBits - exponentBias));
+            return _mm_castsi128_pd(_mm_slli_epi64(_mm_sub_epi64(_mm_castpd_si128(t), bias), 52));
+        }
+    };
+}
+
+extern const SimdKernelTable sse2Kernels = MakeKernelTable<Sse2Traits>();
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
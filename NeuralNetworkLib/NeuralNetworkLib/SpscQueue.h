@@ -0,0 +1,94 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: SpscQueue.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : bounded lock-free single-producer single-consumer queue
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Bounded ring buffer for handing values from exactly one producer thread to exactly one consumer thread.
+ *
+ * The producer only writes the tail and the consumer only writes the head, so neither side takes a lock. Each
+ * index sits on its own cache line, and each side keeps a cached copy of the other side's index so the shared
+ * line is only read when the queue looks full or empty.
+ */
+template <typename T>
+class SpscQueue {
+private:
+    std::vector<T> _slots{};
+    std::size_t _mask{};
+
+    alignas(64) std::atomic<std::size_t> _head{}; // next slot to pop, written by the consumer
+    std::size_t _cachedTail{};
+    alignas(64) std::atomic<std::size_t> _tail{}; // next slot to push, written by the producer
+    std::size_t _cachedHead{};
+
+public:
+    /**
+     * \brief create an empty queue
+     * \param capacity minimum number of values the queue can hold, rounded up to a power of two
+     */
+    explicit SpscQueue(const std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) { size *= 2; }
+        _slots.resize(size);
+        _mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * \brief append a value, producer only
+     * \param value value to move into the queue, left untouched if the queue is full
+     * \return false if the queue is full
+     */
+    bool TryPush(T& value) {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead == _slots.size()) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead == _slots.size()) { return false; }
+        }
+        _slots[tail & _mask] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief remove the oldest value, consumer only
+     * \param value receives the value
+     * \return false if the queue is empty
+     */
+    bool TryPop(T& value) {
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail) { return false; }
+        }
+        value = std::move(_slots[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief check for values from any thread, the answer may be stale by the time it is used
+     * \return true if the queue held no values
+     */
+    [[nodiscard]] bool Empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::size_t Capacity() const { return _slots.size(); }
+};
+#endif // SPSCQUEUE_H
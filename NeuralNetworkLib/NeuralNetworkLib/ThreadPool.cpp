@@ -0,0 +1,159 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ThreadPool.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <string>
+
+#include "Tracer.h"
+
+namespace {
+    // pool and index of the worker running on this thread, so tasks submitted from a worker stay local
+    thread_local const ThreadPool* currentPool{};
+    thread_local unsigned currentWorker{};
+}
+
+ThreadPool::ThreadPool(unsigned numThreads) {
+    if (numThreads == 0) { numThreads = std::max(1u, std::thread::hardware_concurrency()); }
+
+    _queues.reserve(numThreads);
+    for (unsigned i = 0; i < numThreads; ++i) { _queues.push_back(std::make_unique<WorkQueue>()); }
+
+    _workers.reserve(numThreads);
+    for (unsigned i = 0; i < numThreads; ++i) {
+        _workers.emplace_back(&ThreadPool::Work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(_mutex);
+        _stopRequested = true;
+    }
+    _condition.notify_all();
+    for (auto& worker : _workers) { worker.join(); }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    const unsigned queue = currentPool == this
+                               ? currentWorker
+                               : _nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+    {
+        std::lock_guard lock(_queues[queue]->mutex);
+        _queues[queue]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(_mutex);
+        ++_numQueuedTasks;
+    }
+    _condition.notify_one();
+}
+
+bool ThreadPool::TryPop(const unsigned worker, std::function<void()>& task) {
+    {
+        // newest task of the own deque first
+        WorkQueue& own = *_queues[worker];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // then the oldest task of the other deques
+    const auto numQueues = static_cast<unsigned>(_queues.size());
+    for (unsigned i = 1; i < numQueues; ++i) {
+        WorkQueue& victim = *_queues[(worker + i) % numQueues];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::Work(const unsigned worker) {
+    currentPool = this;
+    currentWorker = worker;
+    Tracer::SetThreadName("pool worker " + std::to_string(worker));
+
+    while (true) {
+        std::function<void()> task{};
+        if (TryPop(worker, task)) {
+            {
+                std::lock_guard lock(_mutex);
+                --_numQueuedTasks;
+            }
+            {
+                TraceSpan span("task");
+                task();
+            }
+            continue;
+        }
+
+        // a task counted here has been pushed already, so waking up on the count never misses one
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this] { return _stopRequested || _numQueuedTasks > 0; });
+        if (_stopRequested && _numQueuedTasks == 0) { return; }
+    }
+}
+
+void ThreadPool::ParallelFor(const int count, const std::function<void(int index, int worker)>& body) {
+    if (count <= 0) { return; }
+
+    // shared between the caller and the helper tasks, helpers that start late find no work left
+    struct LoopState {
+        std::function<void(int, int)> body;
+        int count{};
+        std::atomic<int> nextIndex{};
+        std::atomic<int> nextWorker{};
+        std::atomic<int> finishedIndices{};
+        std::mutex mutex{};
+        std::condition_variable finished{};
+        std::exception_ptr exception{};
+    };
+    const auto state = std::make_shared<LoopState>();
+    state->body = body;
+    state->count = count;
+
+    const auto runIndices = [](LoopState& loop) {
+        const int worker = loop.nextWorker.fetch_add(1);
+        int index{};
+        while ((index = loop.nextIndex.fetch_add(1)) < loop.count) {
+            try { loop.body(index, worker); }
+            catch (...) {
+                std::lock_guard lock(loop.mutex);
+                if (!loop.exception) { loop.exception = std::current_exception(); }
+            }
+            if (loop.finishedIndices.fetch_add(1) + 1 == loop.count) {
+                std::lock_guard lock(loop.mutex);
+                loop.finished.notify_all();
+            }
+        }
+    };
+
+    const int numHelpers = std::min(count - 1, GetNumThreads());
+    for (int i = 0; i < numHelpers; ++i) {
+        Submit([state, runIndices] { runIndices(*state); });
+    }
+    runIndices(*state);
+
+    std::unique_lock lock(state->mutex);
+    state->finished.wait(lock, [&state] { return state->finishedIndices.load() == state->count; });
+    if (state->exception) { std::rethrow_exception(state->exception); }
+}
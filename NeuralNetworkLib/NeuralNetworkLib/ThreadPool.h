@@ -0,0 +1,99 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ThreadPool.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : fixed-size work-stealing pool of worker threads
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Fixed-size work-stealing pool of worker threads.
+ *
+ * Every worker has its own task deque. Tasks submitted from a worker go to the back of its own deque and are run
+ * newest first, which keeps nested work cache-warm, while tasks submitted from other threads are spread over the
+ * deques round-robin. A worker whose deque runs dry steals the oldest task of another worker. ParallelFor hands out
+ * loop indices dynamically, so uneven work per index is balanced, and the calling thread takes part in the loop,
+ * which makes nested ParallelFor calls safe.
+ */
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::mutex mutex{};
+        std::deque<std::function<void()>> tasks{};
+    };
+
+    std::vector<std::thread> _workers{};
+    std::vector<std::unique_ptr<WorkQueue>> _queues{};
+    std::atomic<unsigned> _nextQueue{}; // round-robin target of tasks submitted from outside the pool
+
+    // sleeping workers wait for the count of queued tasks to become positive
+    std::mutex _mutex{};
+    std::condition_variable _condition{};
+    int _numQueuedTasks{};
+    bool _stopRequested{};
+
+    /**
+     * \brief take a task from the back of a worker's own deque, or steal one from the front of another deque
+     * \param worker index of the worker
+     * \param task receives the task
+     * \return true if a task was found
+     */
+    bool TryPop(unsigned worker, std::function<void()>& task);
+
+    /**
+     * \brief worker loop running queued tasks
+     * \param worker index of the worker
+     */
+    void Work(unsigned worker);
+
+public:
+    /**
+     * \brief start the worker threads
+     * \param numThreads number of workers, 0 uses one per hardware thread
+     */
+    explicit ThreadPool(unsigned numThreads = 0);
+
+    /**
+     * \brief finish the queued tasks and join the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * \brief queue a task to run on a worker
+     * \param task task to run
+     */
+    void Submit(std::function<void()> task);
+
+    /**
+     * \brief run body(index, worker) for every index in [0, count) and wait for all of them,
+     *  the first exception thrown by body is rethrown here
+     * \param count number of indices
+     * \param body loop body, worker is in [0, GetNumThreads()] and unique among concurrently running calls
+     *  of this loop, so it can index per-thread scratch data
+     */
+    void ParallelFor(int count, const std::function<void(int index, int worker)>& body);
+
+    /**
+     * \brief get the number of worker threads, the thread calling ParallelFor comes on top of these
+     * \return number of workers
+     */
+    [[nodiscard]] int GetNumThreads() const { return static_cast<int>(_workers.size()); }
+};
+#endif // THREADPOOL_H
@@ -0,0 +1,146 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ThreadTeam.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "ThreadTeam.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Tracer.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    /**
+     * \brief tell the core we are spinning, so it doesn't starve its hyper-threaded sibling
+     */
+    void CpuRelax(const unsigned spins) {
+        if (spins % 1024 == 1023) {
+            // an oversubscribed machine has to run the member we are waiting for
+            std::this_thread::yield();
+            return;
+        }
+#if defined(_M_X64) || defined(__x86_64__)
+        _mm_pause();
+#endif
+    }
+}
+
+ThreadTeam::ThreadTeam(unsigned numMembers, const std::chrono::microseconds spinTime) : _spinTime(spinTime) {
+    if (numMembers == 0) { numMembers = std::max(1u, std::thread::hardware_concurrency()); }
+    for (unsigned i = 1; i < numMembers; ++i) { _members.emplace_back(&ThreadTeam::Work, this, static_cast<int>(i)); }
+}
+
+ThreadTeam::~ThreadTeam() {
+    {
+        std::lock_guard lock(_sleepMutex);
+        _stopRequested.store(true);
+    }
+    _wakeUp.notify_all();
+    for (auto& member : _members) { member.join(); }
+}
+
+void ThreadTeam::RunTask(const int member) {
+    TraceSpan span("team region", "member", member);
+    try {
+        (*_task)(member);
+    }
+    catch (...) {
+        std::lock_guard lock(_errorMutex);
+        if (!_error) { _error = std::current_exception(); }
+    }
+}
+
+void ThreadTeam::Work(const int member) {
+    Tracer::SetThreadName("team member " + std::to_string(member));
+    unsigned seen{}; // not loaded, a region may have started before this thread did
+    while (true) {
+        // spin for new work, then sleep
+        const auto spinEnd = std::chrono::steady_clock::now() + _spinTime;
+        unsigned spins{};
+        while (_generation.load(std::memory_order_acquire) == seen && !_stopRequested.load(std::memory_order_relaxed)) {
+            CpuRelax(spins);
+            if (++spins % 256 == 0 && std::chrono::steady_clock::now() > spinEnd) {
+                std::unique_lock lock(_sleepMutex);
+                _numSleeping.fetch_add(1);
+                _wakeUp.wait(lock, [&] {
+                    return _generation.load() != seen || _stopRequested.load();
+                });
+                _numSleeping.fetch_sub(1);
+            }
+        }
+        if (_stopRequested.load()) { return; }
+        seen = _generation.load(std::memory_order_acquire);
+
+        RunTask(member);
+        _numFinished.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void ThreadTeam::Run(const std::function<void(int member)>& task) {
+    std::lock_guard runLock(_runMutex);
+    RunLocked(task);
+}
+
+void ThreadTeam::RunLocked(const std::function<void(int member)>& task) {
+    _task = &task;
+    _numFinished.store(0, std::memory_order_relaxed);
+
+    // the generation bump publishes the task, sleeping members are woken under the mutex so none miss it
+    _generation.fetch_add(1);
+    if (_numSleeping.load() > 0) {
+        { std::lock_guard lock(_sleepMutex); }
+        _wakeUp.notify_all();
+    }
+
+    RunTask(0);
+    const int numHelpers = static_cast<int>(_members.size());
+    for (unsigned spins{}; _numFinished.load(std::memory_order_acquire) != numHelpers; ++spins) { CpuRelax(spins); }
+
+    _task = nullptr;
+    std::lock_guard lock(_errorMutex);
+    if (_error) { std::rethrow_exception(std::exchange(_error, nullptr)); }
+}
+
+void ThreadTeam::RunOrInline(const std::function<void(int member, int numMembers)>& task) {
+    std::unique_lock runLock(_runMutex, std::try_to_lock);
+    if (!runLock.owns_lock() || _members.empty()) {
+        task(0, 1);
+        return;
+    }
+    const int numMembers = GetNumMembers();
+    RunLocked([&](const int member) { task(member, numMembers); });
+}
+
+void ThreadTeam::Barrier() {
+    const int numMembers = GetNumMembers();
+    if (numMembers == 1) { return; }
+
+    // sense-reversing barrier, the last member to arrive resets the count and opens the next phase
+    const unsigned phase = _barrierPhase.load(std::memory_order_acquire);
+    if (_barrierCount.fetch_add(1, std::memory_order_acq_rel) == numMembers - 1) {
+        _barrierCount.store(0, std::memory_order_relaxed);
+        _barrierPhase.store(phase + 1, std::memory_order_release);
+        return;
+    }
+    for (unsigned spins{}; _barrierPhase.load(std::memory_order_acquire) == phase; ++spins) { CpuRelax(spins); }
+}
+
+std::pair<int, int> ThreadTeam::Split(const int count, const int member, const int numMembers) {
+    // eight doubles fill a cache line, so members never write to the same line
+    constexpr int lineSize = 8;
+    const int numLines = (count + lineSize - 1) / lineSize;
+    const int first = static_cast<int>(static_cast<long long>(numLines) * member / numMembers) * lineSize;
+    const int end = static_cast<int>(static_cast<long long>(numLines) * (member + 1) / numMembers) * lineSize;
+    return {std::min(first, count), std::min(end, count)};
+}
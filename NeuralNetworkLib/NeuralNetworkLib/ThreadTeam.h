@@ -0,0 +1,117 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: ThreadTeam.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : persistent spin-waiting thread team for low-latency parallel regions
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef THREADTEAM_H
+#define THREADTEAM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Fixed team of threads that run every task together, for parallel regions of a few microseconds.
+ *
+ * Unlike ThreadPool, which queues independent tasks, a team runs one task on all of its members at once, the
+ * calling thread being member 0, and members can meet at a barrier inside the task. Idle members spin on an atomic
+ * instead of sleeping, so starting a region and passing a barrier cost well under a microsecond. Members that have
+ * been idle for longer than the spin time go to sleep, so an unused team doesn't keep its cores busy.
+ */
+class ThreadTeam {
+private:
+    std::vector<std::thread> _members{};
+    std::chrono::microseconds _spinTime{};
+
+    // a region starts when the generation is bumped, and ends when every helper has checked in
+    const std::function<void(int member)>* _task{};
+    std::atomic<unsigned> _generation{};
+    std::atomic<int> _numFinished{};
+    std::exception_ptr _error{};
+    std::mutex _errorMutex{};
+    std::mutex _runMutex{}; // one region at a time
+
+    alignas(64) std::atomic<int> _barrierCount{};
+    alignas(64) std::atomic<unsigned> _barrierPhase{};
+
+    // helpers sleep here after spinning for the spin time
+    std::mutex _sleepMutex{};
+    std::condition_variable _wakeUp{};
+    std::atomic<int> _numSleeping{};
+    std::atomic<bool> _stopRequested{};
+
+    /**
+     * \brief loop of a helper thread
+     * \param member index of the member
+     */
+    void Work(int member);
+
+    /**
+     * \brief run the current task on a member, keeping the first error
+     */
+    void RunTask(int member);
+
+    /**
+     * \brief run a task on every member, the run mutex must be held
+     */
+    void RunLocked(const std::function<void(int member)>& task);
+
+public:
+    /**
+     * \brief start the helper threads
+     * \param numMembers number of members including the calling thread, 0 uses one per hardware thread
+     * \param spinTime how long idle members spin before sleeping
+     */
+    explicit ThreadTeam(unsigned numMembers = 0, std::chrono::microseconds spinTime = std::chrono::microseconds(500));
+
+    /**
+     * \brief wake and join the helper threads
+     */
+    ~ThreadTeam();
+
+    ThreadTeam(const ThreadTeam&) = delete;
+    ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+    [[nodiscard]] int GetNumMembers() const { return static_cast<int>(_members.size()) + 1; }
+
+    /**
+     * \brief run a task on every member and wait for all of them, the calling thread is member 0,
+     *  an exception thrown by any member is rethrown here, but a task that uses Barrier must not throw
+     * \param task called once per member with its index
+     */
+    void Run(const std::function<void(int member)>& task);
+
+    /**
+     * \brief like Run, but if another thread is using the team the task only runs on the calling thread,
+     *  as member 0 of a team of one
+     * \param task called with the member index and the number of members taking part,
+     *  it may only use Barrier if more than one member takes part
+     */
+    void RunOrInline(const std::function<void(int member, int numMembers)>& task);
+
+    /**
+     * \brief wait inside a task until every member has arrived
+     */
+    void Barrier();
+
+    /**
+     * \brief split count items into contiguous ranges, one per member, aligned to whole cache lines of doubles
+     * \param count number of items
+     * \param member index of the member
+     * \param numMembers number of members sharing the items
+     * \return first item of the member and one past its last item
+     */
+    static std::pair<int, int> Split(int count, int member, int numMembers);
+};
+#endif // THREADTEAM_H
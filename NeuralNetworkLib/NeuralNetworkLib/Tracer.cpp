@@ -0,0 +1,225 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: Tracer.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "Tracer.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SpscQueue.h"
+
+namespace {
+    constexpr std::size_t bufferCapacity = 1 << 16; // spans per thread between two flushes
+
+    struct TraceEvent {
+        const char* name{};
+        const char* argumentName{};
+        std::int64_t argument{};
+        std::int64_t start{}; // nanoseconds since tracing started
+        std::int64_t duration{}; // nanoseconds
+    };
+
+    struct ThreadBuffer {
+        SpscQueue<TraceEvent> events{bufferCapacity}; // pushed by the owning thread, drained by the flusher
+        int threadId{};
+        std::string threadName{};
+        bool nameWritten{};
+        std::atomic<bool> retired{}; // the owning thread has exited
+    };
+
+    struct TracerState {
+        std::mutex mutex{}; // guards everything but the contents of the buffers
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers{};
+        int nextThreadId{1};
+
+        std::ofstream file{};
+        bool firstEvent{};
+        std::thread flusher{};
+        std::condition_variable wakeUp{};
+        bool stopRequested{};
+        std::chrono::milliseconds flushInterval{};
+
+        std::atomic<std::int64_t> origin{}; // steady clock nanoseconds when tracing started
+        std::atomic<std::uint64_t> numDropped{};
+    };
+
+    /**
+     * \brief get the tracer state, which is never destroyed, so threads outliving main can still finish their spans
+     */
+    TracerState& GetState() {
+        static auto* state = new TracerState();
+        return *state;
+    }
+
+    std::int64_t ToNanoseconds(const std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+
+    /**
+     * \brief buffer and name of a thread, the buffer is only created once the thread records a span and is retired
+     *  when the thread exits
+     */
+    struct BufferHandle {
+        ThreadBuffer* buffer{};
+        std::string threadName{};
+
+        ~BufferHandle() {
+            if (buffer != nullptr) { buffer->retired.store(true, std::memory_order_release); }
+        }
+    };
+
+    thread_local BufferHandle threadBuffer{};
+
+    /**
+     * \brief get the buffer of the calling thread, registering it on first use
+     */
+    ThreadBuffer& GetThreadBuffer() {
+        if (threadBuffer.buffer == nullptr) {
+            TracerState& state = GetState();
+            std::lock_guard lock(state.mutex);
+            state.buffers.push_back(std::make_unique<ThreadBuffer>());
+            state.buffers.back()->threadId = state.nextThreadId++;
+            state.buffers.back()->threadName = threadBuffer.threadName;
+            threadBuffer.buffer = state.buffers.back().get();
+        }
+        return *threadBuffer.buffer;
+    }
+
+    void AppendEscaped(std::string& text, const std::string& value) {
+        for (const char c : value) {
+            if (c == '"' || c == '\\') { text += '\\'; }
+            if (static_cast<unsigned char>(c) >= 0x20) { text += c; }
+        }
+    }
+
+    /**
+     * \brief drain every buffer into the trace file and forget the buffers of exited threads, the mutex must be held
+     * \param write false to discard the spans
+     */
+    void DrainBuffers(TracerState& state, const bool write) {
+        std::string text{};
+        char line[512]{};
+        for (auto it = state.buffers.begin(); it != state.buffers.end();) {
+            ThreadBuffer& buffer = **it;
+            const bool retired = buffer.retired.load(std::memory_order_acquire); // before draining its last spans
+
+            if (write && !buffer.nameWritten && !buffer.threadName.empty()) {
+                text += state.firstEvent ? "\n" : ",\n";
+                state.firstEvent = false;
+                text += R"({"name":"thread_name","ph":"M","pid":1,"tid":)" + std::to_string(buffer.threadId) +
+                    R"(,"args":{"name":")";
+                AppendEscaped(text, buffer.threadName);
+                text += "\"}}";
+                buffer.nameWritten = true;
+            }
+
+            for (TraceEvent event{}; buffer.events.TryPop(event);) {
+                if (!write) { continue; }
+                int length = std::snprintf(line, sizeof(line),
+                                           R"(%s{"name":"%s","ph":"X","pid":1,"tid":%d,"ts":%.3f,"dur":%.3f)",
+                                           state.firstEvent ? "\n" : ",\n", event.name, buffer.threadId,
+                                           1e-3 * static_cast<double>(event.start),
+                                           1e-3 * static_cast<double>(event.duration));
+                if (event.argumentName != nullptr && length > 0 && length < static_cast<int>(sizeof(line))) {
+                    length += std::snprintf(line + length, sizeof(line) - length, R"(,"args":{"%s":%lld})",
+                                            event.argumentName, static_cast<long long>(event.argument));
+                }
+                state.firstEvent = false;
+                text += line;
+                text += '}';
+            }
+
+            if (retired) { it = state.buffers.erase(it); }
+            else { ++it; }
+        }
+        if (write && !text.empty()) { state.file.write(text.data(), static_cast<std::streamsize>(text.size())); }
+    }
+}
+
+std::atomic<bool> Tracer::_enabled{};
+
+bool Tracer::Start(const std::string& filename, const std::chrono::milliseconds flushInterval) {
+    TracerState& state = GetState();
+    std::lock_guard lock(state.mutex);
+    if (state.flusher.joinable()) { return false; }
+
+    // spans that ended after the last run stopped don't belong to this one
+    DrainBuffers(state, false);
+    for (const auto& buffer : state.buffers) { buffer->nameWritten = false; }
+
+    state.file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!state.file.is_open()) { return false; }
+    state.file << R"({"traceEvents":[)";
+    state.firstEvent = true;
+    state.stopRequested = false;
+    state.flushInterval = flushInterval;
+    state.numDropped.store(0, std::memory_order_relaxed);
+    state.origin.store(ToNanoseconds(std::chrono::steady_clock::now().time_since_epoch()),
+                       std::memory_order_relaxed);
+
+    state.flusher = std::thread([&state] {
+        std::unique_lock flusherLock(state.mutex);
+        while (!state.stopRequested) {
+            state.wakeUp.wait_for(flusherLock, state.flushInterval, [&state] { return state.stopRequested; });
+            DrainBuffers(state, true);
+        }
+    });
+    _enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+void Tracer::Stop() {
+    _enabled.store(false, std::memory_order_release);
+
+    TracerState& state = GetState();
+    std::thread flusher{};
+    {
+        std::lock_guard lock(state.mutex);
+        if (!state.flusher.joinable()) { return; }
+        state.stopRequested = true;
+        flusher = std::move(state.flusher);
+    }
+    state.wakeUp.notify_all();
+    flusher.join();
+
+    std::lock_guard lock(state.mutex);
+    DrainBuffers(state, true);
+    state.file << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    state.file.close();
+}
+
+void Tracer::SetThreadName(const std::string& name) {
+    threadBuffer.threadName = name;
+    if (threadBuffer.buffer != nullptr) {
+        TracerState& state = GetState();
+        std::lock_guard lock(state.mutex);
+        threadBuffer.buffer->threadName = name;
+        threadBuffer.buffer->nameWritten = false;
+    }
+}
+
+std::uint64_t Tracer::GetNumDroppedSpans() { return GetState().numDropped.load(std::memory_order_relaxed); }
+
+void Tracer::Record(const char* name, const char* argumentName, const std::int64_t argument,
+                    const std::chrono::steady_clock::time_point start) {
+    const auto end = std::chrono::steady_clock::now();
+    TracerState& state = GetState();
+    TraceEvent event{name, argumentName, argument,
+                     ToNanoseconds(start.time_since_epoch()) - state.origin.load(std::memory_order_relaxed),
+                     ToNanoseconds(end - start)};
+    if (!GetThreadBuffer().events.TryPush(event)) { state.numDropped.fetch_add(1, std::memory_order_relaxed); }
+}
@@ -0,0 +1,109 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: Tracer.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : timeline tracing of training and inference to Chrome trace-event JSON
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * \brief Records spans of every thread into a Chrome trace-event file, which chrome://tracing and Perfetto open.
+ *
+ * Each thread appends its finished spans to its own lock-free ring buffer, and a background thread drains the
+ * buffers into the file every flush interval, so recording a span never takes a lock or touches the file. A span
+ * that finds its thread's buffer full is dropped and counted. While tracing is stopped a span costs one relaxed
+ * atomic load.
+ *
+ * The library traces training epochs, mini-batches, FeedForward, BackPropagate and their layers, weight updates,
+ * model files, checkpoint writes and the work of its worker threads.
+ */
+class Tracer {
+private:
+    static std::atomic<bool> _enabled;
+
+public:
+    /**
+     * \brief start writing spans to a file, replacing it
+     * \param filename trace file
+     * \param flushInterval how often the buffers are drained into the file
+     * \return false if tracing is already running or the file can't be opened
+     */
+    static bool Start(const std::string& filename,
+                      std::chrono::milliseconds flushInterval = std::chrono::milliseconds(50));
+
+    /**
+     * \brief stop tracing, write the remaining spans and close the file
+     */
+    static void Stop();
+
+    [[nodiscard]] static bool IsEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * \brief name the calling thread in the timeline
+     * \param name name to show
+     */
+    static void SetThreadName(const std::string& name);
+
+    /**
+     * \brief get the number of spans dropped because a thread's buffer was full
+     * \return dropped spans since tracing started
+     */
+    [[nodiscard]] static std::uint64_t GetNumDroppedSpans();
+
+    /**
+     * \brief append a finished span to the calling thread's buffer
+     * \param name name of the span, must be a string literal or otherwise outlive tracing
+     * \param argumentName name of an integer shown with the span, or nullptr
+     * \param argument value of the integer
+     * \param start time the span started
+     */
+    static void Record(const char* name, const char* argumentName, std::int64_t argument,
+                       std::chrono::steady_clock::time_point start);
+};
+
+/**
+ * \brief Span from its construction to the end of the enclosing scope, recorded if tracing is running when it starts
+ */
+class TraceSpan {
+private:
+    const char* _name{};
+    const char* _argumentName{};
+    std::int64_t _argument{};
+    bool _enabled{};
+    std::chrono::steady_clock::time_point _start{};
+
+public:
+    /**
+     * \brief start a span
+     * \param name name of the span, must be a string literal or otherwise outlive tracing
+     * \param argumentName name of an integer shown with the span, e.g. "layer", or nullptr
+     * \param argument value of the integer
+     */
+    explicit TraceSpan(const char* name, const char* argumentName = nullptr, const std::int64_t argument = 0) :
+        _enabled(Tracer::IsEnabled()) {
+        if (_enabled) {
+            _name = name;
+            _argumentName = argumentName;
+            _argument = argument;
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (_enabled) { Tracer::Record(_name, _argumentName, _argument, _start); }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+#endif // TRACER_H
@@ -0,0 +1,73 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: TrainingCheckpointer.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "TrainingCheckpointer.h"
+
+#include "Tracer.h"
+
+TrainingCheckpointer::TrainingCheckpointer(std::string filename, const int epochInterval) :
+    _filename(std::move(filename)), _epochInterval(epochInterval > 0 ? epochInterval : 1) {
+    _writer = std::thread(&TrainingCheckpointer::WriteSnapshots, this);
+}
+
+TrainingCheckpointer::~TrainingCheckpointer() {
+    {
+        std::lock_guard lock(_mutex);
+        _stopRequested = true;
+    }
+    _condition.notify_all();
+    _writer.join();
+}
+
+void TrainingCheckpointer::OnEpochEnd(const NeuralNetwork& network) {
+    if (network.GetTrainedEpochs() % _epochInterval == 0) { Snapshot(network); }
+}
+
+void TrainingCheckpointer::Snapshot(const NeuralNetwork& network) {
+    {
+        std::lock_guard lock(_mutex);
+
+        // fill the buffer the writer is not using, replacing an older pending snapshot if there is one
+        const int snapshot = _writingSnapshot == 0 ? 1 : 0;
+        _snapshots[snapshot].CopyStateFrom(network);
+        _pendingSnapshot = snapshot;
+    }
+    _condition.notify_all();
+}
+
+bool TrainingCheckpointer::Flush() {
+    std::unique_lock lock(_mutex);
+    _condition.wait(lock, [this] { return _pendingSnapshot < 0 && _writingSnapshot < 0; });
+    return _lastWriteSucceeded;
+}
+
+void TrainingCheckpointer::WriteSnapshots() {
+    Tracer::SetThreadName("checkpoint writer");
+
+    std::unique_lock lock(_mutex);
+    while (true) {
+        _condition.wait(lock, [this] { return _stopRequested || _pendingSnapshot >= 0; });
+        if (_pendingSnapshot < 0) { return; } // stop requested and nothing left to write
+
+        _writingSnapshot = _pendingSnapshot;
+        _pendingSnapshot = -1;
+        lock.unlock();
+
+        // SaveToBinaryFile writes next to the checkpoint, flushes and atomically replaces the previous one
+        TraceSpan span("checkpoint write", "epoch", _snapshots[_writingSnapshot].GetTrainedEpochs());
+        const bool written = _snapshots[_writingSnapshot].SaveToBinaryFile(_filename);
+
+        lock.lock();
+        _lastWriteSucceeded = written;
+        _writingSnapshot = -1;
+        _condition.notify_all();
+    }
+}
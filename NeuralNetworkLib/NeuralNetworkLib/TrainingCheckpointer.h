@@ -0,0 +1,89 @@
+﻿// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: TrainingCheckpointer.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : periodic checkpoints written from a background thread
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef TRAININGCHECKPOINTER_H
+#define TRAININGCHECKPOINTER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "NeuralNetwork.h"
+
+/**
+ * \brief Writes checkpoints of a network while it trains.
+ *
+ * At the end of every epochInterval-th epoch the parameters, learning rate and epoch count are copied into one
+ * of two snapshot buffers, and a background thread writes the snapshot in the binary model format. The training
+ * thread only pays for the copy. Each checkpoint is written to a temporary file, flushed to the disk and renamed
+ * over the previous one, and the directory is flushed after the rename, so the checkpoint file is always complete,
+ * even after a power loss. If training outpaces the disk, a pending snapshot that has not been picked up yet is
+ * replaced by the newer one.
+ *
+ * Resume with NeuralNetwork::LoadFromBinaryFile on the checkpoint file, which restores the epoch count and
+ * learning rate along with the parameters. The epoch limits of NeuralNetwork::Train count the epochs of one call,
+ * so pass the epochs that are left, e.g. maxEpochs - GetTrainedEpochs(), to finish the original budget.
+ */
+class TrainingCheckpointer {
+private:
+    std::string _filename{};
+    int _epochInterval{};
+
+    NeuralNetwork _snapshots[2]{};
+    int _pendingSnapshot{-1}; // index of the snapshot waiting to be written, -1 if none
+    int _writingSnapshot{-1}; // index of the snapshot being written, -1 if none
+    bool _stopRequested{};
+    bool _lastWriteSucceeded{true};
+
+    std::mutex _mutex{};
+    std::condition_variable _condition{};
+    std::thread _writer{};
+
+    /**
+     * \brief background loop writing pending snapshots
+     */
+    void WriteSnapshots();
+
+public:
+    /**
+     * \brief start the background writer
+     * \param filename checkpoint file, a temporary file with the suffix ".tmp" is used while writing
+     * \param epochInterval number of epochs between checkpoints
+     */
+    TrainingCheckpointer(std::string filename, int epochInterval);
+
+    /**
+     * \brief write any pending snapshot and stop the background writer
+     */
+    ~TrainingCheckpointer();
+
+    TrainingCheckpointer(const TrainingCheckpointer&) = delete;
+    TrainingCheckpointer& operator=(const TrainingCheckpointer&) = delete;
+
+    /**
+     * \brief called by NeuralNetwork at the end of every training epoch, snapshots every epochInterval-th epoch
+     * \param network network being trained
+     */
+    void OnEpochEnd(const NeuralNetwork& network);
+
+    /**
+     * \brief snapshot the network and queue it for writing
+     * \param network network to snapshot
+     */
+    void Snapshot(const NeuralNetwork& network);
+
+    /**
+     * \brief wait until every queued snapshot has been written
+     * \return true if the last write succeeded
+     */
+    bool Flush();
+};
+#endif // TRAININGCHECKPOINTER_H
@@ -0,0 +1,127 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: InferenceClient.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "InferenceClient.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+InferenceClient::InferenceClient(const std::string& socketPath, const std::uint32_t numSlots) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) { throw std::runtime_error("Socket path too long"); }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    _socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (_socket < 0 || connect(_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        if (_socket >= 0) { close(_socket); }
+        throw std::runtime_error("Could not connect to " + socketPath);
+    }
+
+    const InferenceProtocol::HelloMessage hello{InferenceProtocol::magic, InferenceProtocol::version, numSlots};
+    InferenceProtocol::WelcomeMessage welcome{};
+    int segmentFile{-1};
+
+    // the welcome message carries the segment's file descriptor as ancillary data
+    iovec part{&welcome, sizeof(welcome)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+    msghdr message{};
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    if (send(_socket, &hello, sizeof(hello), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(hello)) ||
+        recvmsg(_socket, &message, MSG_CMSG_CLOEXEC) != static_cast<ssize_t>(sizeof(welcome))) {
+        close(_socket);
+        throw std::runtime_error("Handshake with the inference server failed");
+    }
+    for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+            std::memcpy(&segmentFile, CMSG_DATA(header), sizeof(int));
+        }
+    }
+    if (segmentFile < 0 || welcome.magic != InferenceProtocol::magic ||
+        welcome.version != InferenceProtocol::version) {
+        if (segmentFile >= 0) { close(segmentFile); }
+        close(_socket);
+        throw std::runtime_error("Inference server sent an invalid welcome");
+    }
+
+    _numInputs = welcome.numInputs;
+    _numOutputs = welcome.numOutputs;
+    _layout = InferenceProtocol::SegmentLayout(_numInputs, _numOutputs, welcome.numSlots);
+    _segmentSize = welcome.segmentSize;
+
+    void* segment = mmap(nullptr, _segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, segmentFile, 0);
+    close(segmentFile);
+    if (segment == MAP_FAILED || _segmentSize < _layout.size) {
+        if (segment != MAP_FAILED) { munmap(segment, _segmentSize); }
+        close(_socket);
+        throw std::runtime_error("Could not map the shared segment");
+    }
+    _segment = static_cast<std::byte*>(segment);
+    _submitRing = InferenceProtocol::SharedRing(_segment + _layout.submitRingOffset, _layout.numSlots);
+    _completeRing = InferenceProtocol::SharedRing(_segment + _layout.completeRingOffset, _layout.numSlots);
+
+    // popped from the back, so slot 0 goes first
+    for (std::uint32_t slot = _layout.numSlots; slot-- > 0;) { _freeSlots.push_back(slot); }
+}
+
+InferenceClient::~InferenceClient() {
+    munmap(_segment, _segmentSize);
+    close(_socket);
+}
+
+bool InferenceClient::AcquireSlot(std::uint32_t& slot) {
+    if (_freeSlots.empty()) { return false; }
+    slot = _freeSlots.back();
+    _freeSlots.pop_back();
+    return true;
+}
+
+void InferenceClient::Submit(const std::uint32_t slot) {
+    // a ring holds every slot, so it can't be full
+    _submitRing.TryPush(slot);
+}
+
+bool InferenceClient::PollCompleted(std::uint32_t& slot) {
+    return _completeRing.TryPop(slot);
+}
+
+bool InferenceClient::IsConnected() const {
+    // the server never writes to the socket after the welcome, so any event means it hung up
+    pollfd socketEvents{_socket, POLLIN, 0};
+    return poll(&socketEvents, 1, 0) == 0;
+}
+
+void InferenceClient::FeedForward(const double* inputs, double* outputs) {
+    std::uint32_t slot{};
+    if (!AcquireSlot(slot)) { throw std::runtime_error("No free slot"); }
+    std::copy_n(inputs, _numInputs, GetInputs(slot));
+    Submit(slot);
+
+    std::uint32_t completed{};
+    for (unsigned spins = 1; !PollCompleted(completed); ++spins) {
+        if (spins % 4096 == 0 && !IsConnected()) { throw std::runtime_error("Inference server hung up"); }
+        std::this_thread::yield();
+    }
+    std::copy_n(GetOutputs(completed), _numOutputs, outputs);
+    ReleaseSlot(completed);
+}
@@ -0,0 +1,116 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: InferenceClient.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : client side of the inference server's shared-memory rings
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef INFERENCECLIENT_H
+#define INFERENCECLIENT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "InferenceProtocol.h"
+
+/**
+ * \brief Connection to a running NeuralNetworkServer.
+ *
+ * Inputs are written straight into a slot of the shared segment and outputs are read from it, so the zero-copy
+ * calls are AcquireSlot, GetInputs, Submit, PollCompleted, GetOutputs and ReleaseSlot. FeedForward wraps them for
+ * one request at a time. The rings have a single producer on each side, so one client must only be used from one
+ * thread at a time; open one client per thread instead.
+ */
+class InferenceClient {
+private:
+    int _socket{-1};
+    std::byte* _segment{};
+    std::size_t _segmentSize{};
+    int _numInputs{};
+    int _numOutputs{};
+    InferenceProtocol::SegmentLayout _layout{0, 0, 1};
+    InferenceProtocol::SharedRing _submitRing{};
+    InferenceProtocol::SharedRing _completeRing{};
+    std::vector<std::uint32_t> _freeSlots{};
+
+public:
+    /**
+     * \brief connect to a server, throws std::runtime_error if that fails
+     * \param socketPath path of the server's control socket
+     * \param numSlots number of requests that can be in flight at once
+     */
+    explicit InferenceClient(const std::string& socketPath = InferenceProtocol::defaultSocketPath,
+                             std::uint32_t numSlots = 64);
+
+    /**
+     * \brief unmap the segment and hang up, the server then drops it
+     */
+    ~InferenceClient();
+
+    InferenceClient(const InferenceClient&) = delete;
+    InferenceClient& operator=(const InferenceClient&) = delete;
+
+    [[nodiscard]] int GetNumInputs() const { return _numInputs; }
+    [[nodiscard]] int GetNumOutputs() const { return _numOutputs; }
+    [[nodiscard]] std::uint32_t GetNumSlots() const { return _layout.numSlots; }
+
+    /**
+     * \brief take a free slot
+     * \param slot receives the slot index
+     * \return false if every slot is in flight or waiting to be released
+     */
+    bool AcquireSlot(std::uint32_t& slot);
+
+    /**
+     * \brief get the input vector of a slot, in shared memory
+     * \param slot slot index
+     * \return numInputs doubles to fill before Submit
+     */
+    double* GetInputs(const std::uint32_t slot) const {
+        return reinterpret_cast<double*>(_segment + _layout.slotsOffset) + slot * _layout.slotStride;
+    }
+
+    /**
+     * \brief get the output vector of a slot, in shared memory
+     * \param slot slot index
+     * \return numOutputs doubles, valid once the slot was returned by PollCompleted
+     */
+    const double* GetOutputs(const std::uint32_t slot) const { return GetInputs(slot) + _numInputs; }
+
+    /**
+     * \brief hand a slot with its inputs written to the server
+     * \param slot slot index
+     */
+    void Submit(std::uint32_t slot);
+
+    /**
+     * \brief take the next slot the server has finished, without waiting
+     * \param slot receives the slot index
+     * \return false if no slot has finished
+     */
+    bool PollCompleted(std::uint32_t& slot);
+
+    /**
+     * \brief give a slot back once its outputs have been read
+     * \param slot slot index
+     */
+    void ReleaseSlot(std::uint32_t slot) { _freeSlots.push_back(slot); }
+
+    /**
+     * \brief check if the server is still there, without waiting
+     * \return false once the server has hung up
+     */
+    [[nodiscard]] bool IsConnected() const;
+
+    /**
+     * \brief run one request and wait for it, throws std::runtime_error if the server goes away meanwhile, with no other request of this client in flight
+     * \param inputs numInputs doubles
+     * \param outputs receives numOutputs doubles
+     */
+    void FeedForward(const double* inputs, double* outputs);
+};
+#endif // INFERENCECLIENT_H
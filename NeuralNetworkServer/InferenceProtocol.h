@@ -0,0 +1,131 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: InferenceProtocol.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : control messages and shared-memory layout of the inference server
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef INFERENCEPROTOCOL_H
+#define INFERENCEPROTOCOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/**
+ * A client connects to the server's Unix domain socket and sends a HelloMessage. The server answers with a
+ * WelcomeMessage and passes the file descriptor of a shared-memory segment created for that client along with it.
+ * All requests then go through the segment, the socket is only watched for the client hanging up.
+ *
+ * The segment holds numSlots slots, each with room for one input and one output vector, and two single-producer
+ * single-consumer rings of slot indices. The client writes the inputs of a free slot in place and pushes its index
+ * onto the submit ring, the server batches submitted slots, writes the outputs in place and pushes the indices onto
+ * the complete ring. No vector is ever copied through the socket.
+ */
+namespace InferenceProtocol {
+    constexpr char defaultSocketPath[] = "/tmp/NeuralNetworkServer.sock";
+    constexpr std::uint32_t magic = 0x534C4E4E; // "NNLS"
+    constexpr std::uint32_t version = 1;
+
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free,
+                  "the rings need address-free atomics to be shared between processes");
+
+    struct HelloMessage {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t numSlots; // requests the client wants in flight, rounded up to a power of two
+    };
+
+    struct WelcomeMessage {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::int32_t numInputs;
+        std::int32_t numOutputs;
+        std::uint32_t numSlots;
+        std::uint32_t reserved;
+        std::uint64_t segmentSize;
+    };
+
+    struct alignas(64) RingIndex {
+        std::atomic<std::uint32_t> value;
+    };
+
+    /**
+     * \brief View of a single-producer single-consumer ring of slot indices inside a shared segment,
+     *  indices grow without bound and are masked on access
+     */
+    class SharedRing {
+    private:
+        RingIndex* _head{}; // next entry to pop, written by the consumer
+        RingIndex* _tail{}; // next entry to push, written by the producer
+        std::uint32_t* _entries{};
+        std::uint32_t _mask{};
+
+    public:
+        SharedRing() = default;
+
+        SharedRing(std::byte* memory, const std::uint32_t capacity) :
+            _head(reinterpret_cast<RingIndex*>(memory)), _tail(reinterpret_cast<RingIndex*>(memory) + 1),
+            _entries(reinterpret_cast<std::uint32_t*>(memory + 2 * sizeof(RingIndex))), _mask(capacity - 1) {}
+
+        /**
+         * \brief size in bytes of a ring
+         * \param capacity number of entries, a power of two
+         * \return bytes needed, a multiple of the cache line
+         */
+        static std::size_t Size(const std::uint32_t capacity) {
+            return (2 * sizeof(RingIndex) + capacity * sizeof(std::uint32_t) + 63) / 64 * 64;
+        }
+
+        /**
+         * \brief construct the indices in freshly mapped memory, done once by the server
+         */
+        void Initialize() {
+            new(_head) RingIndex{{0}};
+            new(_tail) RingIndex{{0}};
+        }
+
+        bool TryPush(const std::uint32_t entry) {
+            const std::uint32_t tail = _tail->value.load(std::memory_order_relaxed);
+            if (tail - _head->value.load(std::memory_order_acquire) > _mask) { return false; }
+            _entries[tail & _mask] = entry;
+            _tail->value.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool TryPop(std::uint32_t& entry) {
+            const std::uint32_t head = _head->value.load(std::memory_order_relaxed);
+            if (head == _tail->value.load(std::memory_order_acquire)) { return false; }
+            entry = _entries[head & _mask];
+            _head->value.store(head + 1, std::memory_order_release);
+            return true;
+        }
+    };
+
+    /**
+     * \brief Offsets of the parts of a client segment, computed the same way by server and client
+     */
+    struct SegmentLayout {
+        std::uint32_t numSlots{};
+        std::size_t slotStride{}; // doubles from one slot to the next, a whole number of cache lines
+        std::size_t submitRingOffset{};
+        std::size_t completeRingOffset{};
+        std::size_t slotsOffset{};
+        std::size_t size{};
+
+        SegmentLayout(const int numInputs, const int numOutputs, const std::uint32_t requestedSlots) {
+            numSlots = 1;
+            while (numSlots < requestedSlots && numSlots < (1u << 16)) { numSlots <<= 1; }
+            slotStride = (static_cast<std::size_t>(numInputs + numOutputs) + 7) / 8 * 8;
+            submitRingOffset = 0;
+            completeRingOffset = submitRingOffset + SharedRing::Size(numSlots);
+            slotsOffset = completeRingOffset + SharedRing::Size(numSlots);
+            size = slotsOffset + numSlots * slotStride * sizeof(double);
+        }
+    };
+}
+#endif // INFERENCEPROTOCOL_H
@@ -0,0 +1,221 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: InferenceServer.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description :
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+#include "InferenceServer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    // polls of empty rings before the dispatcher starts sleeping, and how long it then sleeps
+    constexpr unsigned idleSpins = 2000;
+    constexpr std::chrono::microseconds idleSleep{50};
+}
+
+InferenceServer::InferenceServer(NeuralNetwork network, std::string socketPath, const int maxBatchSize,
+                                 const std::chrono::microseconds maxWait) :
+    _network(std::move(network)), _socketPath(std::move(socketPath)), _maxBatchSize(std::max(1, maxBatchSize)),
+    _maxWait(maxWait) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (_socketPath.size() >= sizeof(address.sun_path)) { throw std::runtime_error("Socket path too long"); }
+    std::memcpy(address.sun_path, _socketPath.c_str(), _socketPath.size() + 1);
+
+    unlink(_socketPath.c_str());
+    _listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (_listenSocket < 0 || bind(_listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(_listenSocket, 64) != 0) {
+        if (_listenSocket >= 0) { close(_listenSocket); }
+        throw std::runtime_error("Could not listen on " + _socketPath);
+    }
+
+    _dispatcher = std::thread(&InferenceServer::Dispatch, this);
+}
+
+InferenceServer::~InferenceServer() {
+    RequestStop();
+    _dispatcher.join();
+    while (!_clients.empty()) { DropClient(_clients.size() - 1); }
+    close(_listenSocket);
+    unlink(_socketPath.c_str());
+}
+
+void InferenceServer::Run() {
+    std::vector<pollfd> sockets{};
+
+    while (!_stopRequested.load(std::memory_order_relaxed)) {
+        // only this thread adds or drops clients, so the list can be read without the lock
+        sockets.assign(1, {_listenSocket, POLLIN, 0});
+        for (const auto& client : _clients) { sockets.push_back({client->socket, POLLIN, 0}); }
+
+        // the timeout bounds how long a stop request goes unnoticed
+        if (poll(sockets.data(), sockets.size(), 100) <= 0) { continue; }
+
+        // clients never write after the hello, so any event on their socket means they hung up
+        for (std::size_t i = sockets.size(); i-- > 1;) {
+            if (sockets[i].revents != 0) { DropClient(i - 1); }
+        }
+        if ((sockets[0].revents & POLLIN) != 0) { Accept(); }
+    }
+}
+
+void InferenceServer::Accept() {
+    const int clientSocket = accept4(_listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+    if (clientSocket < 0) { return; }
+
+    // a client that does not say hello in time is dropped instead of stalling the server
+    const timeval timeout{1, 0};
+    setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    InferenceProtocol::HelloMessage hello{};
+    if (recv(clientSocket, &hello, sizeof(hello), MSG_WAITALL) != static_cast<ssize_t>(sizeof(hello)) ||
+        hello.magic != InferenceProtocol::magic || hello.version != InferenceProtocol::version) {
+        close(clientSocket);
+        return;
+    }
+
+    auto client = std::make_unique<Client>();
+    client->socket = clientSocket;
+    client->layout = InferenceProtocol::SegmentLayout(_network.GetNumInputs(), _network.GetNumOutputs(),
+                                                      hello.numSlots);
+
+    // an anonymous file, the client gets access to it through the descriptor only
+    const int segmentFile = memfd_create("NeuralNetworkServer", MFD_CLOEXEC);
+    void* segment = MAP_FAILED;
+    if (segmentFile >= 0 && ftruncate(segmentFile, static_cast<off_t>(client->layout.size)) == 0) {
+        segment = mmap(nullptr, client->layout.size, PROT_READ | PROT_WRITE, MAP_SHARED, segmentFile, 0);
+    }
+    if (segment == MAP_FAILED) {
+        if (segmentFile >= 0) { close(segmentFile); }
+        close(clientSocket);
+        return;
+    }
+    client->segment = static_cast<std::byte*>(segment);
+    client->submitRing = InferenceProtocol::SharedRing(client->segment + client->layout.submitRingOffset,
+                                                       client->layout.numSlots);
+    client->completeRing = InferenceProtocol::SharedRing(client->segment + client->layout.completeRingOffset,
+                                                         client->layout.numSlots);
+    client->submitRing.Initialize();
+    client->completeRing.Initialize();
+
+    InferenceProtocol::WelcomeMessage welcome{
+        InferenceProtocol::magic, InferenceProtocol::version, _network.GetNumInputs(), _network.GetNumOutputs(),
+        client->layout.numSlots, 0, client->layout.size
+    };
+    iovec part{&welcome, sizeof(welcome)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+    msghdr message{};
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(header), &segmentFile, sizeof(int));
+
+    const bool sent = sendmsg(clientSocket, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(welcome));
+    close(segmentFile);
+
+    {
+        std::lock_guard lock(_clientsMutex);
+        _clients.push_back(std::move(client));
+    }
+    if (!sent) { DropClient(_clients.size() - 1); }
+}
+
+void InferenceServer::DropClient(const std::size_t index) {
+    std::lock_guard lock(_clientsMutex);
+    const Client& client = *_clients[index];
+    munmap(client.segment, client.layout.size);
+    close(client.socket);
+    _clients.erase(_clients.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+bool InferenceServer::Gather(std::vector<PendingRequest>& batch) {
+    const std::size_t numClients = _clients.size();
+    bool gathered{};
+
+    // one request per client per round, so a busy client can't starve the others
+    for (bool progress = true; progress && batch.size() < static_cast<std::size_t>(_maxBatchSize);) {
+        progress = false;
+        for (std::size_t i = 0; i < numClients && batch.size() < static_cast<std::size_t>(_maxBatchSize); ++i) {
+            Client* client = _clients[(_nextClient + i) % numClients].get();
+            std::uint32_t slot{};
+            if (client->submitRing.TryPop(slot) && slot < client->layout.numSlots) {
+                batch.push_back({client, slot});
+                progress = true;
+                gathered = true;
+            }
+        }
+    }
+    if (numClients > 0) { _nextClient = (_nextClient + 1) % numClients; }
+    return gathered;
+}
+
+void InferenceServer::RunBatch(const std::vector<PendingRequest>& batch) {
+    const int numInputs = _network.GetNumInputs();
+    const int numOutputs = _network.GetNumOutputs();
+    const auto batchSize = static_cast<Eigen::Index>(batch.size());
+
+    Eigen::MatrixXd inputs(numInputs, batchSize);
+    for (Eigen::Index i = 0; i < batchSize; ++i) {
+        inputs.col(i) = Eigen::Map<const Eigen::VectorXd>(batch[i].client->GetInputs(batch[i].slot), numInputs);
+    }
+    const Eigen::MatrixXd outputs = _network.FeedForwardBatch(inputs);
+
+    for (Eigen::Index i = 0; i < batchSize; ++i) {
+        Client& client = *batch[i].client;
+        Eigen::Map<Eigen::VectorXd>(client.GetInputs(batch[i].slot) + numInputs, numOutputs) = outputs.col(i);
+        client.completeRing.TryPush(batch[i].slot);
+    }
+
+    _numRequests.fetch_add(batch.size(), std::memory_order_relaxed);
+    _numBatches.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InferenceServer::Dispatch() {
+    std::vector<PendingRequest> batch{};
+    batch.reserve(_maxBatchSize);
+    unsigned idlePolls{};
+
+    while (!_stopRequested.load(std::memory_order_relaxed)) {
+        std::unique_lock lock(_clientsMutex);
+        if (!Gather(batch)) {
+            lock.unlock();
+            if (++idlePolls < idleSpins) { std::this_thread::yield(); }
+            else { std::this_thread::sleep_for(idleSleep); }
+            continue;
+        }
+        idlePolls = 0;
+
+        // give the batch until the deadline to fill up
+        const auto deadline = Clock::now() + _maxWait;
+        while (batch.size() < static_cast<std::size_t>(_maxBatchSize) && Clock::now() < deadline) {
+            if (!Gather(batch)) { std::this_thread::yield(); }
+        }
+
+        try { RunBatch(batch); }
+        catch (const std::exception& exception) {
+            std::cerr << "Batch failed: " << exception.what() << '\n';
+        }
+        batch.clear();
+    }
+}
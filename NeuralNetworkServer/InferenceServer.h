@@ -0,0 +1,133 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: InferenceServer.h
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : serves one network to local processes through shared-memory rings
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+#ifndef INFERENCESERVER_H
+#define INFERENCESERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../NeuralNetworkLib/NeuralNetworkLib/NeuralNetwork.h"
+#include "InferenceProtocol.h"
+
+/**
+ * \brief Inference daemon for local clients, see InferenceProtocol.h for the wire format.
+ *
+ * Run accepts clients on a Unix domain socket and drops them when they hang up. A dispatcher thread polls the
+ * submit rings of every client round-robin and packs the requests into one batch. The batch closes when it holds
+ * maxBatchSize requests or maxWait after its first request. It then runs one FeedForwardBatch and writes the outputs
+ * straight into the clients' slots. While idle the dispatcher yields for a while before it starts sleeping between
+ * polls, so a busy server answers quickly and an idle one does not burn a core.
+ */
+class InferenceServer {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Client {
+        int socket{-1};
+        std::byte* segment{};
+        InferenceProtocol::SegmentLayout layout{0, 0, 1};
+        InferenceProtocol::SharedRing submitRing{};
+        InferenceProtocol::SharedRing completeRing{};
+
+        double* GetInputs(const std::uint32_t slot) const {
+            return reinterpret_cast<double*>(segment + layout.slotsOffset) + slot * layout.slotStride;
+        }
+    };
+
+    struct PendingRequest {
+        Client* client;
+        std::uint32_t slot;
+    };
+
+    NeuralNetwork _network{};
+    std::string _socketPath{};
+    int _maxBatchSize{};
+    std::chrono::microseconds _maxWait{};
+    int _listenSocket{-1};
+
+    std::vector<std::unique_ptr<Client>> _clients{};
+    std::mutex _clientsMutex{}; // held by the dispatcher while it touches the segments
+    std::size_t _nextClient{}; // first client polled by the next gather, for fairness
+
+    std::atomic<bool> _stopRequested{};
+    std::atomic<std::uint64_t> _numRequests{};
+    std::atomic<std::uint64_t> _numBatches{};
+    std::thread _dispatcher{};
+
+    /**
+     * \brief accept a connection and hand the new client its segment
+     */
+    void Accept();
+
+    /**
+     * \brief unmap the segment of a client and close its socket
+     * \param index index of the client
+     */
+    void DropClient(std::size_t index);
+
+    /**
+     * \brief pop submitted requests of every client round-robin until the batch is full or the rings are empty,
+     *  the clients mutex must be held
+     * \param batch batch to append to
+     * \return true if a request was added
+     */
+    bool Gather(std::vector<PendingRequest>& batch);
+
+    /**
+     * \brief answer a batch and complete its slots, the clients mutex must be held
+     * \param batch requests of the batch
+     */
+    void RunBatch(const std::vector<PendingRequest>& batch);
+
+    /**
+     * \brief dispatcher loop forming and running the batches
+     */
+    void Dispatch();
+
+public:
+    /**
+     * \brief bind the control socket and start the dispatcher, throws std::runtime_error if the socket is unusable
+     * \param network network to serve
+     * \param socketPath path of the control socket, a stale socket file is replaced
+     * \param maxBatchSize maximum number of requests per batch
+     * \param maxWait longest time the first request of a batch waits for more
+     */
+    InferenceServer(NeuralNetwork network, std::string socketPath, int maxBatchSize,
+                    std::chrono::microseconds maxWait);
+
+    /**
+     * \brief stop the dispatcher, drop the clients and remove the socket file
+     */
+    ~InferenceServer();
+
+    InferenceServer(const InferenceServer&) = delete;
+    InferenceServer& operator=(const InferenceServer&) = delete;
+
+    /**
+     * \brief serve clients until RequestStop is called
+     */
+    void Run();
+
+    /**
+     * \brief make Run return, safe to call from a signal handler
+     */
+    void RequestStop() { _stopRequested.store(true, std::memory_order_relaxed); }
+
+    [[nodiscard]] std::uint64_t GetNumRequests() const { return _numRequests.load(); }
+    [[nodiscard]] std::uint64_t GetNumBatches() const { return _numBatches.load(); }
+};
+#endif // INFERENCESERVER_H
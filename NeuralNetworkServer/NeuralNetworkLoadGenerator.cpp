@@ -0,0 +1,134 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NeuralNetworkLoadGenerator.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : load generator reporting the throughput and latency of a NeuralNetworkServer
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+// Linux only, build from this directory with
+//   g++ -std=c++17 -O2 -pthread NeuralNetworkLoadGenerator.cpp InferenceClient.cpp -o NeuralNetworkLoadGenerator
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "InferenceClient.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    void PrintUsage() {
+        std::cerr << "Usage: NeuralNetworkLoadGenerator [--socket <path>] [--clients <n>] [--depth <n>]"
+            " [--seconds <s>]\n";
+    }
+
+    /**
+     * \brief keep up to depth requests of one client in flight until the end time
+     * \return latency of every answered request in microseconds
+     */
+    std::vector<double> GenerateLoad(const std::string& socketPath, const unsigned depth,
+                                     const Clock::time_point end) {
+        InferenceClient client(socketPath, depth);
+        std::vector<Clock::time_point> submitted(client.GetNumSlots());
+        std::vector<double> latencies{};
+        std::mt19937_64 generator{std::random_device{}()};
+        std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+        unsigned inFlight{};
+
+        for (unsigned polls = 1; Clock::now() < end || inFlight > 0; ++polls) {
+            std::uint32_t slot{};
+            while (Clock::now() < end && client.AcquireSlot(slot)) {
+                double* inputs = client.GetInputs(slot);
+                for (int i = 0; i < client.GetNumInputs(); ++i) { inputs[i] = distribution(generator); }
+                submitted[slot] = Clock::now();
+                client.Submit(slot);
+                ++inFlight;
+            }
+
+            bool completed{};
+            while (client.PollCompleted(slot)) {
+                latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - submitted[slot]).count());
+                client.ReleaseSlot(slot);
+                --inFlight;
+                completed = true;
+            }
+            if (!completed) {
+                if (polls % 4096 == 0 && !client.IsConnected()) {
+                    std::cerr << "Server hung up\n";
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+        return latencies;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = InferenceProtocol::defaultSocketPath;
+    int numClients = 4;
+    int depth = 8;
+    double seconds = 5.0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--socket" && i + 1 < argc) { socketPath = argv[++i]; }
+        else if (option == "--clients" && i + 1 < argc) { numClients = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--depth" && i + 1 < argc) { depth = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--seconds" && i + 1 < argc) { seconds = std::atof(argv[++i]); }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::vector<double> latencies{};
+    std::mutex latenciesMutex{};
+    bool failed{};
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+
+    // one client per thread, the rings have a single producer
+    std::vector<std::thread> threads{};
+    for (int c = 0; c < numClients; ++c) {
+        threads.emplace_back([&] {
+            try {
+                const std::vector<double> clientLatencies = GenerateLoad(socketPath, depth, end);
+                std::lock_guard lock(latenciesMutex);
+                latencies.insert(latencies.end(), clientLatencies.begin(), clientLatencies.end());
+            }
+            catch (const std::exception& exception) {
+                std::lock_guard lock(latenciesMutex);
+                std::cerr << exception.what() << '\n';
+                failed = true;
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (latencies.empty()) {
+        std::cerr << "No requests were answered\n";
+        return 1;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](const double p) {
+        return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+
+    std::cout << "clients: " << numClients << ", depth: " << depth << '\n'
+        << "requests: " << latencies.size() << " in " << elapsed << " s\n"
+        << "throughput: " << static_cast<double>(latencies.size()) / elapsed << " requests/s\n"
+        << "latency us: p50 " << percentile(0.5) << ", p99 " << percentile(0.99) << ", p99.9 "
+        << percentile(0.999) << ", max " << latencies.back() << '\n';
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,99 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NeuralNetworkServer.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : local inference daemon serving one model file
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+// Linux only, build from this directory with
+//   g++ -std=c++17 -O2 -pthread NeuralNetworkServer.cpp InferenceServer.cpp
+//       ../NeuralNetworkLib/NeuralNetworkLib/*.cpp -o NeuralNetworkServer
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "InferenceServer.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/Autotuner.h"
+
+namespace {
+    InferenceServer* runningServer{};
+
+    void HandleSignal(int) {
+        if (runningServer != nullptr) { runningServer->RequestStop(); }
+    }
+
+    void PrintUsage() {
+        std::cerr << "Usage: NeuralNetworkServer <model file> [--binary] [--socket <path>] [--max-batch <n>]"
+            " [--max-wait-us <n>] [--autotune <cache file>]\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        PrintUsage();
+        return 1;
+    }
+
+    const std::string modelFile = argv[1];
+    bool binary{};
+    std::string socketPath = InferenceProtocol::defaultSocketPath;
+    int maxBatchSize = 32;
+    long maxWait = 200;
+    std::string autotuneCache{};
+    for (int i = 2; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--binary") { binary = true; }
+        else if (option == "--socket" && i + 1 < argc) { socketPath = argv[++i]; }
+        else if (option == "--max-batch" && i + 1 < argc) { maxBatchSize = std::atoi(argv[++i]); }
+        else if (option == "--max-wait-us" && i + 1 < argc) { maxWait = std::atol(argv[++i]); }
+        else if (option == "--autotune" && i + 1 < argc) { autotuneCache = argv[++i]; }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    NeuralNetwork network{};
+    if (!(binary ? network.LoadFromBinaryFile(modelFile) : network.LoadFromFile(modelFile))) {
+        std::cerr << "Could not load " << modelFile << '\n';
+        return 1;
+    }
+
+    // owns the thread team of the plan, so it outlives the server
+    Autotuner autotuner(autotuneCache);
+    if (!autotuneCache.empty()) {
+        const ExecutionPlan plan = autotuner.Apply(network);
+        std::cout << SimdKernels::GetReport() << ", threads: " << plan.numThreads << ", batch blocks: "
+            << plan.maxBatchSize << '\n';
+    }
+
+    try {
+        InferenceServer server(std::move(network), socketPath, maxBatchSize, std::chrono::microseconds(maxWait));
+        runningServer = &server;
+        std::signal(SIGINT, HandleSignal);
+        std::signal(SIGTERM, HandleSignal);
+
+        std::cout << "Serving " << modelFile << " on " << socketPath << '\n';
+        server.Run();
+
+        runningServer = nullptr;
+        const auto numBatches = server.GetNumBatches();
+        std::cout << "Answered " << server.GetNumRequests() << " requests in " << numBatches << " batches";
+        if (numBatches > 0) {
+            std::cout << ", " << static_cast<double>(server.GetNumRequests()) / static_cast<double>(numBatches)
+                << " per batch";
+        }
+        std::cout << '\n';
+    }
+    catch (const std::exception& exception) {
+        std::cerr << exception.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
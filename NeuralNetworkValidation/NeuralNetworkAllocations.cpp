@@ -0,0 +1,159 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NeuralNetworkAllocations.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : checks the heap allocations of the training and inference calls against their expected counts
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+// Build from this directory with
+//   g++ -std=c++17 -O2 -pthread -DNNL_TRACK_ALLOCATIONS NeuralNetworkAllocations.cpp
+//       ../NeuralNetworkLib/NeuralNetworkLib/*.cpp -o NeuralNetworkAllocations
+//
+// For every width, depth and SIMD level the CPU supports, one warmed-up call of FeedForward, BackPropagate,
+// UpdateWeightsAndBiases and Train is counted with AllocationScope and compared with the expected counts below,
+// which only depend on the number of layers and, for Train, the number of samples. The program exits with 2 if any
+// count differs in either direction: a call that allocates less than expected is an improvement the table has to
+// record, so it can't regress later.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../NeuralNetworkLib/NeuralNetworkLib/AllocationTracker.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/NeuralNetwork.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/SimdKernels.h"
+
+namespace {
+    struct Options {
+        std::vector<int> widths{4, 64, 300};
+        std::vector<int> depths{1, 2, 4};
+        int numSamples{5}; // samples of the Train epoch
+    };
+
+    void PrintUsage() {
+        std::cerr << "Usage: NeuralNetworkAllocations [--widths <w0,w1,...>] [--depths <d0,d1,...>] [--samples <n>]\n";
+    }
+
+    std::vector<int> ParseList(const std::string& text) {
+        std::vector<int> values{};
+        std::istringstream list(text);
+        for (std::string value{}; std::getline(list, value, ',');) {
+            if (std::atoi(value.c_str()) > 0) { values.push_back(std::atoi(value.c_str())); }
+        }
+        return values;
+    }
+
+    /**
+     * \brief Expected allocations of one call, as a function of the number of layers and Train samples
+     */
+    struct Expectation {
+        std::string name{};
+        std::function<AllocationCounts(std::uint64_t numLayers, std::uint64_t numSamples)> counts{};
+    };
+
+    const std::vector<Expectation>& GetExpectations() {
+        static const std::vector<Expectation> expectations{
+            // the copy of the inputs and the output vector of every layer
+            {"FeedForward", [](const std::uint64_t l, std::uint64_t) { return AllocationCounts{l + 1, 0}; }},
+            // FeedForward, the output errors and the deltas and errors of every layer, and the std::vector
+            // holding the deltas
+            {"BackPropagate", [](const std::uint64_t l, std::uint64_t) { return AllocationCounts{3 * l + 1, 1}; }},
+            // in place on the parameter arena
+            {"UpdateWeightsAndBiases", [](std::uint64_t, std::uint64_t) { return AllocationCounts{0, 0}; }},
+            // per sample BackPropagate and the Eigen copies of the input and the target, and the three strings of
+            // the epoch report
+            {"Train", [](const std::uint64_t l, const std::uint64_t n) {
+                return AllocationCounts{n * (3 * l + 3), n + 3};
+            }},
+        };
+        return expectations;
+    }
+
+    /**
+     * \brief count the allocations of one call after a warm-up call
+     */
+    AllocationCounts Measure(const std::function<void()>& call) {
+        call();
+        const AllocationScope scope{};
+        call();
+        return scope.GetCounts();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--widths" && i + 1 < argc) { options.widths = ParseList(argv[++i]); }
+        else if (option == "--depths" && i + 1 < argc) { options.depths = ParseList(argv[++i]); }
+        else if (option == "--samples" && i + 1 < argc) { options.numSamples = std::max(1, std::atoi(argv[++i])); }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if constexpr (!AllocationTracker::isEnabled) {
+        std::cerr << "Build every file with -DNNL_TRACK_ALLOCATIONS, nothing is counted without it\n";
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(26) << "call" << std::right << std::setw(6) << "width" << std::setw(4)
+        << "dep" << std::setw(8) << "simd" << std::setw(8) << "eigen" << std::setw(10) << "expected" << std::setw(8)
+        << "new" << std::setw(10) << "expected" << '\n';
+
+    int numMismatches{};
+    const ESimdLevel bestLevel = SimdKernels::GetLevel();
+    for (const int width : options.widths) {
+        for (const int depth : options.depths) {
+            for (int level = 0; level <= static_cast<int>(SimdKernels::GetSupportedLevel()); ++level) {
+                if (!SimdKernels::SetLevel(static_cast<ESimdLevel>(level))) { continue; }
+
+                NeuralNetwork network(width, width, depth, width, 0.01);
+                network.SetHiddenActivationFunction(EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION);
+                network.SetOutputActivationFunction(EActivationFunction::SIGMOID_FUNCTION);
+                const Eigen::VectorXd inputs = Eigen::VectorXd::Constant(width, 0.1);
+                const Eigen::VectorXd targets = Eigen::VectorXd::Constant(width, 0.5);
+                const std::vector<std::vector<double>> sampleInputs(options.numSamples,
+                                                                    std::vector<double>(width, 0.1));
+                const std::vector<std::vector<double>> sampleTargets(options.numSamples,
+                                                                     std::vector<double>(width, 0.5));
+
+                const AllocationCounts measured[] = {
+                    Measure([&] { static_cast<void>(network.FeedForward(inputs)); }),
+                    Measure([&] { static_cast<void>(network.BackPropagate(inputs, targets)); }),
+                    Measure([&] { network.UpdateWeightsAndBiases(); }),
+                    Measure([&] { static_cast<void>(network.Train(sampleInputs, sampleTargets, 1)); }),
+                };
+
+                const auto numLayers = static_cast<std::uint64_t>(network.GetLayers().size());
+                for (std::size_t c = 0; c < GetExpectations().size(); ++c) {
+                    const Expectation& expectation = GetExpectations()[c];
+                    const AllocationCounts expected = expectation.counts(numLayers, options.numSamples);
+                    const bool matches = measured[c].eigenAllocations == expected.eigenAllocations &&
+                        measured[c].newAllocations == expected.newAllocations;
+                    if (!matches) { ++numMismatches; }
+                    std::cout << std::left << std::setw(26) << expectation.name << std::right << std::setw(6)
+                        << width << std::setw(4) << depth << std::setw(8)
+                        << SimdKernels::GetLevelName(static_cast<ESimdLevel>(level)) << std::setw(8)
+                        << measured[c].eigenAllocations << std::setw(10) << expected.eigenAllocations
+                        << std::setw(8) << measured[c].newAllocations << std::setw(10) << expected.newAllocations
+                        << (matches ? "" : "  mismatch") << '\n';
+                }
+            }
+        }
+    }
+    SimdKernels::SetLevel(bestLevel);
+
+    std::cout << numMismatches << " mismatches\n";
+    return numMismatches == 0 ? 0 : 2;
+}
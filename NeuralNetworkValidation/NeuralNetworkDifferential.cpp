@@ -0,0 +1,617 @@
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+// //FileName: NeuralNetworkDifferential.cpp
+// //FileType: Visual C++ Source file
+// //Author : Anders P. Åsbø
+// //Created On : 19/10/2026
+// //Last Modified On : 19/10/2026
+// //Description : differential testing of every execution engine against ReferenceNetwork
+// //////////////////////////////////////////////////////////////////////////
+// //////////////////////////////
+
+// Build from this directory with
+//   g++ -std=c++17 -O2 -pthread NeuralNetworkDifferential.cpp ../NeuralNetworkLib/NeuralNetworkLib/*.cpp
+//       ../NeuralNetworkDistributed/DataParallelTrainer.cpp ../NeuralNetworkDistributed/RingAllReduce.cpp
+//       -ldl -o NeuralNetworkDifferential
+// leaving out the NeuralNetworkDistributed files on Windows, which has no DataParallelTrainer.
+//
+// Every case draws a random topology, activation functions, parameters and a batch of inputs and targets, computes
+// the outputs, errors and gradients of every sample with ReferenceNetwork, and checks every engine against them:
+//   FeedForward, CalcGradients and BackPropagate at every SIMD level the CPU supports
+//   the const FeedForward, FeedForwardBatch whole and in blocks, and InferenceQueue
+//   FeedForward and CalcGradients on a thread team
+//   PipelineNetwork::FeedForwardBatch and the parameters after PipelineNetwork::TrainBatch
+//   the code of CodeGenerator, compiled with --compiler into a shared library (POSIX, first --codegen-cases cases)
+//   FeedForward and BackPropagate of a network loaded from a memory-mapped binary model
+//   NetworkEnsemble::FeedForward, FeedForwardBatch and BackPropagate, the network being one of its members
+//   NeuroevolutionPopulation::FeedForwardBatch of a population around the network
+//   the parameters after one DataParallelTrainer epoch over the batch on --ranks ranks in threads (POSIX)
+// A value matches when it is within the engine's number of units in the last place (ULPs) of the reference, or
+// within its absolute tolerance, which covers results near zero and the cancellation in long sums. The absolute
+// tolerance grows with the largest reference value of the compared array once that exceeds 1, since deep linear
+// and ReLU networks reach large values whose rounding errors carry over to their small neighbours. Every engine has
+// its own tolerances, set from how far its arithmetic departs from the reference, and the table at the end shows
+// the largest ULP distance and scaled error each engine reached. The program exits with 2 if any value mismatches.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../NeuralNetworkLib/NeuralNetworkLib/CodeGenerator.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/InferenceQueue.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/NetworkEnsemble.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/NeuralNetwork.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/NeuroevolutionPopulation.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/PipelineNetwork.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/ReferenceNetwork.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/SimdKernels.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/ThreadPool.h"
+#include "../NeuralNetworkLib/NeuralNetworkLib/ThreadTeam.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+
+#include "../NeuralNetworkDistributed/DataParallelTrainer.h"
+#endif
+
+namespace {
+    struct Options {
+        int numCases{200};
+        unsigned seed{1};
+        int maxWidth{24}; // inputs, outputs and neurons per hidden layer are drawn from 1 to this
+        int maxDepth{4}; // hidden layers are drawn from 1 to this
+        int batchSize{8};
+        int numThreads{2}; // members of the thread team and threads of the pool
+        int numRanks{2}; // ranks of the data-parallel trainer, 0 to skip it
+        int maxReports{10}; // mismatches printed in detail
+        int numCodeGeneratorCases{5}; // cases whose generated code is compiled, as compiling is slow
+        std::string compiler{"c++"};
+    };
+
+    void PrintUsage() {
+        std::cerr << "Usage: NeuralNetworkDifferential [--cases <n>] [--seed <n>] [--max-width <n>] [--max-depth <n>]"
+            " [--batch <n>] [--threads <n>] [--ranks <n>] [--max-reports <n>] [--codegen-cases <n>]"
+            " [--compiler <command>]\n";
+    }
+
+    /**
+     * \brief Tolerances and totals of one engine
+     */
+    struct Engine {
+        std::string name{};
+        std::uint64_t maxUlps{}; // values within this many ULPs of the reference match
+        double absoluteTolerance{}; // values closer than this to the reference match, scaled by large references
+        long numChecks{};
+        long numValues{};
+        long numMismatches{};
+        std::uint64_t worstUlps{}; // of all compared values
+        double worstError{}; // absolute error divided by the scale of the absolute tolerance
+    };
+
+    /**
+     * \brief distance of two doubles in units in the last place, counting across zero
+     */
+    std::uint64_t UlpDistance(const double a, const double b) {
+        if (std::isnan(a) || std::isnan(b)) { return std::isnan(a) && std::isnan(b) ? 0 : ~std::uint64_t{}; }
+        const auto ordered = [](const double value) {
+            std::int64_t bits{};
+            std::memcpy(&bits, &value, sizeof(bits));
+            // negative doubles count down from zero, so both signs lie on one line
+            return bits < 0 ? std::numeric_limits<std::int64_t>::min() - bits : bits;
+        };
+        const std::int64_t x = ordered(a);
+        const std::int64_t y = ordered(b);
+        return x > y ? static_cast<std::uint64_t>(x) - static_cast<std::uint64_t>(y)
+                     : static_cast<std::uint64_t>(y) - static_cast<std::uint64_t>(x);
+    }
+
+    /**
+     * \brief Tolerances of one engine
+     */
+    struct EngineTolerance {
+        const char* name;
+        std::uint64_t maxUlps;
+        double absoluteTolerance;
+    };
+
+    // Every engine's tolerances follow from how its arithmetic departs from the reference, which sums in input
+    // order and activates with the standard library, and leave about ten times the largest error seen over a few
+    // thousand cases:
+    //   generic kernels and the generated code sum in input order too, and only Eigen's blocking differs
+    //   the SIMD kernels sum four inputs at a time with fused multiply-adds and activate with the polynomial
+    //   exponential, which is a few ULPs off
+    //   batches, teams, pipelines, the queue and mapped models run the same kernels over other layouts
+    //   ensembles and populations are compared one interleaved value at a time, unscaled by their largest output
+    //   training compares parameters after one update, whose error is the learning rate times that of the gradients,
+    //   and the data-parallel trainer and the pipeline sum the gradients of the batch in another order
+    constexpr EngineTolerance engineTolerances[] = {
+        {"FeedForward generic", 16, 1e-12},
+        {"CalcGradients generic", 16, 1e-12},
+        {"BackPropagate generic", 16, 2e-13},
+        {"FeedForward sse2", 64, 1e-12},
+        {"CalcGradients sse2", 64, 1e-12},
+        {"BackPropagate sse2", 64, 5e-13},
+        {"FeedForward avx2", 64, 1e-12},
+        {"CalcGradients avx2", 64, 1e-12},
+        {"BackPropagate avx2", 64, 5e-13},
+        {"FeedForward avx512", 64, 1e-12},
+        {"CalcGradients avx512", 64, 1e-12},
+        {"BackPropagate avx512", 64, 5e-13},
+        {"FeedForward const", 64, 1e-12},
+        {"FeedForwardBatch", 64, 1e-12},
+        {"FeedForwardBatch blocks", 64, 1e-12},
+        {"InferenceQueue", 64, 1e-12},
+        {"FeedForward team", 64, 1e-12},
+        {"CalcGradients team", 64, 1e-12},
+        {"CodeGenerator", 16, 1e-13},
+        {"LoadFromBinaryFile mapped", 64, 1e-12},
+        {"NetworkEnsemble::FeedForward", 64, 1e-12},
+        {"NetworkEnsemble::FeedForwardBatch", 64, 4e-12},
+        {"NetworkEnsemble::BackPropagate", 64, 5e-13},
+        {"NeuroevolutionPopulation::FeedForwardBatch", 64, 4e-12},
+        {"PipelineNetwork::FeedForwardBatch", 64, 1e-12},
+        {"PipelineNetwork::TrainBatch", 64, 2e-13},
+        {"DataParallelTrainer", 64, 2e-13},
+    };
+
+    class Checker {
+    private:
+        const Options& _options;
+        std::deque<Engine> _engines{}; // a deque, so registering an engine keeps references to the others valid
+        std::string _case{};
+        int _numReports{};
+
+    public:
+        explicit Checker(const Options& options) : _options(options) {}
+
+        [[nodiscard]] const std::deque<Engine>& GetEngines() const { return _engines; }
+
+        /**
+         * \brief describe the current case in mismatch reports
+         */
+        void SetCase(std::string description) { _case = std::move(description); }
+
+        /**
+         * \brief get an engine, registering it with its tolerances from engineTolerances the first time
+         */
+        Engine& GetEngine(const std::string& name) {
+            for (Engine& engine : _engines) {
+                if (engine.name == name) { return engine; }
+            }
+            const auto tolerance = std::find_if(std::begin(engineTolerances), std::end(engineTolerances),
+                                                [&name](const EngineTolerance& t) { return name == t.name; });
+            if (tolerance == std::end(engineTolerances)) { throw std::logic_error("No tolerances for " + name); }
+            _engines.push_back({name, tolerance->maxUlps, tolerance->absoluteTolerance});
+            return _engines.back();
+        }
+
+        /**
+         * \brief compare values of an engine with the reference
+         * \param engine engine that computed the values
+         * \param what name of the values in reports
+         * \param actual values of the engine
+         * \param expected values of the reference
+         * \param count number of values
+         */
+        void Compare(Engine& engine, const std::string& what, const double* actual, const double* expected,
+                     const std::size_t count) {
+            ++engine.numChecks;
+            double scale = 1.0;
+            for (std::size_t i = 0; i < count; ++i) { scale = std::max(scale, std::abs(expected[i])); }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::uint64_t ulps = UlpDistance(actual[i], expected[i]);
+                const double error = std::abs(actual[i] - expected[i]) / scale;
+                ++engine.numValues;
+                if (!(error <= engine.worstError)) { engine.worstError = error; }
+                engine.worstUlps = std::max(engine.worstUlps, ulps);
+                if (error <= engine.absoluteTolerance || ulps <= engine.maxUlps) { continue; }
+
+                ++engine.numMismatches;
+                if (_numReports++ < _options.maxReports) {
+                    std::cout << std::setprecision(17) << "mismatch in " << _case << ": " << engine.name << ' '
+                        << what << '[' << i << "] = " << actual[i] << ", reference " << expected[i] << " ("
+                        << ulps << " ULPs)\n";
+                }
+            }
+        }
+
+        void Compare(Engine& engine, const std::string& what, const double actual, const double expected) {
+            Compare(engine, what, &actual, &expected, 1);
+        }
+    };
+
+    const char* GetActivationName(const EActivationFunction activationFunction) {
+        switch (activationFunction) {
+        case EActivationFunction::HEAVISIDE_STEP_FUNCTION: return "step";
+        case EActivationFunction::SIGMOID_FUNCTION: return "sigmoid";
+        case EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION: return "tanh";
+        case EActivationFunction::RELU_FUNCTION: return "relu";
+        default: return "none";
+        }
+    }
+
+    std::vector<double> ToVector(const Eigen::MatrixXd& matrix, const Eigen::Index column) {
+        return {matrix.col(column).data(), matrix.col(column).data() + matrix.rows()};
+    }
+
+    /**
+     * \brief Threads and connections shared by every case
+     */
+    struct Resources {
+        ThreadTeam& team;
+        ThreadPool& pool;
+#ifndef _WIN32
+        std::vector<std::unique_ptr<RingAllReduce>> rings{}; // one per rank of the data-parallel trainer
+#endif
+    };
+
+    void RunCase(Checker& checker, const Options& options, Resources& resources, std::mt19937& generator,
+                 const int caseIndex) {
+        const auto draw = [&generator](const int low, const int high) {
+            return std::uniform_int_distribution<int>(low, high)(generator);
+        };
+        std::uniform_real_distribution<double> uniform{-1.0, 1.0};
+        constexpr EActivationFunction activationFunctions[] = {
+            EActivationFunction::HEAVISIDE_STEP_FUNCTION, EActivationFunction::SIGMOID_FUNCTION,
+            EActivationFunction::HYPERBOLIC_TANGENT_FUNCTION, EActivationFunction::RELU_FUNCTION,
+            EActivationFunction::NONE
+        };
+
+        const int numInputs = draw(1, options.maxWidth);
+        const int numOutputs = draw(1, options.maxWidth);
+        const int depth = draw(1, options.maxDepth);
+        const int width = draw(1, options.maxWidth);
+        const int batchSize = options.batchSize;
+        NeuralNetwork network(numInputs, numOutputs, depth, width, 0.001 + 0.1 * std::abs(uniform(generator)));
+        network.SetHiddenActivationFunction(activationFunctions[draw(0, 4)]);
+        network.SetOutputActivationFunction(activationFunctions[draw(0, 4)]);
+        for (double& parameter : network.GetParameters()) { parameter = uniform(generator); }
+
+        const Eigen::MatrixXd inputs = Eigen::MatrixXd::NullaryExpr(numInputs, batchSize, [&] {
+            return 2.0 * uniform(generator);
+        });
+        const Eigen::MatrixXd targets = Eigen::MatrixXd::NullaryExpr(numOutputs, batchSize, [&] {
+            return uniform(generator);
+        });
+
+        std::ostringstream description{};
+        description << "case " << caseIndex << " (" << numInputs << '-' << width << 'x' << depth << '-' << numOutputs
+            << ", " << GetActivationName(network.GetHiddenActivationFunction()) << '/'
+            << GetActivationName(network.GetOutputActivationFunction()) << ')';
+        checker.SetCase(description.str());
+
+        std::vector<ReferencePass> expected{};
+        std::vector<double> expectedOutputs{}; // every sample, column-major like a batch
+        Eigen::VectorXd meanGradients = Eigen::VectorXd::Zero(network.GetNumParameters());
+        double expectedError{};
+        for (int s = 0; s < batchSize; ++s) {
+            expected.push_back(ReferenceNetwork::CalcGradients(network, ToVector(inputs, s), ToVector(targets, s)));
+            expectedOutputs.insert(expectedOutputs.end(), expected[s].outputs.begin(), expected[s].outputs.end());
+            meanGradients += Eigen::Map<const Eigen::VectorXd>(expected[s].gradients.data(),
+                                                               network.GetNumParameters()) / batchSize;
+            expectedError += expected[s].meanSquareError;
+        }
+        const Eigen::VectorXd parameters = network.GetParameters();
+        const Eigen::VectorXd expectedParameters =
+            parameters + network.GetLearningRate() * Eigen::Map<const Eigen::VectorXd>(
+                expected[0].gradients.data(), network.GetNumParameters());
+        const Eigen::VectorXd expectedBatchParameters = parameters + network.GetLearningRate() * meanGradients;
+
+        // single-sample engines at every SIMD level
+        const ESimdLevel bestLevel = SimdKernels::GetLevel();
+        for (int level = 0; level <= static_cast<int>(SimdKernels::GetSupportedLevel()); ++level) {
+            if (!SimdKernels::SetLevel(static_cast<ESimdLevel>(level))) { continue; }
+            const std::string levelName = SimdKernels::GetLevelName(static_cast<ESimdLevel>(level));
+
+            Engine& forward = checker.GetEngine("FeedForward " + levelName);
+            Engine& gradients = checker.GetEngine("CalcGradients " + levelName);
+            for (int s = 0; s < batchSize; ++s) {
+                const Eigen::VectorXd outputs = network.FeedForward(inputs.col(s));
+                checker.Compare(forward, "outputs", outputs.data(), expected[s].outputs.data(), outputs.size());
+
+                const double error = network.CalcGradients(inputs.col(s), targets.col(s));
+                checker.Compare(gradients, "error", error, expected[s].meanSquareError);
+                checker.Compare(gradients, "gradients", network.GetGradients().data(),
+                                expected[s].gradients.data(), expected[s].gradients.size());
+            }
+
+            NeuralNetwork trained(network);
+            trained.BackPropagate(inputs.col(0), targets.col(0));
+            checker.Compare(checker.GetEngine("BackPropagate " + levelName),
+                            "parameters", trained.GetParameters().data(), expectedParameters.data(),
+                            expectedParameters.size());
+        }
+        SimdKernels::SetLevel(bestLevel);
+
+        const NeuralNetwork& constNetwork = network;
+        Engine& constForward = checker.GetEngine("FeedForward const");
+        for (int s = 0; s < batchSize; ++s) {
+            const Eigen::VectorXd outputs = constNetwork.FeedForward(inputs.col(s));
+            checker.Compare(constForward, "outputs", outputs.data(), expected[s].outputs.data(), outputs.size());
+        }
+
+        const Eigen::MatrixXd batchOutputs = network.FeedForwardBatch(inputs);
+        checker.Compare(checker.GetEngine("FeedForwardBatch"), "outputs",
+                        batchOutputs.data(), expectedOutputs.data(), expectedOutputs.size());
+        network.SetMaxBatchSize(draw(1, batchSize));
+        const Eigen::MatrixXd blockOutputs = network.FeedForwardBatch(inputs);
+        network.SetMaxBatchSize(0);
+        checker.Compare(checker.GetEngine("FeedForwardBatch blocks"), "outputs",
+                        blockOutputs.data(), expectedOutputs.data(), expectedOutputs.size());
+
+        {
+            InferenceQueue queue(network, draw(1, batchSize), std::chrono::microseconds(50));
+            std::vector<std::future<Eigen::VectorXd>> results{};
+            for (int s = 0; s < batchSize; ++s) { results.push_back(queue.Submit(inputs.col(s))); }
+            Engine& queued = checker.GetEngine("InferenceQueue");
+            for (int s = 0; s < batchSize; ++s) {
+                const Eigen::VectorXd outputs = results[s].get();
+                checker.Compare(queued, "outputs", outputs.data(), expected[s].outputs.data(), outputs.size());
+            }
+        }
+
+        // every layer is split over the team, however narrow
+        network.SetThreadTeam(&resources.team, 1);
+        Engine& teamForward = checker.GetEngine("FeedForward team");
+        Engine& teamGradients = checker.GetEngine("CalcGradients team");
+        for (int s = 0; s < batchSize; ++s) {
+            const Eigen::VectorXd outputs = network.FeedForward(inputs.col(s));
+            checker.Compare(teamForward, "outputs", outputs.data(), expected[s].outputs.data(), outputs.size());
+            network.CalcGradients(inputs.col(s), targets.col(s));
+            checker.Compare(teamGradients, "gradients", network.GetGradients().data(), expected[s].gradients.data(),
+                            expected[s].gradients.size());
+        }
+        network.SetThreadTeam(nullptr);
+
+        if (caseIndex < options.numCodeGeneratorCases) {
+            CompiledNetwork compiled{};
+            if (compiled.Compile(network, options.compiler)) {
+                Engine& generated = checker.GetEngine("CodeGenerator");
+                std::vector<double> outputs(numOutputs);
+                for (int s = 0; s < batchSize; ++s) {
+                    compiled.Infer(inputs.col(s).data(), outputs.data());
+                    checker.Compare(generated, "outputs", outputs.data(), expected[s].outputs.data(), outputs.size());
+                }
+            }
+            else {
+                // counted as a mismatch, so a generator that emits invalid code fails the run
+                ++checker.GetEngine("CodeGenerator").numMismatches;
+            }
+        }
+
+        {
+            NeuralNetwork pipelined(network);
+            PipelineNetwork pipeline(pipelined, std::min(2, depth + 1), draw(1, batchSize));
+            const Eigen::MatrixXd outputs = pipeline.FeedForwardBatch(inputs);
+            checker.Compare(checker.GetEngine("PipelineNetwork::FeedForwardBatch"),
+                            "outputs", outputs.data(), expectedOutputs.data(), expectedOutputs.size());
+
+            Engine& pipelineTraining = checker.GetEngine("PipelineNetwork::TrainBatch");
+            const double error = pipeline.TrainBatch(inputs, targets);
+            checker.Compare(pipelineTraining, "error", error, expectedError);
+            checker.Compare(pipelineTraining, "parameters", pipelined.GetParameters().data(),
+                            expectedBatchParameters.data(), expectedBatchParameters.size());
+        }
+
+        {
+            const std::string modelFile = (std::filesystem::temp_directory_path() / (
+                "NeuralNetworkDifferential" + std::to_string(caseIndex) + ".bin")).string();
+            NeuralNetwork mapped{};
+            const bool loaded = network.SaveToBinaryFile(modelFile) && mapped.LoadFromBinaryFile(modelFile, true);
+            std::remove(modelFile.c_str());
+            Engine& mappedEngine = checker.GetEngine("LoadFromBinaryFile mapped");
+            if (loaded) {
+                for (int s = 0; s < batchSize; ++s) {
+                    const Eigen::VectorXd outputs = mapped.FeedForward(inputs.col(s));
+                    checker.Compare(mappedEngine, "outputs", outputs.data(), expected[s].outputs.data(),
+                                    outputs.size());
+                }
+                mapped.BackPropagate(inputs.col(0), targets.col(0));
+                checker.Compare(mappedEngine, "parameters", mapped.GetParameters().data(), expectedParameters.data(),
+                                expectedParameters.size());
+            }
+            else { ++mappedEngine.numMismatches; }
+        }
+
+        // the network is the first member, the others get their own parameters and references
+        {
+            std::vector<NeuralNetwork> members(3, network);
+            for (std::size_t m = 1; m < members.size(); ++m) {
+                for (double& parameter : members[m].GetParameters()) { parameter = uniform(generator); }
+            }
+            std::vector<std::vector<ReferencePass>> memberExpected(members.size());
+            for (std::size_t m = 0; m < members.size(); ++m) {
+                for (int s = 0; s < batchSize; ++s) {
+                    memberExpected[m].push_back(m == 0 ? expected[s] : ReferenceNetwork::CalcGradients(
+                        members[m], ToVector(inputs, s), ToVector(targets, s)));
+                }
+            }
+            const auto numMembers = static_cast<int>(members.size());
+
+            NetworkEnsemble ensemble(members);
+            Engine& ensembleForward = checker.GetEngine("NetworkEnsemble::FeedForward");
+            for (int s = 0; s < batchSize; ++s) {
+                const Eigen::MatrixXd outputs = ensemble.FeedForward(inputs.col(s));
+                for (int m = 0; m < numMembers; ++m) {
+                    checker.Compare(ensembleForward, "outputs", outputs.col(m).data(),
+                                    memberExpected[m][s].outputs.data(), numOutputs);
+                }
+            }
+            const Eigen::MatrixXd interleaved = ensemble.FeedForwardBatch(inputs);
+            Engine& ensembleBatch = checker.GetEngine("NetworkEnsemble::FeedForwardBatch");
+            for (int s = 0; s < batchSize; ++s) {
+                for (int m = 0; m < numMembers; ++m) {
+                    for (int j = 0; j < numOutputs; ++j) {
+                        checker.Compare(ensembleBatch, "outputs", interleaved(j * numMembers + m, s),
+                                        memberExpected[m][s].outputs[j]);
+                    }
+                }
+            }
+            const Eigen::VectorXd errors = ensemble.BackPropagate(inputs.col(0), targets.col(0));
+            Engine& ensembleTraining = checker.GetEngine("NetworkEnsemble::BackPropagate");
+            for (int m = 0; m < numMembers; ++m) {
+                checker.Compare(ensembleTraining, "error", errors[m], memberExpected[m][0].meanSquareError);
+                const Eigen::VectorXd memberParameters = members[m].GetParameters() + network.GetLearningRate() *
+                    Eigen::Map<const Eigen::VectorXd>(memberExpected[m][0].gradients.data(),
+                                                      network.GetNumParameters());
+                checker.Compare(ensembleTraining, "parameters", ensemble.GetMember(m).GetParameters().data(),
+                                memberParameters.data(), memberParameters.size());
+            }
+        }
+
+        {
+            const NeuroevolutionPopulation population(network, 3, 0.5, generator());
+            const Eigen::MatrixXd interleaved = population.FeedForwardBatch(inputs, resources.pool);
+            Engine& populationForward = checker.GetEngine("NeuroevolutionPopulation::FeedForwardBatch");
+            const int populationSize = population.GetPopulationSize();
+            NeuralNetwork individual(network);
+            for (int p = 0; p < populationSize; ++p) {
+                population.CopyToNetwork(p, individual);
+                for (int s = 0; s < batchSize; ++s) {
+                    const std::vector<double> outputs = ReferenceNetwork::FeedForward(individual, ToVector(inputs, s));
+                    for (int j = 0; j < numOutputs; ++j) {
+                        checker.Compare(populationForward, "outputs", interleaved(j * populationSize + p, s),
+                                        outputs[j]);
+                    }
+                }
+            }
+        }
+
+#ifndef _WIN32
+        // every rank trains its replica on its share of the batch, and all replicas end with the batch update
+        if (!resources.rings.empty()) {
+            const std::size_t numRanks = resources.rings.size();
+            std::vector<NeuralNetwork> replicas(numRanks, network);
+            std::vector<double> errors(numRanks);
+            std::vector<std::exception_ptr> failures(numRanks);
+            std::vector<std::thread> ranks{};
+            for (std::size_t rank = 0; rank < numRanks; ++rank) {
+                ranks.emplace_back([&, rank] {
+                    try {
+                        DataParallelTrainer trainer(replicas[rank], *resources.rings[rank]);
+                        errors[rank] = trainer.TrainEpoch(inputs, targets, batchSize);
+                    }
+                    catch (...) { failures[rank] = std::current_exception(); }
+                });
+            }
+            for (std::thread& rank : ranks) { rank.join(); }
+            for (const std::exception_ptr& failure : failures) {
+                if (failure) { std::rethrow_exception(failure); }
+            }
+
+            Engine& dataParallel = checker.GetEngine("DataParallelTrainer");
+            for (std::size_t rank = 0; rank < numRanks; ++rank) {
+                checker.Compare(dataParallel, "error", errors[rank], expectedError);
+                checker.Compare(dataParallel, "parameters", replicas[rank].GetParameters().data(),
+                                expectedBatchParameters.data(), expectedBatchParameters.size());
+            }
+        }
+#endif
+    }
+
+#ifndef _WIN32
+    /**
+     * \brief connect the ranks of the data-parallel trainer over Unix domain sockets, all in this process
+     */
+    std::vector<std::unique_ptr<RingAllReduce>> ConnectRings(const int numRanks) {
+        std::vector<std::string> endpoints{};
+        for (int rank = 0; rank < numRanks; ++rank) {
+            endpoints.push_back("unix:" + (std::filesystem::temp_directory_path() / (
+                "NeuralNetworkDifferential." + std::to_string(getpid()) + '.' + std::to_string(rank) +
+                ".sock")).string());
+        }
+
+        // every rank waits for its neighbours while connecting, so they connect at the same time
+        std::vector<std::unique_ptr<RingAllReduce>> rings(numRanks);
+        std::vector<std::exception_ptr> failures(numRanks);
+        std::vector<std::thread> ranks{};
+        for (int rank = 0; rank < numRanks; ++rank) {
+            ranks.emplace_back([&, rank] {
+                try { rings[rank] = std::make_unique<RingAllReduce>(rank, endpoints); }
+                catch (...) { failures[rank] = std::current_exception(); }
+            });
+        }
+        for (std::thread& rank : ranks) { rank.join(); }
+        for (const std::exception_ptr& failure : failures) {
+            if (failure) { std::rethrow_exception(failure); }
+        }
+        return rings;
+    }
+#endif
+}
+
+int main(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--cases" && i + 1 < argc) { options.numCases = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--seed" && i + 1 < argc) {
+            options.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (option == "--max-width" && i + 1 < argc) { options.maxWidth = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--max-depth" && i + 1 < argc) { options.maxDepth = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--batch" && i + 1 < argc) { options.batchSize = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--threads" && i + 1 < argc) { options.numThreads = std::max(1, std::atoi(argv[++i])); }
+        else if (option == "--ranks" && i + 1 < argc) { options.numRanks = std::max(0, std::atoi(argv[++i])); }
+        else if (option == "--max-reports" && i + 1 < argc) {
+            options.maxReports = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (option == "--codegen-cases" && i + 1 < argc) {
+            options.numCodeGeneratorCases = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (option == "--compiler" && i + 1 < argc) { options.compiler = argv[++i]; }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::cout << SimdKernels::GetReport() << ", " << options.numCases << " cases, seed " << options.seed << '\n';
+    Checker checker(options);
+    ThreadTeam team(options.numThreads);
+    ThreadPool pool(options.numThreads);
+    Resources resources{team, pool};
+    try {
+#ifndef _WIN32
+        if (options.numRanks > 0) { resources.rings = ConnectRings(options.numRanks); }
+#endif
+        std::mt19937 generator{options.seed};
+        for (int c = 0; c < options.numCases; ++c) { RunCase(checker, options, resources, generator, c); }
+    }
+    catch (const std::exception& exception) {
+        std::cerr << exception.what() << '\n';
+        return 1;
+    }
+
+    long numMismatches{};
+    std::cout << std::left << std::setw(44) << "engine" << std::right << std::setw(10) << "checks" << std::setw(12)
+        << "values" << std::setw(22) << "worst ULPs" << std::setw(14) << "worst error" << std::setw(12)
+        << "mismatches" << '\n';
+    for (const Engine& engine : checker.GetEngines()) {
+        std::cout << std::left << std::setw(44) << engine.name << std::right << std::setw(10) << engine.numChecks
+            << std::setw(12) << engine.numValues << std::setw(22) << engine.worstUlps << std::setw(14)
+            << std::scientific << std::setprecision(2) << engine.worstError << std::defaultfloat << std::setw(12)
+            << engine.numMismatches << '\n';
+        numMismatches += engine.numMismatches;
+    }
+    std::cout << numMismatches << " mismatches\n";
+    return numMismatches == 0 ? 0 : 2;
+}